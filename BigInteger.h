@@ -8,20 +8,79 @@
 #pragma once
 
 #include <vector>
+#include <deque>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <string>
 #include <iostream>
 #include <ostream>
 #include <utility>
 #include <limits>
+#include <stdexcept>
+#include <cstring>
+#include <cmath>
+#include <cctype>
+#include <istream>
+#include <system_error>
+#include "BigIntegerInstrumentation.h"
+#include "FixedBigInteger.h"
 #include "HelperFunctions.h"
+#include "LimbArithmetic.h"
+#include "LimbMultiplication.h"
+#include "NumberTheoreticTransform.h"
+#include "LimbDivision.h"
+#include "LimbStorage.h"
+#include "ThreadPool.h"
 
 
 
 namespace Utilities
 {
 
-template<typename BaseType = unsigned char>
+template <typename BaseType>
+class ModularContext;
+
+template <typename BaseType>
+class BigIntegerGcd;
+
+template <typename BaseType>
+class BigIntegerRoots;
+
+template <typename BaseType>
+class BigIntegerCombinatorics;
+
+template <typename BaseType>
+class BigIntegerPrimes;
+
+/// order of the words for importLimbs and exportLimbs
+enum class WordOrder
+{
+	LeastSignificantFirst, MostSignificantFirst
+};
+
+/// order of the bytes within one word for importLimbs and exportLimbs
+enum class ByteOrder
+{
+	Native, Little, Big
+};
+
+/// result of BigIntegerBase::toChars like std::to_chars_result
+struct ToCharsResult
+{
+	char* ptr;
+	std::errc ec;
+};
+
+/// result of BigIntegerBase::fromChars like std::from_chars_result
+struct FromCharsResult
+{
+	const char* ptr;
+	std::errc ec;
+};
+
+template<typename BaseType = std::uint64_t>
 class BigIntegerBase
 {
 	static_assert(!std::numeric_limits<BaseType>::is_signed, "BigIntegerBase needs an unsigned BaseType");
@@ -29,18 +88,22 @@ class BigIntegerBase
 public:
 	BigIntegerBase ()
 	{
+		UTILITIES_INSTRUMENT_NUMBER ();
 		_bigNumber.push_back (0);
 	}
 	BigIntegerBase (long number)
 	{
+		UTILITIES_INSTRUMENT_NUMBER ();
 		setFromNumber (number);
 	}
 	BigIntegerBase (const std::string& number)
 	{
+		UTILITIES_INSTRUMENT_NUMBER ();
 		setFromString (number);
 	}
 	BigIntegerBase (const BigIntegerBase<BaseType>& copy)
 	{
+		UTILITIES_INSTRUMENT_NUMBER ();
 		copyFrom (copy);
 	}
 	BigIntegerBase (BigIntegerBase<BaseType>&& source) : BigIntegerBase<BaseType>{}
@@ -76,20 +139,133 @@ public:
   BigIntegerBase& operator-= (const BigIntegerBase& rhs);
   BigIntegerBase operator- (const BigIntegerBase& rhs) const;
 
+  BigIntegerBase operator- () const
+  {
+  	BigIntegerBase result (*this);
+  	result._isPositive = !_isPositive || (getRealSize () == 0);
+  	return result;
+  }
+
   BigIntegerBase& operator*= (const BigIntegerBase& rhs);
   BigIntegerBase operator* (const BigIntegerBase& rhs) const;
 
+  /**
+   * same as (*this) * (*this), but uses the faster squaring algorithms
+   */
+  BigIntegerBase square () const
+  {
+  	return (*this) * (*this);
+  }
+
+  /**
+   * this^exponent by binary exponentiation, one square per bit of the exponent and one product per set bit.
+   * The trailing zero bits of the base become a shift of the result, 0^0 == 1.
+   */
+  BigIntegerBase pow (unsigned int exponent) const;
+
   BigIntegerBase& operator/= (const BigIntegerBase& rhs);
   BigIntegerBase operator/ (const BigIntegerBase& rhs) const;
 
+  BigIntegerBase& operator%= (const BigIntegerBase& rhs);
+  BigIntegerBase operator% (const BigIntegerBase& rhs) const;
+
+  /**
+   * quotient and remainder in one go. Like for the built in types the quotient is rounded towards zero
+   * and the remainder has the sign of this. Throws std::domain_error if divisor is zero.
+   */
+  std::pair<BigIntegerBase, BigIntegerBase> divmod (const BigIntegerBase& divisor) const;
+
   virtual void insertIntoStream (std::ostream& os) const;
 
-  std::string asString () const;
+  /// the number in the given base from 2 to 36, throws std::invalid_argument for other bases
+  std::string asString (int base = 10) const;
+
+  /**
+   * writes the number in the given base from 2 to 36 to [first, last) like std::to_chars, letters are lower
+   * case. Returns the end of the characters, last and std::errc::value_too_large if they do not fit or
+   * first and std::errc::invalid_argument for other bases. Nothing is allocated for bases which are powers
+   * of two, those take the digits directly from the bits, and for numbers below
+   * BigIntegerTuning::decimalConversionThreshold limbs.
+   */
+  ToCharsResult toChars (char* first, char* last, int base = 10) const;
+
+  /**
+   * reads an optional '-' and the longest run of digits in the given base from 2 to 36 from [first, last)
+   * like std::from_chars, letters in both cases. Returns the end of the digits, or first and
+   * std::errc::invalid_argument if there are none or the base is invalid, the number is unchanged then.
+   */
+  FromCharsResult fromChars (const char* first, const char* last, int base = 10);
+
+  /**
+   * sets the magnitude from wordCount words of wordSize bytes, the words and their bytes can come in any
+   * order. The number is negative if isNegative is set and it is not zero.
+   */
+  void importLimbs (const void* data, size_t wordCount, size_t wordSize, WordOrder wordOrder = WordOrder::LeastSignificantFirst,
+  		ByteOrder byteOrder = ByteOrder::Native, bool isNegative = false);
+
+  /// number of words of wordSize bytes exportLimbs writes, 0 for zero
+  size_t exportWordCount (size_t wordSize) const
+  {
+  	return (bitLength () + 8 * wordSize - 1) / (8 * wordSize);
+  }
+
+  /**
+   * writes the magnitude as exportWordCount (wordSize) words in the given order and returns their number,
+   * the sign is not written
+   */
+  size_t exportLimbs (void* data, size_t wordSize, WordOrder wordOrder = WordOrder::LeastSignificantFirst,
+  		ByteOrder byteOrder = ByteOrder::Native) const;
 
   void shiftLeft (unsigned int howMuch);
 
   void shiftRight (unsigned int howMuch);
 
+  /// same as shiftLeft, a multiplication with 2^howMuch for both signs
+  BigIntegerBase& operator<<= (unsigned int howMuch)
+  {
+  	shiftLeft (howMuch);
+  	return *this;
+  }
+  BigIntegerBase operator<< (unsigned int howMuch) const;
+
+  /**
+   * arithmetic shift like for two's complement numbers, negative numbers are rounded towards minus infinity,
+   * e.g. -5 >> 1 == -3. shiftRight rounds towards zero instead.
+   */
+  BigIntegerBase& operator>>= (unsigned int howMuch);
+  BigIntegerBase operator>> (unsigned int howMuch) const;
+
+  /**
+   * the bitwise operators work on the two's complement of the numbers, where negative numbers have
+   * infinitely many leading ones, e.g. -6 & 7 == 2 and -6 | 1 == -5
+   */
+  BigIntegerBase& operator&= (const BigIntegerBase& rhs);
+  BigIntegerBase operator& (const BigIntegerBase& rhs) const;
+
+  BigIntegerBase& operator|= (const BigIntegerBase& rhs);
+  BigIntegerBase operator| (const BigIntegerBase& rhs) const;
+
+  BigIntegerBase& operator^= (const BigIntegerBase& rhs);
+  BigIntegerBase operator^ (const BigIntegerBase& rhs) const;
+
+  /// -this - 1, the bitwise complement of the two's complement
+  BigIntegerBase operator~ () const;
+
+  /// number of set bits of the magnitude
+  unsigned int popCount () const
+  {
+  	return (unsigned int) Limbs::popCountN (_bigNumber.data (), _bigNumber.size ());
+  }
+
+  /**
+   * number of zero bits below the lowest set bit, the same for the magnitude and the two's complement.
+   * Throws std::domain_error for 0.
+   */
+  unsigned int countTrailingZeros () const;
+
+  /// the bits [start, start + count) of the two's complement as a non negative number
+  BigIntegerBase extractBits (unsigned int start, unsigned int count) const;
+
   bool operator<= (const BigIntegerBase& rhs) const
 	{
   	return (this->compare (rhs) <= 0);
@@ -129,11 +305,24 @@ public:
   	return _isPositive;
   }
 
+  /**
+   * number of significant bits of the magnitude, 0 for 0
+   */
+  unsigned int bitLength () const
+  {
+  	unsigned int realSize = getRealSize ();
+  	if (realSize == 0)
+  	{
+  		return 0;
+  	}
+  	return realSize * _baseTypeSize - Limbs::leadingZeros (_bigNumber[realSize - 1]);
+  }
+
   void printInternal () const
   {
   	for (int i = _bigNumber.size() - 1; i >= 0 ; --i)
   	{
-  		std::cout << std::hex << (int) _bigNumber[i] << " ";
+  		std::cout << std::hex << (unsigned long long) _bigNumber[i] << " ";
   	}
   	std::cout << std::dec << std::endl;
   }
@@ -144,85 +333,434 @@ public:
   	std::swap(a._isPositive, b._isPositive);
   }
 
+  template <typename T>
+  friend void add (BigIntegerBase<T>& result, const BigIntegerBase<T>& a, const BigIntegerBase<T>& b);
+  template <typename T>
+  friend void sub (BigIntegerBase<T>& result, const BigIntegerBase<T>& a, const BigIntegerBase<T>& b);
+  template <typename T>
+  friend void mul (BigIntegerBase<T>& result, const BigIntegerBase<T>& a, const BigIntegerBase<T>& b);
+  template <typename T>
+  friend void addmul (BigIntegerBase<T>& result, const BigIntegerBase<T>& a, const BigIntegerBase<T>& b);
+  template <typename T>
+  friend void submul (BigIntegerBase<T>& result, const BigIntegerBase<T>& a, const BigIntegerBase<T>& b);
+
+  friend class ModularContext<BaseType>;
+  friend class BigIntegerGcd<BaseType>;
+  friend class BigIntegerRoots<BaseType>;
+  friend class BigIntegerCombinatorics<BaseType>;
+  friend class BigIntegerPrimes<BaseType>;
+
 private:
-	std::vector<BaseType> _bigNumber;
+	typedef LimbArithmetic<BaseType> Limbs;
+
+	LimbStorage<BaseType> _bigNumber;
 	bool _isPositive = true;
 
 	static const unsigned int _baseTypeSize = sizeof(BaseType) << 3;
-	static const unsigned int _baseTypeHalfSize = sizeof(BaseType) << 2;
-	static const BaseType _lowMask = ((BaseType) 1 << (sizeof(BaseType) << 2)) - 1;
-	static const BaseType _highMask = (((BaseType) 1 << (sizeof(BaseType) << 2)) - 1) << (sizeof(BaseType) << 2);
 
 	void copyFrom (const BigIntegerBase<BaseType>& rhs)
 	{
 		_isPositive = rhs._isPositive;
 		_bigNumber = rhs._bigNumber;
 	}
-	
-	void setMasks ();
 
-	void addEntry (std::vector<BaseType>* victim, BaseType entry, unsigned int index) const;
+	/**
+	 * result = a + b for the magnitudes with the given signs, returns the sign of the sum. result may be
+	 * the storage of a or b, their limbs are only accessed after result got its size.
+	 */
+	static bool addSigned (LimbStorage<BaseType>& result, const LimbStorage<BaseType>& a, size_t aSize, bool aIsPositive,
+			const LimbStorage<BaseType>& b, size_t bSize, bool bIsPositive);
+
+	/**
+	 * this = a + b with b taken with the given sign, so addition and subtraction share one implementation.
+	 * this may be a or b.
+	 */
+	void assignSum (const BigIntegerBase& a, const BigIntegerBase& b, bool bIsPositive);
 
-	void multiplyAddEntry (std::vector<BaseType>* victim, BaseType entry1, BaseType entry2, unsigned int index) const;
+	/// this = a * b, this may be a or b
+	void assignProduct (const BigIntegerBase& a, const BigIntegerBase& b);
 
-	void subtractEntry (std::vector<BaseType>* victim, BaseType entry, unsigned int index) const;
+	/// this += a * b or this -= a * b, without a temporary BigIntegerBase for the product
+	void addProduct (const BigIntegerBase& a, const BigIntegerBase& b, bool subtract);
 
 	int compare (const BigIntegerBase& rhs) const;
 
+	static BigIntegerBase fromLimbs (const BaseType* limbs, size_t size)
+	{
+		BigIntegerBase<BaseType> result;
+		result._bigNumber.assign (limbs, limbs + size);
+		result.cleanLeadingZeroes ();
+		return result;
+	}
+
+	/**
+	 * divides the magnitude by divisor and returns the remainder of the magnitude
+	 */
+	BaseType divideByLimb (BaseType divisor);
+
+	/**
+	 * result = a * b for non empty limb arrays without leading zeroes. Picks schoolbook, Karatsuba,
+	 * Toom-3 or the NTT by the size of the smaller operand. If a and b are the same array, it is squared.
+	 */
+	static void multiplyMagnitudes (LimbStorage<BaseType>& result, const BaseType* a, size_t aSize, const BaseType* b, size_t bSize);
+
+	/**
+	 * Toom-3 with the evaluation points 0, 1, -1, -2 and infinity, the interpolation follows Bodrato.
+	 * b has to be longer than two thirds of a.
+	 */
+	static void toomCook3Multiply (LimbStorage<BaseType>& result, const BaseType* a, size_t aSize, const BaseType* b, size_t bSize);
+
+	/**
+	 * the thread pool for a product whose smaller operand has size limbs, nullptr if it runs serially
+	 */
+	static ThreadPool* poolFor (size_t size);
+
+	/// runs the tasks on the pool, or one after the other without pool
+	static void runTasks (ThreadPool* pool, std::vector<std::function<void ()> >& tasks);
+
+	/**
+	 * multiplication by number theoretic transforms on the limbs packed into 64 bit words
+	 */
+	static void nttMultiply (LimbStorage<BaseType>& result, const BaseType* a, size_t aSize, const BaseType* b, size_t bSize);
+
+	/**
+	 * quotient = a / b and remainder = a % b for limb arrays without leading zeroes, b is not empty.
+	 * Uses the single limb division, Knuth's algorithm D or the Newton reciprocal.
+	 */
+	static void divideMagnitudes (const BaseType* a, size_t aSize, const BaseType* b, size_t bSize,
+			LimbStorage<BaseType>& quotient, LimbStorage<BaseType>& remainder);
+
+	/**
+	 * division of two positive numbers by multiplying with a Newton approximation of 1 / b, the result is
+	 * corrected to the exact quotient and remainder
+	 */
+	static void newtonDivide (const BigIntegerBase& a, const BigIntegerBase& b, BigIntegerBase& quotient, BigIntegerBase& remainder);
+
+	/**
+	 * approximation of 2^(2 * precision) / divisorTop, where divisorTop has exactly precision bits. The
+	 * precision is doubled by every Newton step, starting from a long division at the bottom.
+	 */
+	static BigIntegerBase newtonReciprocal (const BigIntegerBase& divisorTop, unsigned int precision);
+
+	/// the largest power of base which fits into a limb, chunkDigits is set to its exponent
+	static BaseType radixChunkPower (unsigned int base, unsigned int& chunkDigits);
+
+	/**
+	 * (radixChunkPower (base))^(2^index), the powers are computed once per thread and base and stay valid
+	 */
+	static const BigIntegerBase& radixPower (unsigned int base, size_t index);
+
+	/// an upper bound of the number of digits of a number with the given bits
+	static size_t maxDigits (size_t bits, unsigned int base)
+	{
+		return (size_t) ((double) bits / std::log2 ((double) base) * (1.0 + 1e-12)) + 1;
+	}
+
+	/// log2 (base) for bases which are powers of two, 0 for the others
+	static unsigned int radixBits (unsigned int base)
+	{
+		return ((base & (base - 1)) == 0) ? Limbs::trailingZeros ((BaseType) base) : 0;
+	}
+
+	static char digitChar (unsigned int value)
+	{
+		return "0123456789abcdefghijklmnopqrstuvwxyz"[value];
+	}
+
+	/// the value of the digit c, base if it is no digit
+	static unsigned int digitValue (char c, unsigned int base)
+	{
+		unsigned int value = base;
+		if ((c >= '0') && (c <= '9'))
+		{
+			value = (unsigned int) (c - '0');
+		}
+		else if ((c >= 'a') && (c <= 'z'))
+		{
+			value = (unsigned int) (c - 'a') + 10;
+		}
+		else if ((c >= 'A') && (c <= 'Z'))
+		{
+			value = (unsigned int) (c - 'A') + 10;
+		}
+		return (value < base) ? value : base;
+	}
+
+	/**
+	 * writes the digits of a limb array in the given base to out and returns the end of them. With width 0
+	 * the number is written without leading zeroes, otherwise padded to exactly width digits, nullptr is
+	 * returned if it has more digits than that. Large numbers are split by the largest cached power of the
+	 * base below their square root, the upper part is written first and the lower part padded to the digits
+	 * of the power.
+	 */
+	static char* writeDigits (const BaseType* limbs, size_t size, char* out, size_t width, unsigned int base);
+
+	/**
+	 * the quadratic conversion for writeDigits, one single limb division per chunk of digits. Numbers below
+	 * _conversionInlineBytes do not allocate.
+	 */
+	static char* writeDigitsBasecase (const BaseType* limbs, size_t size, char* out, size_t width, unsigned int base);
+
+	/// the digits of a positive number in a base which is a power of two, radixBits bits per digit
+	static char* writeDigitsPowerOfTwo (const BaseType* limbs, size_t size, char* out, unsigned int radixBits);
+
+	/**
+	 * the limbs of the number given by count valid digits in the given base, long strings are split like
+	 * in writeDigits and the upper part is multiplied by the cached power of the base
+	 */
+	static void parseDigits (LimbStorage<BaseType>& result, const char* digits, size_t count, unsigned int base);
+
+	/// parseDigits for bases which are powers of two, radixBits bits per digit
+	static void parseDigitsPowerOfTwo (LimbStorage<BaseType>& result, const char* digits, size_t count, unsigned int radixBits);
+
+	/// scratch of the basecase conversion which lives on the stack
+	static const size_t _conversionInlineBytes = 1024;
+
 	void cleanLeadingZeroes ();
 
 	/**
-	 * exclude eventual leading zero entries in the vector
+	 * this = operation (a, b) applied limb by limb to the two's complements, this may be a or b. Negative
+	 * operands are complemented into temporaries, so the positive ones are read in place.
 	 */
-	unsigned int getRealSize () const;
+	template <typename Operation>
+	void assignBitwise (const BigIntegerBase& a, const BigIntegerBase& b, Operation operation);
+
+	/**
+	 * the limb with the given index of the two's complement of a number with size limbs, negative tells
+	 * if the number is negative and lowest is the index of its lowest non zero limb then
+	 */
+	BaseType twosComplementLimb (size_t index, size_t size, bool negative, size_t lowest) const
+	{
+		if (index >= size)
+		{
+			return negative ? (BaseType) ~(BaseType) 0 : 0;
+		}
+		if (!negative)
+		{
+			return _bigNumber[index];
+		}
+		if (index < lowest)
+		{
+			return 0;
+		}
+		return (index == lowest) ? (BaseType) -_bigNumber[index] : (BaseType) ~_bigNumber[index];
+	}
 
-	BaseType getHighPart (BaseType victim) const
+	/// true if the native byte order is little endian
+	static bool isLittleEndianHost ()
 	{
-		return ((victim & _highMask) >> _baseTypeHalfSize);
+		const std::uint16_t one = 1;
+		return *reinterpret_cast<const unsigned char*> (&one) == 1;
 	}
 
-	BaseType getLowPart (BaseType victim) const
+	/// true if the words have their least significant byte first
+	static bool hasLittleEndianWords (ByteOrder byteOrder)
 	{
-		return (victim & _lowMask);
+		return (byteOrder == ByteOrder::Little) || ((byteOrder == ByteOrder::Native) && isLittleEndianHost ());
 	}
+
+	/**
+	 * exclude eventual leading zero entries in the vector
+	 */
+	unsigned int getRealSize () const;
 };
 
-typedef BigIntegerBase<unsigned char> BigInteger;
+/**
+ * Three operand arithmetic, the result is computed into the existing limbs of result and may be one of
+ * the operands. For example x = x * y - z is mul (x, x, y); sub (x, x, z); without any temporary number.
+ */
+template <typename BaseType>
+void add (BigIntegerBase<BaseType>& result, const BigIntegerBase<BaseType>& a, const BigIntegerBase<BaseType>& b)
+{
+	result.assignSum (a, b, b._isPositive);
+}
+
+template <typename BaseType>
+void sub (BigIntegerBase<BaseType>& result, const BigIntegerBase<BaseType>& a, const BigIntegerBase<BaseType>& b)
+{
+	result.assignSum (a, b, !b._isPositive);
+}
+
+template <typename BaseType>
+void mul (BigIntegerBase<BaseType>& result, const BigIntegerBase<BaseType>& a, const BigIntegerBase<BaseType>& b)
+{
+	result.assignProduct (a, b);
+}
+
+/// result += a * b
+template <typename BaseType>
+void addmul (BigIntegerBase<BaseType>& result, const BigIntegerBase<BaseType>& a, const BigIntegerBase<BaseType>& b)
+{
+	result.addProduct (a, b, false);
+}
+
+/// result -= a * b
+template <typename BaseType>
+void submul (BigIntegerBase<BaseType>& result, const BigIntegerBase<BaseType>& a, const BigIntegerBase<BaseType>& b)
+{
+	result.addProduct (a, b, true);
+}
 
+typedef BigIntegerBase<std::uint64_t> BigInteger;
 
-BigInteger operator"" _bigInt(const char* val)
+/**
+ * an exact BigInteger literal, e.g. 123456789012345678901234567890_bigInt or -0xFFFF'FFFF'FFFF'FFFF'FFFF_bigInt,
+ * with the bases of FixedBigIntegerLiteral. The compiler parses the digits into a FixedBigInteger, at run time
+ * only its limbs are copied. Floating literals like 1.5_bigInt do not compile.
+ */
+template <char... Characters>
+BigInteger operator"" _bigInt ()
 {
-  BigInteger result;
-  result.setFromString(std::string(val));
-  return result;
+	static_assert(FixedBigIntegerLiteral::isInteger<Characters...> (), "_bigInt needs an integer literal");
+	static constexpr FixedBigInteger<FixedBigIntegerLiteral::bits<Characters...> ()> value = operator"" _fixed<Characters...> ();
+	return BigInteger (value);
 }
 
+/// the base selected by std::dec, std::hex and std::oct
+inline int streamBase (const std::ios_base& stream)
+{
+	std::ios_base::fmtflags baseField = stream.flags () & std::ios_base::basefield;
+	return (baseField == std::ios_base::hex) ? 16 : ((baseField == std::ios_base::oct) ? 8 : 10);
+}
 
+/**
+ * writes the number in the base of the stream, uppercase, showbase, showpos, width and adjustment are
+ * honored. Numbers of up to 256 characters are put together on the stack.
+ */
 template <typename BaseType>
 std::ostream& operator<< (std::ostream& os, const BigIntegerBase<BaseType>& num)
 {
-	os << num.asString();
+	int base = streamBase (os);
+	char buffer[256];
+	std::string heapBuffer;
+	char* first = buffer;
+	ToCharsResult written = num.toChars (buffer, buffer + sizeof(buffer), base);
+	if (written.ec != std::errc ())
+	{
+		heapBuffer = num.asString (base);
+		first = &heapBuffer[0];
+		written.ptr = first + heapBuffer.size ();
+	}
+	std::ios_base::fmtflags flags = os.flags ();
+	char prefix[4];
+	size_t prefixLength = 0;
+	if (*first == '-')
+	{
+		prefix[prefixLength++] = *first++;
+	}
+	else if ((flags & std::ios_base::showpos) != 0)
+	{
+		prefix[prefixLength++] = '+';
+	}
+	if (((flags & std::ios_base::showbase) != 0) && (base != 10))
+	{
+		prefix[prefixLength++] = '0';
+		if (base == 16)
+		{
+			prefix[prefixLength++] = ((flags & std::ios_base::uppercase) != 0) ? 'X' : 'x';
+		}
+	}
+	if ((flags & std::ios_base::uppercase) != 0)
+	{
+		std::transform (first, written.ptr, first, [] (char c) { return (char) std::toupper (c); });
+	}
+	std::streamsize length = (std::streamsize) prefixLength + (written.ptr - first);
+	std::streamsize padding = (os.width () > length) ? os.width () - length : 0;
+	os.width (0);
+	std::ios_base::fmtflags adjustment = flags & std::ios_base::adjustfield;
+	if ((adjustment != std::ios_base::left) && (adjustment != std::ios_base::internal))
+	{
+		for (std::streamsize i = 0; i < padding; ++i)
+		{
+			os.put (os.fill ());
+		}
+	}
+	os.write (prefix, prefixLength);
+	if (adjustment == std::ios_base::internal)
+	{
+		for (std::streamsize i = 0; i < padding; ++i)
+		{
+			os.put (os.fill ());
+		}
+	}
+	os.write (first, written.ptr - first);
+	if (adjustment == std::ios_base::left)
+	{
+		for (std::streamsize i = 0; i < padding; ++i)
+		{
+			os.put (os.fill ());
+		}
+	}
 	return os;
 }
 
+/**
+ * reads a number in the base of the stream after skipping white space, with an optional sign. Sets the
+ * failbit and leaves num unchanged if there are no digits.
+ */
+template <typename BaseType>
+std::istream& operator>> (std::istream& is, BigIntegerBase<BaseType>& num)
+{
+	std::istream::sentry sentry (is);
+	if (!sentry)
+	{
+		return is;
+	}
+	int base = streamBase (is);
+	// short input stays on the stack, long input is collected in longInput
+	char buffer[256];
+	std::string longInput;
+	size_t length = 0;
+	bool hasDigits = false;
+	for (int c = is.peek (); c != std::char_traits<char>::eof (); c = is.peek ())
+	{
+		bool isSign = ((c == '-') || (c == '+')) && (length == 0) && longInput.empty ();
+		int value = std::isdigit (c) ? c - '0' : (std::isalpha (c) ? std::tolower (c) - 'a' + 10 : base);
+		if (!isSign && (value >= base))
+		{
+			break;
+		}
+		hasDigits = hasDigits || !isSign;
+		if (length == sizeof(buffer))
+		{
+			longInput.append (buffer, length);
+			length = 0;
+		}
+		buffer[length++] = (char) is.get ();
+	}
+	const char* first = buffer;
+	const char* last = buffer + length;
+	if (!longInput.empty ())
+	{
+		longInput.append (buffer, length);
+		first = longInput.data ();
+		last = first + longInput.size ();
+	}
+	if (hasDigits && (*first == '+'))
+	{
+		++first;
+	}
+	if (!hasDigits || (num.fromChars (first, last, base).ec != std::errc ()))
+	{
+		is.setstate (std::ios_base::failbit);
+	}
+	return is;
+}
+
 template <typename BaseType>
 template <typename T>
 void BigIntegerBase<BaseType>::setFromNumber (T number)
 {
 	_bigNumber.clear ();
-	T absVal = std::abs (number);
+	unsigned long long absVal = (Utilities::sgn (number) >= 0) ? (unsigned long long) number : 0ULL - (unsigned long long) number;
 	if (absVal == 0)
 	{
 		_bigNumber.push_back(0);
 	}
-	BaseType tempPackage;
-	T packageMask = ((BaseType) -1);
 	while (absVal > 0)
 	{
-		tempPackage = absVal & packageMask;
-		//std::cout << (int) tempPackage << std::endl;
-		_bigNumber.push_back (tempPackage);
-		absVal = absVal >> _baseTypeSize;
+		_bigNumber.push_back ((BaseType) absVal);
+		absVal = (_baseTypeSize < 64) ? (absVal >> (_baseTypeSize % 64)) : 0;
 	}
 	_isPositive = (Utilities::sgn (number) >= 0);
 }
@@ -230,24 +768,22 @@ void BigIntegerBase<BaseType>::setFromNumber (T number)
 template <typename BaseType>
 void BigIntegerBase<BaseType>::setFromString (const std::string& number)
 {
-	BigIntegerBase<BaseType> baseTen = 10;
-	_bigNumber.clear();
-	if (number.size() == 0)
-	{
-		_bigNumber.push_back(0);
-		return;
-	}
-	size_t stringSize = number.size();
-	for (size_t i = 0; i < stringSize; ++i)
+	UTILITIES_INSTRUMENT_OPERATION (FromString, number.size ());
+	std::string digits;
+	digits.reserve (number.size ());
+	for (size_t i = 0; i < number.size (); ++i)
 	{
-		if (isdigit(number[i]))
+		if (isdigit (number[i]))
 		{
-			*this *= baseTen;
-			*this += (number[i] - '0');
+			digits.push_back (number[i]);
 		}
 	}
-	_isPositive = (number[0] != '-');
-
+	parseDigits (_bigNumber, digits.data (), digits.size (), 10);
+	if (_bigNumber.empty ())
+	{
+		_bigNumber.push_back (0);
+	}
+	_isPositive = (number.size () == 0) || (number[0] != '-') || (getRealSize () == 0);
 }
 
 template <typename BaseType>
@@ -261,7 +797,7 @@ bool BigIntegerBase<BaseType>::isBitSet (unsigned int index) const
 	else
 	{
 		unsigned int chunkIndex = index % _baseTypeSize;
-		return (_bigNumber[chunkNr] & (1 << chunkIndex)) > 0;
+		return (_bigNumber[chunkNr] & ((BaseType) 1 << chunkIndex)) != 0;
 	}
 }
 
@@ -280,232 +816,359 @@ void BigIntegerBase<BaseType>::setBit (unsigned int index, bool setToOne)
 	unsigned int chunkIndex = index % _baseTypeSize;
 	if (setToOne)
 	{
-		_bigNumber[chunkNr] |= (1 << chunkIndex);
+		_bigNumber[chunkNr] |= ((BaseType) 1 << chunkIndex);
 	}
 	else // set to Zero
 	{
-		_bigNumber[chunkNr] &= ~(1 << chunkIndex);
+		_bigNumber[chunkNr] &= ~((BaseType) 1 << chunkIndex);
 	}
 }
 
 template <typename BaseType>
 void BigIntegerBase<BaseType>::shiftLeft (unsigned int howMuch)
 {
+	UTILITIES_INSTRUMENT_OPERATION (Shift, getRealSize ());
 	unsigned int blocks = howMuch / _baseTypeSize;
-	unsigned int shiftPart1 = howMuch % _baseTypeSize;
-	unsigned int shiftPart2 = _baseTypeSize - shiftPart1;
-	size_t chunks = _bigNumber.size();
+	unsigned int bitShift = howMuch % _baseTypeSize;
+	size_t chunks = getRealSize ();
 	if ((chunks == 0) || (howMuch == 0))
 	{
 		return;
 	}
-	for (unsigned int i = 0; i < blocks; ++i)
-	{
-		_bigNumber.push_back(0);
-	}
-	BaseType entry = _bigNumber[chunks-1] >> shiftPart2;
-	if (entry > 0)
+	_bigNumber.resize (chunks + blocks + 1);
+	BaseType* limbs = _bigNumber.data ();
+	if (bitShift > 0)
 	{
-		_bigNumber.push_back(entry);
+		limbs[chunks + blocks] = Limbs::shiftLeftBits (limbs + blocks, limbs, chunks, bitShift);
 	}
-	for (unsigned int i = chunks + blocks - 1; i > blocks; --i)
+	else
 	{
-		entry = _bigNumber[i - blocks] << shiftPart1;
-		entry += _bigNumber[i - blocks - 1] >> shiftPart2;
-		_bigNumber[i] = entry;
+		limbs[chunks + blocks] = 0;
+		for (size_t i = chunks; i > 0; --i)
+		{
+			limbs[i - 1 + blocks] = limbs[i - 1];
+		}
 	}
-	_bigNumber[blocks] = _bigNumber[0] << shiftPart1;
 	for (unsigned int i = 0; i < blocks; ++i)
 	{
-		_bigNumber[i] = 0;
+		limbs[i] = 0;
 	}
+	cleanLeadingZeroes();
 }
 
 template <typename BaseType>
 void BigIntegerBase<BaseType>::shiftRight (unsigned int howMuch)
 {
+	UTILITIES_INSTRUMENT_OPERATION (Shift, getRealSize ());
 	unsigned int blocks = howMuch / _baseTypeSize;
-	unsigned int shiftPart1 = howMuch % _baseTypeSize;
-	unsigned int shiftPart2 = _baseTypeSize - shiftPart1;
-	size_t chunks = _bigNumber.size();
+	unsigned int bitShift = howMuch % _baseTypeSize;
+	size_t chunks = getRealSize ();
 	if ((chunks == 0) || (howMuch == 0))
 	{
 		return;
 	}
-	for (unsigned int i = 0; i < chunks - blocks - 1; ++i)
+	if (blocks >= chunks)
 	{
-		_bigNumber[i] = _bigNumber[i + blocks] >> shiftPart1;
-		_bigNumber[i] += _bigNumber[i + blocks+1] << shiftPart2;
+		_bigNumber.clear ();
+		return;
 	}
-	_bigNumber[chunks - 1 - blocks] = _bigNumber[chunks - 1] >> shiftPart1;
-	for (unsigned int i = 0; i < blocks; ++i)
+	BaseType* limbs = _bigNumber.data ();
+	if (bitShift > 0)
 	{
-		_bigNumber[chunks - 1 - i] = 0;
+		Limbs::shiftRightBits (limbs, limbs + blocks, chunks - blocks, bitShift);
 	}
-	cleanLeadingZeroes();
-}
-
-template<typename BaseType>
-void BigIntegerBase<BaseType>::addEntry (std::vector<BaseType>* victim, BaseType entry, unsigned int index) const
-{
-	size_t victimSize = victim->size();
-	while (entry > 0)
+	else
 	{
-		if (index >= victimSize)
-		{
-			victim->push_back(entry);
-			entry = 0;
-		}
-		else
+		for (size_t i = 0; i < chunks - blocks; ++i)
 		{
-			BaseType maxAllowed = std::numeric_limits<BaseType>::max() - (*victim)[index];
-			BaseType result = (*victim)[index] + entry;
-			(*victim)[index] = result;
-			entry = (entry > maxAllowed) ? 1 :0;
-			++index;
+			limbs[i] = limbs[i + blocks];
 		}
 	}
+	_bigNumber.resize (chunks - blocks);
+	cleanLeadingZeroes();
 }
 
-template<typename BaseType>
-void BigIntegerBase<BaseType>::multiplyAddEntry (std::vector<BaseType>* victim, BaseType entry1, BaseType entry2, unsigned int index) const
-{
-	BaseType entry1Low = getLowPart(entry1);
-	BaseType entry2Low = getLowPart(entry2);
-	BaseType entry1High = getHighPart(entry1);
-	BaseType entry2High = getHighPart(entry2);
-	BaseType low[2];
-	low[0] = entry1Low * entry2Low;
-	BaseType high[2];
-	high[1] = entry1High * entry2High;
-	BaseType middle1 = entry1Low * entry2High;
-	BaseType middle2 = entry1High * entry2Low;
-	low[1] = getLowPart(middle1);
-	low[1] += getLowPart(middle2);
-	high[0] = getHighPart(middle1);
-	high[0] += getHighPart(middle2);
-	high[0] += getHighPart(low[1]);
-	low[1] = getLowPart(low[1]) << _baseTypeHalfSize;
-	addEntry(victim, low[0], index);
-	addEntry(victim, low[1], index);
-	addEntry(victim, high[0], index+1);
-	addEntry(victim, high[1], index+1);
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerBase<BaseType>::operator<< (unsigned int howMuch) const
+{
+	BigIntegerBase<BaseType> result (*this);
+	result.shiftLeft (howMuch);
+	return result;
 }
 
-template<typename BaseType>
-void BigIntegerBase<BaseType>::subtractEntry (std::vector<BaseType>* victim, BaseType entry, unsigned int index) const
+template <typename BaseType>
+BigIntegerBase<BaseType>& BigIntegerBase<BaseType>::operator>>= (unsigned int howMuch)
 {
-	size_t victimSize = victim->size();
-	while ((entry > 0) && (index < victimSize))
+	// a negative number is rounded down if any of the shifted out bits is set
+	bool roundDown = !_isPositive && (howMuch > 0) && (getRealSize () > 0) && (countTrailingZeros () < howMuch);
+	shiftRight (howMuch);
+	if (roundDown)
 	{
-		BaseType result = (*victim)[index] - entry;
-		entry = (entry > (*victim)[index]) ? 1 : 0;
-		(*victim)[index] = result;
-		++index;
+		size_t size = getRealSize ();
+		_bigNumber.resize (size + 1);
+		_bigNumber[size] = Limbs::addLimb (_bigNumber.data (), _bigNumber.data (), size, 1);
+		cleanLeadingZeroes ();
+		_isPositive = false;
 	}
+	return *this;
 }
 
-template<typename BaseType>
-BigIntegerBase<BaseType>& BigIntegerBase<BaseType>::operator+= (const BigIntegerBase<BaseType>& rhs)
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerBase<BaseType>::operator>> (unsigned int howMuch) const
 {
-	if (this->isPositive () && !rhs.isPositive ())
-	{
-		BigIntegerBase tempRhs (rhs);
-		tempRhs._isPositive = true;
-		*this -= tempRhs;
-		return *this;
-	}
-	else if (!this->isPositive () && rhs.isPositive ())
+	BigIntegerBase<BaseType> result (*this);
+	result >>= howMuch;
+	return result;
+}
+
+template <typename BaseType>
+template <typename Operation>
+void BigIntegerBase<BaseType>::assignBitwise (const BigIntegerBase& a, const BigIntegerBase& b, Operation operation)
+{
+	size_t aSize = a.getRealSize ();
+	size_t bSize = b.getRealSize ();
+	bool aIsNegative = !a._isPositive && (aSize > 0);
+	bool bIsNegative = !b._isPositive && (bSize > 0);
+	LimbStorage<BaseType> aComplement;
+	LimbStorage<BaseType> bComplement;
+	if (aIsNegative)
+	{
+		aComplement.resize (aSize);
+		Limbs::negateN (aComplement.data (), a._bigNumber.data (), aSize);
+	}
+	if (bIsNegative)
 	{
-		this->_isPositive = true;
-		*this = rhs - (*this);
-		return *this;
+		bComplement.resize (bSize);
+		Limbs::negateN (bComplement.data (), b._bigNumber.data (), bSize);
 	}
-	unsigned int rhsSize = rhs._bigNumber.size ();
-	for (unsigned int i = 0; i < rhsSize; ++i)
+	// the limbs above the size of an operand, its sign extension
+	const BaseType ones = (BaseType) ~(BaseType) 0;
+	BaseType aExtension = aIsNegative ? ones : 0;
+	BaseType bExtension = bIsNegative ? ones : 0;
+	bool isNegative = operation (aExtension, bExtension) != 0;
+
+	size_t size = std::max (aSize, bSize);
+	size_t common = std::min (aSize, bSize);
+	_bigNumber.resize (size + 1);
+	const BaseType* aLimbs = aIsNegative ? aComplement.data () : a._bigNumber.data ();
+	const BaseType* bLimbs = bIsNegative ? bComplement.data () : b._bigNumber.data ();
+	BaseType* limbs = _bigNumber.data ();
+	for (size_t i = 0; i < common; ++i)
 	{
-		addEntry (&_bigNumber, rhs._bigNumber[i], i);
+		limbs[i] = operation (aLimbs[i], bLimbs[i]);
 	}
+	for (size_t i = common; i < aSize; ++i)
+	{
+		limbs[i] = operation (aLimbs[i], bExtension);
+	}
+	for (size_t i = common; i < bSize; ++i)
+	{
+		limbs[i] = operation (aExtension, bLimbs[i]);
+	}
+	// back from the two's complement to the magnitude, which is one limb longer if all limbs are zero
+	limbs[size] = isNegative ? 1 - Limbs::negateN (limbs, limbs, size) : 0;
+	cleanLeadingZeroes ();
+	_isPositive = !isNegative;
+}
 
+template <typename BaseType>
+BigIntegerBase<BaseType>& BigIntegerBase<BaseType>::operator&= (const BigIntegerBase<BaseType>& rhs)
+{
+	assignBitwise (*this, rhs, std::bit_and<BaseType> ());
 	return *this;
 }
 
-template<typename BaseType>
-BigIntegerBase<BaseType> BigIntegerBase<BaseType>::operator+ (const BigIntegerBase<BaseType>& rhs) const
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerBase<BaseType>::operator& (const BigIntegerBase<BaseType>& rhs) const
 {
-	BigIntegerBase<BaseType> tempInt (*this);
-	tempInt += rhs;
-	return tempInt;
+	BigIntegerBase<BaseType> result;
+	result.assignBitwise (*this, rhs, std::bit_and<BaseType> ());
+	return result;
 }
 
-template<typename BaseType>
-BigIntegerBase<BaseType>& BigIntegerBase<BaseType>::operator-= (const BigIntegerBase<BaseType>& rhs)
+template <typename BaseType>
+BigIntegerBase<BaseType>& BigIntegerBase<BaseType>::operator|= (const BigIntegerBase<BaseType>& rhs)
 {
-	int comparison = this->compare (rhs);
-	std::vector<BaseType> smallerSide;
-	bool resultIsPositive;
+	assignBitwise (*this, rhs, std::bit_or<BaseType> ());
+	return *this;
+}
 
-	// a - (-b) = a + b
-	if (this->isPositive () && !rhs.isPositive ())
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerBase<BaseType>::operator| (const BigIntegerBase<BaseType>& rhs) const
+{
+	BigIntegerBase<BaseType> result;
+	result.assignBitwise (*this, rhs, std::bit_or<BaseType> ());
+	return result;
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType>& BigIntegerBase<BaseType>::operator^= (const BigIntegerBase<BaseType>& rhs)
+{
+	assignBitwise (*this, rhs, std::bit_xor<BaseType> ());
+	return *this;
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerBase<BaseType>::operator^ (const BigIntegerBase<BaseType>& rhs) const
+{
+	BigIntegerBase<BaseType> result;
+	result.assignBitwise (*this, rhs, std::bit_xor<BaseType> ());
+	return result;
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerBase<BaseType>::operator~ () const
+{
+	BigIntegerBase<BaseType> result (*this);
+	size_t size = result.getRealSize ();
+	BaseType* limbs;
+	if (_isPositive || (size == 0))
 	{
-		BigIntegerBase tempRhs (rhs);
-		tempRhs._isPositive = true;
-		*this += tempRhs;
-		return *this;
+		// -(this + 1)
+		result._bigNumber.resize (size + 1);
+		limbs = result._bigNumber.data ();
+		limbs[size] = Limbs::addLimb (limbs, limbs, size, 1);
+		result._isPositive = false;
 	}
-	// (-a) - b = -(a+b), this is already negative, as well as the result
-	else if (!this->isPositive () && rhs.isPositive ())
+	else
 	{
-		*this += rhs;
-		return *this;
+		// |this| - 1
+		limbs = result._bigNumber.data ();
+		Limbs::subLimb (limbs, limbs, size, 1);
+		result._isPositive = true;
 	}
+	result.cleanLeadingZeroes ();
+	return result;
+}
 
-	// we want to subtract the smaller number from the bigger one
-	if (comparison >= 0)
+template <typename BaseType>
+unsigned int BigIntegerBase<BaseType>::countTrailingZeros () const
+{
+	if (getRealSize () == 0)
 	{
-		resultIsPositive = true;
-		smallerSide = rhs._bigNumber;
+		throw std::domain_error("BigIntegerBase::countTrailingZeros: zero has no set bit");
 	}
-	else
+	unsigned int index = 0;
+	while (_bigNumber[index] == 0)
 	{
-		resultIsPositive = false;
-		smallerSide = this->_bigNumber;
-		_bigNumber = rhs._bigNumber;
+		++index;
 	}
+	return index * _baseTypeSize + Limbs::trailingZeros (_bigNumber[index]);
+}
 
-	// (-a) - (-b) = -a + b = b - a
-	if (!this->isPositive () && !rhs.isPositive ())
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerBase<BaseType>::extractBits (unsigned int start, unsigned int count) const
+{
+	size_t size = getRealSize ();
+	bool negative = !_isPositive && (size > 0);
+	size_t lowest = 0;
+	while (negative && (_bigNumber[lowest] == 0))
 	{
-		resultIsPositive = !resultIsPositive; // if a-b would have been positive, then b-a is negative
+		++lowest;
 	}
+	size_t first = start / _baseTypeSize;
+	unsigned int bitShift = start % _baseTypeSize;
+	size_t limbCount = (count + _baseTypeSize - 1) / _baseTypeSize;
 
-	unsigned int smallerSize = smallerSide.size();
-	for (unsigned int i = 0; i < smallerSize; ++i)
+	// one more limb for the bits shifted in from above
+	BigIntegerBase<BaseType> result;
+	result._bigNumber.resize (limbCount + 1);
+	BaseType* limbs = result._bigNumber.data ();
+	for (size_t i = 0; i <= limbCount; ++i)
+	{
+		limbs[i] = twosComplementLimb (first + i, size, negative, lowest);
+	}
+	if (bitShift > 0)
 	{
-		subtractEntry(&_bigNumber, smallerSide[i], i);
+		Limbs::shiftRightBits (limbs, limbs, limbCount + 1, bitShift);
 	}
+	result._bigNumber.resize (limbCount);
+	if (count % _baseTypeSize != 0)
+	{
+		result._bigNumber[limbCount - 1] &= ((BaseType) 1 << (count % _baseTypeSize)) - 1;
+	}
+	result.cleanLeadingZeroes ();
+	return result;
+}
 
+template<typename BaseType>
+bool BigIntegerBase<BaseType>::addSigned (LimbStorage<BaseType>& result, const LimbStorage<BaseType>& a, size_t aSize, bool aIsPositive,
+		const LimbStorage<BaseType>& b, size_t bSize, bool bIsPositive)
+{
+	if (aIsPositive == bIsPositive)
+	{
+		// same signs, the magnitudes are added and the sign stays
+		size_t maxSize = std::max (aSize, bSize);
+		result.resize (maxSize + 1);
+		if (aSize >= bSize)
+		{
+			result[maxSize] = Limbs::add (result.data (), a.data (), aSize, b.data (), bSize);
+		}
+		else
+		{
+			result[maxSize] = Limbs::add (result.data (), b.data (), bSize, a.data (), aSize);
+		}
+		return aIsPositive;
+	}
+	// different signs, we want to subtract the smaller magnitude from the bigger one
+	int comparison = Limbs::compare (a.data (), aSize, b.data (), bSize);
+	if (comparison >= 0)
+	{
+		result.resize (aSize);
+		Limbs::sub (result.data (), a.data (), aSize, b.data (), bSize);
+		return aIsPositive || (comparison == 0);
+	}
+	result.resize (bSize);
+	Limbs::sub (result.data (), b.data (), bSize, a.data (), aSize);
+	return bIsPositive;
+}
+
+template<typename BaseType>
+void BigIntegerBase<BaseType>::assignSum (const BigIntegerBase& a, const BigIntegerBase& b, bool bIsPositive)
+{
+	_isPositive = addSigned (_bigNumber, a._bigNumber, a.getRealSize (), a._isPositive, b._bigNumber, b.getRealSize (), bIsPositive);
 	cleanLeadingZeroes ();
-	_isPositive = resultIsPositive;
+}
 
+template<typename BaseType>
+BigIntegerBase<BaseType>& BigIntegerBase<BaseType>::operator+= (const BigIntegerBase<BaseType>& rhs)
+{
+	UTILITIES_INSTRUMENT_OPERATION (Add, getRealSize () + rhs.getRealSize ());
+	assignSum (*this, rhs, rhs._isPositive);
+	return *this;
+}
+
+template<typename BaseType>
+BigIntegerBase<BaseType> BigIntegerBase<BaseType>::operator+ (const BigIntegerBase<BaseType>& rhs) const
+{
+	UTILITIES_INSTRUMENT_OPERATION (Add, getRealSize () + rhs.getRealSize ());
+	BigIntegerBase<BaseType> result;
+	result.assignSum (*this, rhs, rhs._isPositive);
+	return result;
+}
+
+template<typename BaseType>
+BigIntegerBase<BaseType>& BigIntegerBase<BaseType>::operator-= (const BigIntegerBase<BaseType>& rhs)
+{
+	UTILITIES_INSTRUMENT_OPERATION (Sub, getRealSize () + rhs.getRealSize ());
+	// a - b = a + (-b)
+	assignSum (*this, rhs, !rhs._isPositive);
 	return *this;
 }
 
 template <typename BaseType>
 BigIntegerBase<BaseType> BigIntegerBase<BaseType>::operator- (const BigIntegerBase<BaseType>& rhs) const
 {
-	BigIntegerBase<BaseType> tempInt (*this);
-	tempInt -= rhs;
-	return tempInt;
+	UTILITIES_INSTRUMENT_OPERATION (Sub, getRealSize () + rhs.getRealSize ());
+	BigIntegerBase<BaseType> result;
+	result.assignSum (*this, rhs, !rhs._isPositive);
+	return result;
 }
 
 template <typename BaseType>
 BigIntegerBase<BaseType>& BigIntegerBase<BaseType>::operator*= (const BigIntegerBase<BaseType>& rhs)
 {
-	BigIntegerBase<BaseType> temp = (*this) * rhs;
-	//_bigNumber = temp._bigNumber;
-	//_isPositive = temp._isPositive;
-	swap(*this, temp);
+	assignProduct (*this, rhs);
 	return *this;
 }
 
@@ -513,51 +1176,479 @@ template <typename BaseType>
 BigIntegerBase<BaseType> BigIntegerBase<BaseType>::operator* (const BigIntegerBase<BaseType>& rhs) const
 {
 	BigIntegerBase<BaseType> result;
-	result._isPositive = (_isPositive && rhs._isPositive) || (!_isPositive && !rhs._isPositive);
-	size_t mySize = _bigNumber.size();
-	size_t rhsSize = rhs._bigNumber.size();
-	for (size_t l = 0; l < mySize; ++l)
+	result.assignProduct (*this, rhs);
+	return result;
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerBase<BaseType>::pow (unsigned int exponent) const
+{
+	BigIntegerBase<BaseType> result (1L);
+	if (exponent == 0)
+	{
+		return result;
+	}
+	if (getRealSize () == 0)
 	{
-		for (size_t r = 0; r < rhsSize; ++r)
+		return BigIntegerBase<BaseType> ();
+	}
+	unsigned int zeros = countTrailingZeros ();
+	if ((unsigned long long) zeros * exponent > std::numeric_limits<unsigned int>::max ())
+	{
+		throw std::overflow_error("BigIntegerBase::pow: the result is too large");
+	}
+	BigIntegerBase<BaseType> odd (*this);
+	odd.shiftRight (zeros);
+	const BaseType* oddLimbs = odd._bigNumber.data ();
+	size_t oddSize = odd.getRealSize ();
+	// left to right over the exponent bits, the products go to the second buffer and are swapped back
+	result._bigNumber.assign (oddLimbs, oddLimbs + oddSize);
+	LimbStorage<BaseType> product;
+	unsigned int bit = 0;
+	while ((exponent >> bit) > 1)
+	{
+		++bit;
+	}
+	while (bit-- > 0)
+	{
+		const BaseType* limbs = result._bigNumber.data ();
+		multiplyMagnitudes (product, limbs, result._bigNumber.size (), limbs, result._bigNumber.size ());
+		product.resize (Limbs::normalizedSize (product.data (), product.size ()));
+		result._bigNumber.swap (product);
+		if (((exponent >> bit) & 1) != 0)
 		{
-			multiplyAddEntry(&(result._bigNumber), _bigNumber[l], rhs._bigNumber[r], l+r);
+			multiplyMagnitudes (product, result._bigNumber.data (), result._bigNumber.size (), oddLimbs, oddSize);
+			product.resize (Limbs::normalizedSize (product.data (), product.size ()));
+			result._bigNumber.swap (product);
 		}
 	}
+	result.shiftLeft (zeros * exponent);
+	result._isPositive = _isPositive || ((exponent & 1) == 0);
 	return result;
 }
 
 template <typename BaseType>
-BigIntegerBase<BaseType>& BigIntegerBase<BaseType>::operator/= (const BigIntegerBase& rhs)
+void BigIntegerBase<BaseType>::assignProduct (const BigIntegerBase& a, const BigIntegerBase& b)
 {
-	BigIntegerBase<BaseType> temp = (*this) / rhs;
-	swap(*this, temp);
-	return *this;
+	bool isPositive = (a._isPositive == b._isPositive);
+	size_t aSize = a.getRealSize ();
+	size_t bSize = b.getRealSize ();
+	UTILITIES_INSTRUMENT_OPERATION (Mul, aSize + bSize);
+	if ((aSize == 0) || (bSize == 0))
+	{
+		_bigNumber.clear ();
+		_isPositive = true;
+		return;
+	}
+	const BaseType* aLimbs = a._bigNumber.data ();
+	const BaseType* bLimbs = b._bigNumber.data ();
+	if ((aSize == bSize) && (Limbs::compareN (aLimbs, bLimbs, aSize) == 0))
+	{
+		// a * a, multiplyMagnitudes squares if both operands are the same array
+		bLimbs = aLimbs;
+	}
+	if ((this == &a) || (this == &b))
+	{
+		// the product must not overlap the operands
+		LimbStorage<BaseType> product;
+		multiplyMagnitudes (product, aLimbs, aSize, bLimbs, bSize);
+		_bigNumber.swap (product);
+	}
+	else
+	{
+		multiplyMagnitudes (_bigNumber, aLimbs, aSize, bLimbs, bSize);
+	}
+	_isPositive = isPositive;
+	cleanLeadingZeroes ();
 }
 
 template <typename BaseType>
-BigIntegerBase<BaseType> BigIntegerBase<BaseType>::operator/ (const BigIntegerBase& rhs) const
+void BigIntegerBase<BaseType>::addProduct (const BigIntegerBase& a, const BigIntegerBase& b, bool subtract)
 {
-	BigIntegerBase<BaseType> result;
-	result._isPositive = (_isPositive && rhs._isPositive) || (!_isPositive && !rhs._isPositive);
-	BigIntegerBase<BaseType> divi;
-	for (int i = (_bigNumber.size() * _baseTypeSize) - 1; i >= 0; --i)
+	size_t aSize = a.getRealSize ();
+	size_t bSize = b.getRealSize ();
+	if ((aSize == 0) || (bSize == 0))
+	{
+		return;
+	}
+	const BaseType* aLimbs = a._bigNumber.data ();
+	const BaseType* bLimbs = b._bigNumber.data ();
+	if ((aSize == bSize) && (Limbs::compareN (aLimbs, bLimbs, aSize) == 0))
+	{
+		bLimbs = aLimbs;
+	}
+	LimbStorage<BaseType> product;
+	multiplyMagnitudes (product, aLimbs, aSize, bLimbs, bSize);
+	bool productIsPositive = ((a._isPositive == b._isPositive) != subtract);
+	_isPositive = addSigned (_bigNumber, _bigNumber, getRealSize (), _isPositive, product,
+			Limbs::normalizedSize (product.data (), product.size ()), productIsPositive);
+	cleanLeadingZeroes ();
+}
+
+template <typename BaseType>
+void BigIntegerBase<BaseType>::multiplyMagnitudes (LimbStorage<BaseType>& result, const BaseType* a, size_t aSize, const BaseType* b, size_t bSize)
+{
+	typedef LimbMultiplication<BaseType> Multiplication;
+	typedef BigIntegerTuning<BaseType> Tuning;
+	if (aSize < bSize)
+	{
+		std::swap (a, b);
+		std::swap (aSize, bSize);
+	}
+	result.resize (aSize + bSize);
+	if (bSize >= Tuning::nttThreshold)
 	{
-		divi.shiftLeft(1);
-		if (this->isBitSet(i))
+		UTILITIES_INSTRUMENT_TIER (MulNtt);
+		nttMultiply (result, a, aSize, b, bSize);
+	}
+	else if ((a == b) && (aSize == bSize))
+	{
+		if (aSize < Tuning::toom3SquareThreshold)
 		{
-			divi.setBit(0);
+			UTILITIES_INSTRUMENT_TIER (MulSquare);
+			Multiplication::square (result.data (), a, aSize);
 		}
-		if (divi >= rhs)
+		else
 		{
-			result.setBit(i);
-			divi -= rhs;
+			UTILITIES_INSTRUMENT_TIER (MulToom3);
+			toomCook3Multiply (result, a, aSize, a, aSize);
 		}
 	}
-	result.cleanLeadingZeroes();
+	else if (bSize < Tuning::karatsubaThreshold)
+	{
+		UTILITIES_INSTRUMENT_TIER (MulBasecase);
+		Multiplication::basecaseMultiply (result.data (), a, aSize, b, bSize);
+	}
+	else if (aSize >= 2 * bSize)
+	{
+		// unbalanced operands, a is cut into pieces of the size of b
+		UTILITIES_INSTRUMENT_TIER (MulUnbalanced);
+		std::fill (result.begin (), result.end (), 0);
+		ThreadPool* pool = poolFor (bSize);
+		size_t pieces = (aSize + bSize - 1) / bSize;
+		// with threads all pieces are multiplied first, otherwise one buffer is reused
+		std::vector<LimbStorage<BaseType> > partialProducts ((pool != nullptr) ? pieces : 1);
+		std::vector<std::function<void ()> > tasks;
+		for (size_t piece = 0; piece < pieces; ++piece)
+		{
+			size_t offset = piece * bSize;
+			size_t realPieceSize = Limbs::normalizedSize (a + offset, std::min (bSize, aSize - offset));
+			LimbStorage<BaseType>& partialProduct = partialProducts[(pool != nullptr) ? piece : 0];
+			partialProduct.clear ();
+			if (realPieceSize == 0)
+			{
+				continue;
+			}
+			if (pool == nullptr)
+			{
+				multiplyMagnitudes (partialProduct, a + offset, realPieceSize, b, bSize);
+				Multiplication::addShifted (result.data (), result.size (), partialProduct.data (), partialProduct.size (), offset);
+			}
+			else
+			{
+				tasks.push_back ([&partialProduct, a, offset, realPieceSize, b, bSize]
+				{
+					multiplyMagnitudes (partialProduct, a + offset, realPieceSize, b, bSize);
+				});
+			}
+		}
+		if (pool != nullptr)
+		{
+			UTILITIES_INSTRUMENT_NESTED_TASKS (tasks);
+			pool->invoke (tasks);
+			for (size_t piece = 0; piece < pieces; ++piece)
+			{
+				const LimbStorage<BaseType>& partialProduct = partialProducts[piece];
+				Multiplication::addShifted (result.data (), result.size (), partialProduct.data (), partialProduct.size (), piece * bSize);
+			}
+		}
+	}
+	else if ((bSize < Tuning::toom3Threshold) || (bSize <= 2 * ((aSize + 2) / 3)))
+	{
+		UTILITIES_INSTRUMENT_TIER (MulKaratsuba);
+		Multiplication::karatsubaMultiply (result.data (), a, aSize, b, bSize);
+	}
+	else
+	{
+		UTILITIES_INSTRUMENT_TIER (MulToom3);
+		toomCook3Multiply (result, a, aSize, b, bSize);
+	}
+}
 
+template <typename BaseType>
+void BigIntegerBase<BaseType>::toomCook3Multiply (LimbStorage<BaseType>& result, const BaseType* a, size_t aSize, const BaseType* b, size_t bSize)
+{
+	size_t k = (aSize + 2) / 3;
+	bool squaring = (a == b);
+
+	// evaluation of a (and b) at 0, 1, -1, -2 and infinity
+	BigIntegerBase<BaseType> a0 = fromLimbs (a, k);
+	BigIntegerBase<BaseType> a1 = fromLimbs (a + k, k);
+	BigIntegerBase<BaseType> a2 = fromLimbs (a + 2 * k, aSize - 2 * k);
+	BigIntegerBase<BaseType> aAtOne = a0 + a2;
+	BigIntegerBase<BaseType> aAtMinusOne = aAtOne - a1;
+	aAtOne += a1;
+	BigIntegerBase<BaseType> aAtMinusTwo = aAtMinusOne + a2;
+	aAtMinusTwo.shiftLeft (1);
+	aAtMinusTwo -= a0;
+
+	BigIntegerBase<BaseType> r0;
+	BigIntegerBase<BaseType> r1;
+	BigIntegerBase<BaseType> rMinusOne;
+	BigIntegerBase<BaseType> rMinusTwo;
+	BigIntegerBase<BaseType> rInfinity;
+	// the five products are independent, so they can run in parallel
+	std::vector<std::function<void ()> > products;
+	BigIntegerBase<BaseType> b0;
+	BigIntegerBase<BaseType> b1;
+	BigIntegerBase<BaseType> b2;
+	BigIntegerBase<BaseType> bAtOne;
+	BigIntegerBase<BaseType> bAtMinusOne;
+	BigIntegerBase<BaseType> bAtMinusTwo;
+	if (squaring)
+	{
+		products.push_back ([&] { r0 = a0.square (); });
+		products.push_back ([&] { r1 = aAtOne.square (); });
+		products.push_back ([&] { rMinusOne = aAtMinusOne.square (); });
+		products.push_back ([&] { rMinusTwo = aAtMinusTwo.square (); });
+		products.push_back ([&] { rInfinity = a2.square (); });
+	}
+	else
+	{
+		b0 = fromLimbs (b, k);
+		b1 = fromLimbs (b + k, k);
+		b2 = fromLimbs (b + 2 * k, bSize - 2 * k);
+		bAtOne = b0 + b2;
+		bAtMinusOne = bAtOne - b1;
+		bAtOne += b1;
+		bAtMinusTwo = bAtMinusOne + b2;
+		bAtMinusTwo.shiftLeft (1);
+		bAtMinusTwo -= b0;
+
+		products.push_back ([&] { r0 = a0 * b0; });
+		products.push_back ([&] { r1 = aAtOne * bAtOne; });
+		products.push_back ([&] { rMinusOne = aAtMinusOne * bAtMinusOne; });
+		products.push_back ([&] { rMinusTwo = aAtMinusTwo * bAtMinusTwo; });
+		products.push_back ([&] { rInfinity = a2 * b2; });
+	}
+	runTasks (poolFor (bSize), products);
+
+	// interpolation, all divisions are exact
+	BigIntegerBase<BaseType> c3 = rMinusTwo - r1;
+	c3.divideByLimb (3);
+	BigIntegerBase<BaseType> c1 = r1 - rMinusOne;
+	c1.shiftRight (1);
+	BigIntegerBase<BaseType> c2 = rMinusOne - r0;
+	c3 = c2 - c3;
+	c3.shiftRight (1);
+	c3 += rInfinity;
+	c3 += rInfinity;
+	c2 += c1;
+	c2 -= rInfinity;
+	c1 -= c3;
+
+	// the coefficients are the (non negative) coefficients of the product polynomial
+	std::fill (result.begin (), result.end (), 0);
+	const BigIntegerBase<BaseType>* coefficients[] = {&r0, &c1, &c2, &c3, &rInfinity};
+	for (size_t i = 0; i < 5; ++i)
+	{
+		const LimbStorage<BaseType>& limbs = coefficients[i]->_bigNumber;
+		LimbMultiplication<BaseType>::addShifted (result.data (), result.size (), limbs.data (), limbs.size (), i * k);
+	}
+}
+
+template <typename BaseType>
+ThreadPool* BigIntegerBase<BaseType>::poolFor (size_t size)
+{
+	typedef BigIntegerTuning<BaseType> Tuning;
+	if ((Tuning::threadPool == nullptr) || (size < Tuning::parallelThreshold) || (Tuning::threadPool->getThreadCount () < 2))
+	{
+		return nullptr;
+	}
+	return Tuning::threadPool;
+}
+
+template <typename BaseType>
+void BigIntegerBase<BaseType>::runTasks (ThreadPool* pool, std::vector<std::function<void ()> >& tasks)
+{
+	if (pool != nullptr)
+	{
+		UTILITIES_INSTRUMENT_NESTED_TASKS (tasks);
+		pool->invoke (tasks);
+	}
+	else
+	{
+		for (size_t i = 0; i < tasks.size (); ++i)
+		{
+			tasks[i] ();
+		}
+	}
+}
+
+template <typename BaseType>
+void BigIntegerBase<BaseType>::nttMultiply (LimbStorage<BaseType>& result, const BaseType* a, size_t aSize, const BaseType* b, size_t bSize)
+{
+	size_t aWords = Limbs::wordCount (aSize);
+	size_t bWords = Limbs::wordCount (bSize);
+	std::vector<std::uint64_t> words (aWords + bWords);
+	std::vector<std::uint64_t> productWords (aWords + bWords);
+	Limbs::packWords (words.data (), a, aSize);
+	const std::uint64_t* bWordPointer = words.data ();
+	if ((a != b) || (aSize != bSize))
+	{
+		Limbs::packWords (words.data () + aWords, b, bSize);
+		bWordPointer += aWords;
+	}
+	NumberTheoreticTransform::multiply (productWords.data (), words.data (), aWords, bWordPointer, bWords, poolFor (std::min (aSize, bSize)));
+	Limbs::unpackWords (result.data (), productWords.data (), aSize + bSize);
+}
+
+template <typename BaseType>
+BaseType BigIntegerBase<BaseType>::divideByLimb (BaseType divisor)
+{
+	BaseType remainder = Limbs::divRemLimb (_bigNumber.data (), _bigNumber.data (), _bigNumber.size (), divisor);
+	cleanLeadingZeroes ();
+	return remainder;
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType>& BigIntegerBase<BaseType>::operator/= (const BigIntegerBase& rhs)
+{
+	BigIntegerBase<BaseType> temp = divmod (rhs).first;
+	swap(*this, temp);
+	return *this;
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerBase<BaseType>::operator/ (const BigIntegerBase& rhs) const
+{
+	return divmod (rhs).first;
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType>& BigIntegerBase<BaseType>::operator%= (const BigIntegerBase& rhs)
+{
+	BigIntegerBase<BaseType> temp = divmod (rhs).second;
+	swap(*this, temp);
+	return *this;
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerBase<BaseType>::operator% (const BigIntegerBase& rhs) const
+{
+	return divmod (rhs).second;
+}
+
+template <typename BaseType>
+std::pair<BigIntegerBase<BaseType>, BigIntegerBase<BaseType> > BigIntegerBase<BaseType>::divmod (const BigIntegerBase& divisor) const
+{
+	size_t mySize = getRealSize ();
+	size_t divisorSize = divisor.getRealSize ();
+	UTILITIES_INSTRUMENT_OPERATION (Div, mySize + divisorSize);
+	if (divisorSize == 0)
+	{
+		throw std::domain_error("BigIntegerBase division by zero");
+	}
+	std::pair<BigIntegerBase<BaseType>, BigIntegerBase<BaseType> > result;
+	divideMagnitudes (_bigNumber.data (), mySize, divisor._bigNumber.data (), divisorSize, result.first._bigNumber, result.second._bigNumber);
+	result.first._isPositive = (_isPositive == divisor._isPositive) || (result.first._bigNumber.empty ());
+	result.second._isPositive = _isPositive || (result.second._bigNumber.empty ());
 	return result;
 }
 
+template <typename BaseType>
+void BigIntegerBase<BaseType>::divideMagnitudes (const BaseType* a, size_t aSize, const BaseType* b, size_t bSize,
+		LimbStorage<BaseType>& quotient, LimbStorage<BaseType>& remainder)
+{
+	typedef BigIntegerTuning<BaseType> Tuning;
+	if (Limbs::compare (a, aSize, b, bSize) < 0)
+	{
+		quotient.clear ();
+		remainder.assign (a, a + aSize);
+		return;
+	}
+	if (bSize == 1)
+	{
+		UTILITIES_INSTRUMENT_TIER (DivSingleLimb);
+		quotient.resize (aSize);
+		remainder.assign (1, Limbs::divRemLimb (quotient.data (), a, aSize, b[0]));
+	}
+	else if ((bSize >= Tuning::newtonDivisionThreshold) && (aSize - bSize >= Tuning::newtonDivisionThreshold))
+	{
+		UTILITIES_INSTRUMENT_TIER (DivNewton);
+		BigIntegerBase<BaseType> quotientNumber;
+		BigIntegerBase<BaseType> remainderNumber;
+		newtonDivide (fromLimbs (a, aSize), fromLimbs (b, bSize), quotientNumber, remainderNumber);
+		quotient.swap (quotientNumber._bigNumber);
+		remainder.swap (remainderNumber._bigNumber);
+	}
+	else
+	{
+		UTILITIES_INSTRUMENT_TIER (DivSchoolbook);
+		quotient.resize (aSize - bSize + 1);
+		remainder.resize (bSize);
+		LimbDivision<BaseType>::divide (quotient.data (), remainder.data (), a, aSize, b, bSize);
+	}
+	quotient.resize (Limbs::normalizedSize (quotient.data (), quotient.size ()));
+	remainder.resize (Limbs::normalizedSize (remainder.data (), remainder.size ()));
+}
+
+template <typename BaseType>
+void BigIntegerBase<BaseType>::newtonDivide (const BigIntegerBase& a, const BigIntegerBase& b, BigIntegerBase& quotient, BigIntegerBase& remainder)
+{
+	unsigned int aBits = a.bitLength ();
+	unsigned int bBits = b.bitLength ();
+	// the quotient has at most aBits - bBits + 1 bits, the guard bits keep the estimate within a few units
+	unsigned int precision = aBits - bBits + 1 + 64;
+	BigIntegerBase<BaseType> divisorTop = b;
+	if (bBits > precision)
+	{
+		divisorTop.shiftRight (bBits - precision);
+	}
+	else
+	{
+		divisorTop.shiftLeft (precision - bBits);
+	}
+	// b is about divisorTop * 2^(bBits - precision), so a / b is about a * reciprocal / 2^(precision + bBits)
+	quotient = a * newtonReciprocal (divisorTop, precision);
+	quotient.shiftRight (precision + bBits);
+	remainder = a - quotient * b;
+	while (!remainder._isPositive && (remainder.getRealSize () > 0))
+	{
+		quotient -= 1;
+		remainder += b;
+	}
+	while (remainder >= b)
+	{
+		quotient += 1;
+		remainder -= b;
+	}
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerBase<BaseType>::newtonReciprocal (const BigIntegerBase& divisorTop, unsigned int precision)
+{
+	BigIntegerBase<BaseType> powerOfTwo;
+	powerOfTwo.setBit (2 * precision);
+	if (precision < BigIntegerTuning<BaseType>::newtonDivisionThreshold * _baseTypeSize)
+	{
+		// small enough for the long division
+		return powerOfTwo / divisorTop;
+	}
+	unsigned int halfPrecision = (precision + 1) / 2 + 2;
+	BigIntegerBase<BaseType> divisorHigh = divisorTop;
+	divisorHigh.shiftRight (precision - halfPrecision);
+	BigIntegerBase<BaseType> reciprocal = newtonReciprocal (divisorHigh, halfPrecision);
+	reciprocal.shiftLeft (precision - halfPrecision);
+
+	// x = x + x * (2^(2p) - d * x) / 2^(2p) squares the relative error of x
+	BigIntegerBase<BaseType> error = powerOfTwo - divisorTop * reciprocal;
+	BigIntegerBase<BaseType> correction = reciprocal * error;
+	correction.shiftRight (2 * precision);
+	reciprocal += correction;
+	return reciprocal;
+}
+
 template <typename BaseType>
 int BigIntegerBase<BaseType>::compare (const BigIntegerBase<BaseType>& rhs) const
 {
@@ -591,116 +1682,453 @@ int BigIntegerBase<BaseType>::compare (const BigIntegerBase<BaseType>& rhs) cons
 	}
 	else
 	{
-		for (int i = mySize - 1; i >= 0; --i)
+		return Limbs::compareN (_bigNumber.data (), rhs._bigNumber.data (), mySize) * modificator;
+	}
+}
+
+template <typename BaseType>
+void BigIntegerBase<BaseType>::cleanLeadingZeroes ()
+{
+	_bigNumber.resize (getRealSize ());
+}
+
+template <typename BaseType>
+unsigned int BigIntegerBase<BaseType>::getRealSize () const
+{
+	return Limbs::normalizedSize (_bigNumber.data (), _bigNumber.size ());
+}
+
+template <typename BaseType>
+void BigIntegerBase<BaseType>::insertIntoStream (std::ostream& os) const
+{
+	os << "BigInteger ( ";
+	if (!_isPositive)
+	{
+		os << "-";
+	}
+	for (int i = _bigNumber.size() - 1; i >= 0; i--)
+	{
+		os << std::hex << (unsigned long long) _bigNumber[i] << " ";
+	}
+	os << std::dec << ")";
+}
+
+template <typename BaseType>
+void BigIntegerBase<BaseType>::importLimbs (const void* data, size_t wordCount, size_t wordSize, WordOrder wordOrder,
+		ByteOrder byteOrder, bool isNegative)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*> (data);
+	size_t byteCount = wordCount * wordSize;
+	bool littleEndianWords = hasLittleEndianWords (byteOrder);
+	_bigNumber.assign ((byteCount + sizeof(BaseType) - 1) / sizeof(BaseType), 0);
+	if ((wordOrder == WordOrder::LeastSignificantFirst) && littleEndianWords && isLittleEndianHost ())
+	{
+		// the input has the memory layout of the limbs already
+		if (byteCount > 0)
 		{
-			if (_bigNumber[i] < rhs._bigNumber[i])
-			{
-				return -1 * modificator;
-			}
-			else if (_bigNumber[i] > rhs._bigNumber[i])
+			std::memcpy (_bigNumber.data (), bytes, byteCount);
+		}
+	}
+	else
+	{
+		for (size_t word = 0; word < wordCount; ++word)
+		{
+			const unsigned char* source = bytes + ((wordOrder == WordOrder::LeastSignificantFirst) ? word : wordCount - 1 - word) * wordSize;
+			for (size_t byte = 0; byte < wordSize; ++byte)
 			{
-				return 1 * modificator;
+				BaseType value = source[littleEndianWords ? byte : wordSize - 1 - byte];
+				size_t position = word * wordSize + byte;
+				_bigNumber[position / sizeof(BaseType)] |= (BaseType) (value << (8 * (position % sizeof(BaseType))));
 			}
 		}
-		return 0;
 	}
+	cleanLeadingZeroes ();
+	_isPositive = !isNegative || _bigNumber.empty ();
 }
 
 template <typename BaseType>
-void BigIntegerBase<BaseType>::cleanLeadingZeroes ()
+size_t BigIntegerBase<BaseType>::exportLimbs (void* data, size_t wordSize, WordOrder wordOrder, ByteOrder byteOrder) const
 {
-	for (int i = _bigNumber.size () - 1; i >= 0; i--)
+	unsigned char* bytes = static_cast<unsigned char*> (data);
+	size_t wordCount = exportWordCount (wordSize);
+	size_t byteCount = wordCount * wordSize;
+	size_t limbBytes = getRealSize () * sizeof(BaseType);
+	bool littleEndianWords = hasLittleEndianWords (byteOrder);
+	if ((wordOrder == WordOrder::LeastSignificantFirst) && littleEndianWords && isLittleEndianHost ())
 	{
-		if (_bigNumber[i] == 0)
+		size_t copied = std::min (byteCount, limbBytes);
+		if (copied > 0)
 		{
-			_bigNumber.erase (_bigNumber.begin () + i);
+			std::memcpy (bytes, _bigNumber.data (), copied);
 		}
-		else
+		std::fill (bytes + copied, bytes + byteCount, 0);
+		return wordCount;
+	}
+	for (size_t word = 0; word < wordCount; ++word)
+	{
+		unsigned char* target = bytes + ((wordOrder == WordOrder::LeastSignificantFirst) ? word : wordCount - 1 - word) * wordSize;
+		for (size_t byte = 0; byte < wordSize; ++byte)
 		{
-			// if an entry != 0 is encountered, the erasing has to stop
-			return;
+			size_t position = word * wordSize + byte;
+			unsigned char value = 0;
+			if (position < limbBytes)
+			{
+				value = (unsigned char) (_bigNumber[position / sizeof(BaseType)] >> (8 * (position % sizeof(BaseType))));
+			}
+			target[littleEndianWords ? byte : wordSize - 1 - byte] = value;
 		}
 	}
+	return wordCount;
 }
 
 template <typename BaseType>
-unsigned int BigIntegerBase<BaseType>::getRealSize () const
+std::string BigIntegerBase<BaseType>::asString (int base) const
 {
-	int vectorSize = _bigNumber.size ();
-	for (int i = vectorSize - 1; i >= 0; i--)
+	if ((base < 2) || (base > 36))
+	{
+		throw std::invalid_argument("BigIntegerBase::asString: the base has to be between 2 and 36");
+	}
+	std::string result (maxDigits (bitLength (), base) + 1, '0');
+	ToCharsResult written = toChars (&result[0], &result[0] + result.size (), base);
+	result.resize (written.ptr - &result[0]);
+	return result;
+}
+
+template <typename BaseType>
+ToCharsResult BigIntegerBase<BaseType>::toChars (char* first, char* last, int base) const
+{
+	UTILITIES_INSTRUMENT_OPERATION (ToString, getRealSize ());
+	if ((base < 2) || (base > 36))
+	{
+		return ToCharsResult {first, std::errc::invalid_argument};
+	}
+	const ToCharsResult tooLarge {last, std::errc::value_too_large};
+	size_t size = getRealSize ();
+	char* out = first;
+	if (size == 0)
+	{
+		if (out == last)
+		{
+			return tooLarge;
+		}
+		*out++ = '0';
+		return ToCharsResult {out, std::errc ()};
+	}
+	if (!_isPositive)
+	{
+		if (out == last)
+		{
+			return tooLarge;
+		}
+		*out++ = '-';
+	}
+	size_t available = last - out;
+	unsigned int bits = radixBits (base);
+	char* end = nullptr;
+	if (bits != 0)
 	{
-		if (_bigNumber[i] != 0)
+		if ((bitLength () + bits - 1) / bits > available)
 		{
-			return i + 1;
+			return tooLarge;
 		}
+		end = writeDigitsPowerOfTwo (_bigNumber.data (), size, out, bits);
 	}
-	return 0;
+	else if (available >= maxDigits (bitLength (), base))
+	{
+		end = writeDigits (_bigNumber.data (), size, out, 0, base);
+	}
+	else
+	{
+		// the digits may fit anyway, they are padded to the whole buffer and the leading zeroes are removed
+		end = (available > 0) ? writeDigits (_bigNumber.data (), size, out, available, base) : nullptr;
+		if (end == nullptr)
+		{
+			return tooLarge;
+		}
+		char* digits = out;
+		while (*digits == '0')
+		{
+			++digits;
+		}
+		end = std::copy (digits, end, out);
+	}
+	return ToCharsResult {end, std::errc ()};
 }
 
 template <typename BaseType>
-void BigIntegerBase<BaseType>::insertIntoStream (std::ostream& os) const
+FromCharsResult BigIntegerBase<BaseType>::fromChars (const char* first, const char* last, int base)
 {
-	os << "BigInteger ( ";
-	if (!_isPositive)
+	// the characters, the limbs are not known yet
+	UTILITIES_INSTRUMENT_OPERATION (FromString, last - first);
+	if ((base < 2) || (base > 36))
 	{
-		os << "-";
+		return FromCharsResult {first, std::errc::invalid_argument};
 	}
-	for (int i = _bigNumber.size() - 1; i >= 0; i--)
+	const char* digits = first;
+	bool isNegative = (digits != last) && (*digits == '-');
+	if (isNegative)
 	{
-		os << std::hex << (unsigned int) _bigNumber[i] << " ";
+		++digits;
 	}
-	os << std::dec << ")";
+	const char* end = digits;
+	while ((end != last) && (digitValue (*end, base) < (unsigned int) base))
+	{
+		++end;
+	}
+	if (end == digits)
+	{
+		return FromCharsResult {first, std::errc::invalid_argument};
+	}
+	unsigned int bits = radixBits (base);
+	if (bits != 0)
+	{
+		parseDigitsPowerOfTwo (_bigNumber, digits, end - digits, bits);
+	}
+	else
+	{
+		parseDigits (_bigNumber, digits, end - digits, base);
+	}
+	if (_bigNumber.empty ())
+	{
+		_bigNumber.push_back (0);
+	}
+	_isPositive = !isNegative || (getRealSize () == 0);
+	return FromCharsResult {end, std::errc ()};
 }
 
 template <typename BaseType>
-BaseType divideBy10 (std::vector<BaseType>& num)
+BaseType BigIntegerBase<BaseType>::radixChunkPower (unsigned int base, unsigned int& chunkDigits)
 {
-	typename std::vector<BaseType>::size_type vecSize = num.size();
-	if (vecSize == 0)
+	const BaseType limit = std::numeric_limits<BaseType>::max () / base;
+	BaseType power = (BaseType) base;
+	chunkDigits = 1;
+	while (power <= limit)
 	{
-		return 0;
+		power *= base;
+		++chunkDigits;
 	}
-	BaseType currentVal = 0;
-	BaseType currentRest = 0;
-	BaseType carryRest = 0;
-	BaseType temp = 0;
-	bool killLast = num[vecSize - 1] < 10;
-	for (int i = vecSize - 1; i >= 0; --i)
+	return power;
+}
+
+template <typename BaseType>
+const BigIntegerBase<BaseType>& BigIntegerBase<BaseType>::radixPower (unsigned int base, size_t index)
+{
+	// a deque keeps the references valid while more powers are appended
+	static thread_local std::deque<BigIntegerBase<BaseType> > powers[37];
+	// the powers outlive any arena of the caller
+	ScopedLimbArena heap (nullptr);
+	std::deque<BigIntegerBase<BaseType> >& basePowers = powers[base];
+	if (basePowers.empty ())
 	{
-		temp = carryRest * 6;
-		currentVal = (num[i] / 10) + (carryRest * 25) + (temp / 10);
-		currentRest = (num[i] % 10) + (temp % 10);
-		num[i] = currentVal + currentRest / 10;
-		carryRest = currentRest % 10;
+		unsigned int chunkDigits;
+		BigIntegerBase<BaseType> chunkPower;
+		chunkPower.setFromNumber (radixChunkPower (base, chunkDigits));
+		basePowers.push_back (chunkPower);
 	}
-	if (killLast)
+	while (basePowers.size () <= index)
 	{
-		num.pop_back();
+		basePowers.push_back (basePowers.back ().square ());
 	}
-	return carryRest;
+	return basePowers[index];
 }
 
 template <typename BaseType>
-std::string BigIntegerBase<BaseType>::asString () const
+char* BigIntegerBase<BaseType>::writeDigits (const BaseType* limbs, size_t size, char* out, size_t width, unsigned int base)
 {
-	std::string result;
-	std::vector<BaseType> temp = _bigNumber;
-	BaseType rest;
+	if ((size < 2) || (size < BigIntegerTuning<BaseType>::decimalConversionThreshold))
+	{
+		return writeDigitsBasecase (limbs, size, out, width, base);
+	}
+	// the power has at most half of the limbs, so it is below the number and the quotient is not empty
+	size_t index = 0;
+	while (2 * radixPower (base, index + 1).getRealSize () <= size + 1)
+	{
+		++index;
+	}
+	const BigIntegerBase<BaseType>& power = radixPower (base, index);
+	LimbStorage<BaseType> quotient;
+	LimbStorage<BaseType> remainder;
+	divideMagnitudes (limbs, size, power._bigNumber.data (), power.getRealSize (), quotient, remainder);
+
+	unsigned int chunkDigits;
+	radixChunkPower (base, chunkDigits);
+	size_t lowWidth = (size_t) chunkDigits << index;
+	if (width == 0)
+	{
+		out = writeDigits (quotient.data (), quotient.size (), out, 0, base);
+	}
+	else if (width > lowWidth)
+	{
+		out = writeDigits (quotient.data (), quotient.size (), out, width - lowWidth, base);
+	}
+	else
+	{
+		out = nullptr;
+	}
+	if (out == nullptr)
+	{
+		return nullptr;
+	}
+	return writeDigits (remainder.data (), remainder.size (), out, lowWidth, base);
+}
 
-	while (temp.size() > 0)
+template <typename BaseType>
+char* BigIntegerBase<BaseType>::writeDigitsBasecase (const BaseType* limbs, size_t size, char* out, size_t width, unsigned int base)
+{
+	// chunks of chunkDigits digits, the lowest first
+	unsigned int chunkDigits;
+	BaseType chunkPower = radixChunkPower (base, chunkDigits);
+	LimbStorage<BaseType, _conversionInlineBytes / sizeof(BaseType)> temp (limbs, limbs + size);
+	LimbStorage<BaseType, _conversionInlineBytes / sizeof(BaseType)> chunks;
+	while (size > 0)
 	{
-		rest = divideBy10 (temp);
-		result.insert(result.begin(), rest + '0');
+		chunks.push_back (Limbs::divRemLimb (temp.data (), temp.data (), size, chunkPower));
+		size = Limbs::normalizedSize (temp.data (), size);
 	}
-	if (!this->_isPositive)
+	if (width == 0)
 	{
-		result.insert(result.begin(), '-');
+		// all chunks but the top one have all digits
+		width = 1;
+		if (!chunks.empty ())
+		{
+			width += (chunks.size () - 1) * chunkDigits;
+			for (BaseType top = chunks.back () / base; top > 0; top /= base)
+			{
+				++width;
+			}
+		}
 	}
+	// the digits are filled in from the end of the known width, missing ones are leading zeroes
+	char* end = out + width;
+	char* position = end;
+	for (size_t i = 0; i < chunks.size (); ++i)
+	{
+		BaseType chunk = chunks[i];
+		for (unsigned int digit = 0; (digit < chunkDigits) && (position > out); ++digit)
+		{
+			*--position = digitChar (chunk % base);
+			chunk /= base;
+		}
+		if (position == out)
+		{
+			// the width is used up, all digits left have to be zero
+			while ((chunk == 0) && (++i < chunks.size ()))
+			{
+				chunk = chunks[i];
+			}
+			if (chunk != 0)
+			{
+				return nullptr;
+			}
+			break;
+		}
+	}
+	std::fill (out, position, '0');
+	return end;
+}
 
-	return result;
+template <typename BaseType>
+char* BigIntegerBase<BaseType>::writeDigitsPowerOfTwo (const BaseType* limbs, size_t size, char* out, unsigned int radixBits)
+{
+	size_t bitCount = size * Limbs::bits - Limbs::leadingZeros (limbs[size - 1]);
+	size_t count = (bitCount + radixBits - 1) / radixBits;
+	const unsigned long long mask = (1ULL << radixBits) - 1;
+	for (size_t i = 0; i < count; ++i)
+	{
+		// digit i from the top, its bits may reach into the next limb
+		size_t position = (count - 1 - i) * radixBits;
+		size_t limb = position / Limbs::bits;
+		unsigned int offset = position % Limbs::bits;
+		unsigned long long value = (unsigned long long) limbs[limb] >> offset;
+		if ((offset + radixBits > Limbs::bits) && (limb + 1 < size))
+		{
+			value |= (unsigned long long) limbs[limb + 1] << (Limbs::bits - offset);
+		}
+		out[i] = digitChar ((unsigned int) (value & mask));
+	}
+	return out + count;
 }
 
+template <typename BaseType>
+void BigIntegerBase<BaseType>::parseDigits (LimbStorage<BaseType>& result, const char* digits, size_t count, unsigned int base)
+{
+	unsigned int chunkDigits;
+	radixChunkPower (base, chunkDigits);
+	if (count <= BigIntegerTuning<BaseType>::decimalConversionThreshold * chunkDigits)
+	{
+		// every chunk is below the limb base, so there are never more limbs than chunks
+		result.assign (count / chunkDigits + 1, 0);
+		size_t size = 0;
+		// the first chunk takes the odd digits, so all following ones are complete
+		size_t chunkLength = count % chunkDigits;
+		if (chunkLength == 0)
+		{
+			chunkLength = chunkDigits;
+		}
+		for (size_t position = 0; position < count; position += chunkLength, chunkLength = chunkDigits)
+		{
+			BaseType chunk = 0;
+			BaseType multiplier = 1;
+			for (size_t i = 0; i < chunkLength; ++i)
+			{
+				chunk = chunk * base + (BaseType) digitValue (digits[position + i], base);
+				multiplier *= base;
+			}
+			BaseType carry = chunk;
+			if (size > 0)
+			{
+				carry = Limbs::mulLimb (result.data (), result.data (), size, multiplier);
+				carry += Limbs::addLimb (result.data (), result.data (), size, chunk);
+			}
+			if (carry != 0)
+			{
+				result[size++] = carry;
+			}
+		}
+		result.resize (size);
+		return;
+	}
+	// the lower part gets a power of two number of chunks, at least half of the digits
+	size_t index = 0;
+	while (((size_t) chunkDigits << (index + 1)) < count)
+	{
+		++index;
+	}
+	size_t lowCount = (size_t) chunkDigits << index;
+	LimbStorage<BaseType> high;
+	LimbStorage<BaseType> low;
+	parseDigits (high, digits, count - lowCount, base);
+	parseDigits (low, digits + count - lowCount, lowCount, base);
+	if (high.empty ())
+	{
+		result.swap (low);
+		return;
+	}
+	const BigIntegerBase<BaseType>& power = radixPower (base, index);
+	multiplyMagnitudes (result, high.data (), high.size (), power._bigNumber.data (), power.getRealSize ());
+	// high * power + low is below (high + 1) * power, so there is no carry out of the product size
+	Limbs::add (result.data (), result.data (), result.size (), low.data (), low.size ());
+	result.resize (Limbs::normalizedSize (result.data (), result.size ()));
+}
 
+template <typename BaseType>
+void BigIntegerBase<BaseType>::parseDigitsPowerOfTwo (LimbStorage<BaseType>& result, const char* digits, size_t count, unsigned int radixBits)
+{
+	result.assign ((count * radixBits + Limbs::bits - 1) / Limbs::bits, 0);
+	for (size_t i = 0; i < count; ++i)
+	{
+		size_t position = (count - 1 - i) * radixBits;
+		size_t limb = position / Limbs::bits;
+		unsigned int offset = position % Limbs::bits;
+		unsigned long long value = digitValue (digits[i], 1U << radixBits);
+		result[limb] |= (BaseType) (value << offset);
+		if (offset + radixBits > Limbs::bits)
+		{
+			result[limb + 1] |= (BaseType) (value >> (Limbs::bits - offset));
+		}
+	}
+	result.resize (Limbs::normalizedSize (result.data (), result.size ()));
+}
 }
 
 
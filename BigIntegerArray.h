@@ -0,0 +1,261 @@
+/*
+ * BigIntegerArray.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "BigInteger.h"
+
+namespace Utilities
+{
+
+/**
+ * Binary file format for arrays of big integers. All fields are little endian 64 bit words:
+ *   - the magic "BIGINTAR" and the number of entries
+ *   - per entry the offset of its first word from the start of the file and its word count, the top bit
+ *     of the word count is the sign
+ *   - the words of all numbers, least significant first
+ * Every number is 8 byte aligned, so a mapped file can be used in place.
+ */
+struct BigIntegerArrayFormat
+{
+	static const char* magic ()
+	{
+		return "BIGINTAR";
+	}
+
+	static const std::uint64_t negativeFlag = 1ULL << 63;
+
+	/// words before the index
+	static const std::size_t headerWords = 2;
+
+	static std::uint64_t readWord (const unsigned char* bytes)
+	{
+		std::uint64_t word = 0;
+		for (int i = 7; i >= 0; --i)
+		{
+			word = (word << 8) | bytes[i];
+		}
+		return word;
+	}
+
+	static void writeWord (std::ostream& out, std::uint64_t word)
+	{
+		unsigned char bytes[8];
+		for (int i = 0; i < 8; ++i)
+		{
+			bytes[i] = (unsigned char) (word >> (8 * i));
+		}
+		out.write (reinterpret_cast<const char*> (bytes), 8);
+	}
+};
+
+/**
+ * writes count numbers in the BigIntegerArrayFormat, the stream should be opened in binary mode
+ */
+template <typename BaseType>
+void writeBigIntegerArray (std::ostream& out, const BigIntegerBase<BaseType>* numbers, std::size_t count)
+{
+	typedef BigIntegerArrayFormat Format;
+	out.write (Format::magic (), 8);
+	Format::writeWord (out, count);
+	std::uint64_t offset = Format::headerWords + 2 * count;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		std::uint64_t wordCount = numbers[i].exportWordCount (8);
+		Format::writeWord (out, offset);
+		Format::writeWord (out, wordCount | (numbers[i].isPositive () ? 0 : Format::negativeFlag));
+		offset += wordCount;
+	}
+	std::vector<unsigned char> buffer;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		buffer.resize (numbers[i].exportWordCount (8) * 8);
+		numbers[i].exportLimbs (buffer.data (), 8, WordOrder::LeastSignificantFirst, ByteOrder::Little);
+		out.write (reinterpret_cast<const char*> (buffer.data ()), buffer.size ());
+	}
+}
+
+template <typename BaseType>
+void writeBigIntegerArray (std::ostream& out, const std::vector<BigIntegerBase<BaseType> >& numbers)
+{
+	writeBigIntegerArray (out, numbers.data (), numbers.size ());
+}
+
+/**
+ * One number of a BigIntegerArrayView, it points into the viewed memory and owns nothing.
+ */
+class BigIntegerWordsView
+{
+public:
+	BigIntegerWordsView (const unsigned char* words, std::size_t wordCount, bool isNegative)
+		: _words(words), _wordCount(wordCount), _isNegative(isNegative)
+	{
+	}
+
+	std::size_t getWordCount () const
+	{
+		return _wordCount;
+	}
+
+	bool isNegative () const
+	{
+		return _isNegative;
+	}
+
+	/// the 64 bit word with the given index, the lowest first
+	std::uint64_t getWord (std::size_t index) const
+	{
+		return BigIntegerArrayFormat::readWord (_words + 8 * index);
+	}
+
+	/// the raw little endian words
+	const unsigned char* data () const
+	{
+		return _words;
+	}
+
+	template <typename BaseType>
+	BigIntegerBase<BaseType> toBigInteger () const
+	{
+		BigIntegerBase<BaseType> result;
+		result.importLimbs (_words, _wordCount, 8, WordOrder::LeastSignificantFirst, ByteOrder::Little, _isNegative);
+		return result;
+	}
+
+private:
+	const unsigned char* _words;
+	std::size_t _wordCount;
+	bool _isNegative;
+};
+
+/**
+ * Read only access to numbers in the BigIntegerArrayFormat, e.g. in a MappedFile. Only the header is
+ * checked up front, every entry is checked when it is accessed. The memory has to outlive the view.
+ */
+class BigIntegerArrayView
+{
+public:
+	/// throws std::runtime_error if the memory does not start with a valid header
+	BigIntegerArrayView (const void* data, std::size_t size) : _bytes(static_cast<const unsigned char*> (data)), _size(size)
+	{
+		typedef BigIntegerArrayFormat Format;
+		if ((_size < 8 * Format::headerWords) || (std::memcmp (_bytes, Format::magic (), 8) != 0))
+		{
+			throw std::runtime_error("BigIntegerArrayView: no big integer array");
+		}
+		_count = Format::readWord (_bytes + 8);
+		if (_count > (_size / 8 - Format::headerWords) / 2)
+		{
+			throw std::runtime_error("BigIntegerArrayView: index is truncated");
+		}
+	}
+
+	std::size_t size () const
+	{
+		return _count;
+	}
+
+	/// throws std::out_of_range for a bad index or an entry pointing outside of the memory
+	BigIntegerWordsView operator[] (std::size_t index) const
+	{
+		typedef BigIntegerArrayFormat Format;
+		if (index >= _count)
+		{
+			throw std::out_of_range("BigIntegerArrayView: index out of range");
+		}
+		const unsigned char* entry = _bytes + 8 * (Format::headerWords + 2 * index);
+		std::uint64_t offset = Format::readWord (entry);
+		std::uint64_t wordCount = Format::readWord (entry + 8);
+		bool isNegative = (wordCount & Format::negativeFlag) != 0;
+		wordCount &= ~Format::negativeFlag;
+		std::uint64_t totalWords = _size / 8;
+		if ((offset > totalWords) || (wordCount > totalWords - offset))
+		{
+			throw std::out_of_range("BigIntegerArrayView: entry outside of the data");
+		}
+		return BigIntegerWordsView (_bytes + 8 * offset, wordCount, isNegative);
+	}
+
+private:
+	const unsigned char* _bytes;
+	std::size_t _size;
+	std::size_t _count;
+};
+
+/**
+ * A file mapped read only into memory for the lifetime of the object.
+ */
+class MappedFile
+{
+public:
+	/// throws std::runtime_error if the file cannot be opened or mapped
+	explicit MappedFile (const std::string& path) : _data(nullptr), _size(0)
+	{
+		int descriptor = ::open (path.c_str (), O_RDONLY);
+		if (descriptor < 0)
+		{
+			throw std::runtime_error("MappedFile: cannot open " + path);
+		}
+		struct stat status;
+		if (::fstat (descriptor, &status) != 0)
+		{
+			::close (descriptor);
+			throw std::runtime_error("MappedFile: cannot stat " + path);
+		}
+		_size = (std::size_t) status.st_size;
+		if (_size > 0)
+		{
+			void* mapping = ::mmap (nullptr, _size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+			if (mapping == MAP_FAILED)
+			{
+				::close (descriptor);
+				throw std::runtime_error("MappedFile: cannot map " + path);
+			}
+			_data = mapping;
+		}
+		// the mapping stays valid without the descriptor
+		::close (descriptor);
+	}
+
+	MappedFile (const MappedFile&) = delete;
+	MappedFile& operator= (const MappedFile&) = delete;
+
+	~MappedFile ()
+	{
+		if (_data != nullptr)
+		{
+			::munmap (_data, _size);
+		}
+	}
+
+	const void* data () const
+	{
+		return _data;
+	}
+
+	std::size_t size () const
+	{
+		return _size;
+	}
+
+private:
+	void* _data;
+	std::size_t _size;
+};
+
+}
@@ -0,0 +1,467 @@
+/*
+ * BigIntegerBatch.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include "BigInteger.h"
+#include "LimbStorage.h"
+#include "LimbVectorArithmetic.h"
+
+namespace Utilities
+{
+
+/**
+ * Many non negative numbers with the same number of 64 bit limbs in structure of arrays layout: limb i of
+ * all numbers is one contiguous row, so the kernels handle one number per vector lane and the carries of
+ * different numbers never interact. Like FixedBigInteger the numbers wrap around modulo 2^(64 limbCount).
+ * The rows are padded to whole vectors with zero numbers, the kernels work on the padding as well.
+ */
+class BigIntegerBatch
+{
+public:
+	/// size numbers of limbCount limbs, all zero
+	BigIntegerBatch (std::size_t size, std::size_t limbCount)
+		: _size(size), _limbCount(limbCount), _stride((size + maxLanes - 1) / maxLanes * maxLanes),
+		  _limbs(_stride * limbCount, 0)
+	{
+	}
+
+	std::size_t size () const
+	{
+		return _size;
+	}
+
+	std::size_t getLimbCount () const
+	{
+		return _limbCount;
+	}
+
+	/// the limbs with the given index of all numbers, the one of number i at position i
+	std::uint64_t* row (std::size_t limb)
+	{
+		return _limbs.data () + limb * _stride;
+	}
+
+	const std::uint64_t* row (std::size_t limb) const
+	{
+		return _limbs.data () + limb * _stride;
+	}
+
+	/// throws std::out_of_range for a bad index and std::domain_error for a negative or too large number
+	template <typename BaseType>
+	void set (std::size_t index, const BigIntegerBase<BaseType>& number)
+	{
+		checkIndex (index);
+		if (!number.isPositive () && (number.bitLength () > 0))
+		{
+			throw std::domain_error("BigIntegerBatch: negative number");
+		}
+		if (number.exportWordCount (sizeof(std::uint64_t)) > _limbCount)
+		{
+			throw std::domain_error("BigIntegerBatch: number too large");
+		}
+		LimbStorage<std::uint64_t> limbs (_limbCount);
+		number.exportLimbs (limbs.data (), sizeof(std::uint64_t));
+		for (std::size_t limb = 0; limb < _limbCount; ++limb)
+		{
+			row (limb)[index] = limbs[limb];
+		}
+	}
+
+	/// throws std::out_of_range for a bad index
+	template <typename BaseType>
+	BigIntegerBase<BaseType> get (std::size_t index) const
+	{
+		checkIndex (index);
+		LimbStorage<std::uint64_t> limbs (_limbCount);
+		for (std::size_t limb = 0; limb < _limbCount; ++limb)
+		{
+			limbs[limb] = row (limb)[index];
+		}
+		BigIntegerBase<BaseType> result;
+		result.importLimbs (limbs.data (), _limbCount, sizeof(std::uint64_t));
+		return result;
+	}
+
+	/**
+	 * result = a + b for every number, result may be a or b. With carries, the carry out of every number
+	 * is written there.
+	 */
+	static void add (BigIntegerBatch& result, const BigIntegerBatch& a, const BigIntegerBatch& b, std::uint64_t* carries = nullptr)
+	{
+		checkShapes (result, a, b);
+		run<AddKernel> (result, a, b, carries);
+	}
+
+	/// result = a - b for every number, with borrows the borrow out of every number is written there
+	static void sub (BigIntegerBatch& result, const BigIntegerBatch& a, const BigIntegerBatch& b, std::uint64_t* borrows = nullptr)
+	{
+		checkShapes (result, a, b);
+		run<SubKernel> (result, a, b, borrows);
+	}
+
+	/// result = a * limb for every number, with highLimbs the limb shifted out of every number is written there
+	static void mulLimb (BigIntegerBatch& result, const BigIntegerBatch& a, std::uint64_t limb, std::uint64_t* highLimbs = nullptr)
+	{
+		checkShapes (result, a, a);
+		run<MulLimbKernel> (result, a, limb, highLimbs);
+	}
+
+	/// results[i] is -1, 0 or 1 as number i of a is less than, equal to or greater than number i of b
+	static void compare (const BigIntegerBatch& a, const BigIntegerBatch& b, int* results)
+	{
+		checkShapes (a, a, b);
+		run<CompareKernel> (a, b, results);
+	}
+
+	/**
+	 * result = a mod modulus for every number by shifted subtractions of the modulus, only as many as the
+	 * largest numbers need. Throws std::domain_error if the modulus is not positive or does not fit into
+	 * the limbs.
+	 */
+	template <typename BaseType>
+	static void reduce (BigIntegerBatch& result, const BigIntegerBatch& a, const BigIntegerBase<BaseType>& modulus)
+	{
+		checkShapes (result, a, a);
+		if (!modulus.isPositive () || (modulus.bitLength () == 0))
+		{
+			throw std::domain_error("BigIntegerBatch::reduce: the modulus has to be positive");
+		}
+		if (modulus.exportWordCount (sizeof(std::uint64_t)) > a._limbCount)
+		{
+			throw std::domain_error("BigIntegerBatch::reduce: the modulus does not fit into the limbs");
+		}
+		LimbStorage<std::uint64_t> modulusLimbs (a._limbCount);
+		modulus.exportLimbs (modulusLimbs.data (), sizeof(std::uint64_t));
+		run<ReduceKernel> (result, a, modulusLimbs.data (), modulus.bitLength ());
+	}
+
+private:
+	/// lanes of the widest vectors, the rows are padded to a multiple of them
+	static const std::size_t maxLanes = 8;
+
+	/// numbers reduced together, their limbs stay in the first level cache for all shifts of the modulus
+	static const std::size_t reduceGroup = 256;
+
+	std::size_t _size;
+	std::size_t _limbCount;
+	std::size_t _stride;
+	std::vector<std::uint64_t> _limbs;
+
+	void checkIndex (std::size_t index) const
+	{
+		if (index >= _size)
+		{
+			throw std::out_of_range("BigIntegerBatch: index out of range");
+		}
+	}
+
+	static void checkShapes (const BigIntegerBatch& result, const BigIntegerBatch& a, const BigIntegerBatch& b)
+	{
+		if ((result._size != a._size) || (a._size != b._size) || (result._limbCount != a._limbCount) || (a._limbCount != b._limbCount))
+		{
+			throw std::invalid_argument("BigIntegerBatch: the batches differ in size");
+		}
+	}
+
+	/**
+	 * The kernels are written once for GCC vector types of one, four or eight 64 bit lanes. The runners
+	 * inline them into functions compiled for AVX2 or AVX-512, so every instruction set gets its own code
+	 * from the same source. Comparisons of vectors give lanes of all ones or zero, so a carry is subtracted
+	 * to add 1.
+	 */
+	typedef std::uint64_t Lanes1 __attribute__((vector_size(8)));
+	typedef std::uint64_t Lanes4 __attribute__((vector_size(32)));
+	typedef std::uint64_t Lanes8 __attribute__((vector_size(64)));
+
+	template <template <typename> class Kernel, typename... Arguments>
+	static void run (Arguments&&... arguments)
+	{
+#if defined(UTILITIES_VECTOR_LIMBS)
+		if (LimbVectorArithmetic::level () == LimbVectorArithmetic::Avx512)
+		{
+			run512<Kernel> (arguments...);
+			return;
+		}
+		if (LimbVectorArithmetic::level () == LimbVectorArithmetic::Avx2)
+		{
+			run256<Kernel> (arguments...);
+			return;
+		}
+#endif
+		Kernel<Lanes1>::run (arguments...);
+	}
+
+#if defined(UTILITIES_VECTOR_LIMBS)
+	template <template <typename> class Kernel, typename... Arguments>
+	__attribute__((target("avx2")))
+	static void run256 (Arguments&... arguments)
+	{
+		Kernel<Lanes4>::run (arguments...);
+	}
+
+	template <template <typename> class Kernel, typename... Arguments>
+	__attribute__((target("avx512f")))
+	static void run512 (Arguments&... arguments)
+	{
+		Kernel<Lanes8>::run (arguments...);
+	}
+#endif
+
+	template <typename Vector>
+	struct Lanes
+	{
+		static const std::size_t count = sizeof(Vector) / sizeof(std::uint64_t);
+
+		// vectors are passed by reference, as values they would need the vector registers in the interface
+		__attribute__((always_inline))
+		static inline void load (Vector& target, const std::uint64_t* source)
+		{
+			std::memcpy (&target, source, sizeof(Vector));
+		}
+
+		__attribute__((always_inline))
+		static inline void store (std::uint64_t* target, const Vector& value)
+		{
+			std::memcpy (target, &value, sizeof(Vector));
+		}
+	};
+
+	template <typename Vector>
+	struct AddKernel
+	{
+		__attribute__((always_inline))
+		static inline void run (BigIntegerBatch& result, const BigIntegerBatch& a, const BigIntegerBatch& b, std::uint64_t* carries)
+		{
+			typedef Lanes<Vector> L;
+			for (std::size_t i = 0; i < a._stride; i += L::count)
+			{
+				Vector carry = {};
+				for (std::size_t limb = 0; limb < a._limbCount; ++limb)
+				{
+					Vector x, y;
+					L::load (x, a.row (limb) + i);
+					L::load (y, b.row (limb) + i);
+					Vector sum = x + y;
+					Vector generated = (Vector) (sum < x);
+					Vector total = sum - carry;
+					carry = generated | (Vector) (total < sum);
+					L::store (result.row (limb) + i, total);
+				}
+				storeFlags<Vector> (carries, i, a._size, carry);
+			}
+		}
+	};
+
+	template <typename Vector>
+	struct SubKernel
+	{
+		__attribute__((always_inline))
+		static inline void run (BigIntegerBatch& result, const BigIntegerBatch& a, const BigIntegerBatch& b, std::uint64_t* borrows)
+		{
+			typedef Lanes<Vector> L;
+			for (std::size_t i = 0; i < a._stride; i += L::count)
+			{
+				Vector borrow = {};
+				for (std::size_t limb = 0; limb < a._limbCount; ++limb)
+				{
+					Vector x, y;
+					L::load (x, a.row (limb) + i);
+					L::load (y, b.row (limb) + i);
+					Vector difference = x - y;
+					Vector generated = (Vector) (x < difference);
+					Vector total = difference + borrow;
+					borrow = generated | (Vector) (difference < total);
+					L::store (result.row (limb) + i, total);
+				}
+				storeFlags<Vector> (borrows, i, a._size, borrow);
+			}
+		}
+	};
+
+	/// the 128 bit products are put together from four 32 bit products, which all vector units have
+	template <typename Vector>
+	struct MulLimbKernel
+	{
+		__attribute__((always_inline))
+		static inline void run (BigIntegerBatch& result, const BigIntegerBatch& a, std::uint64_t limb, std::uint64_t* highLimbs)
+		{
+			typedef Lanes<Vector> L;
+			const Vector lowMask = Vector {} + 0xFFFFFFFFULL;
+			const Vector factorLow = Vector {} + (limb & 0xFFFFFFFFULL);
+			const Vector factorHigh = Vector {} + (limb >> 32);
+			for (std::size_t i = 0; i < a._stride; i += L::count)
+			{
+				Vector carry = {};
+				for (std::size_t index = 0; index < a._limbCount; ++index)
+				{
+					Vector x;
+					L::load (x, a.row (index) + i);
+					Vector xLow = x & lowMask;
+					Vector xHigh = x >> 32;
+					Vector lowLow = xLow * factorLow;
+					Vector lowHigh = xLow * factorHigh;
+					Vector highLow = xHigh * factorLow;
+					Vector middle = (lowLow >> 32) + (lowHigh & lowMask) + (highLow & lowMask);
+					Vector low = (lowLow & lowMask) | (middle << 32);
+					Vector high = xHigh * factorHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+					low += carry;
+					carry = high - (Vector) (low < carry);
+					L::store (result.row (index) + i, low);
+				}
+				if (highLimbs != nullptr)
+				{
+					storeLanes<Vector> (highLimbs, i, a._size, carry);
+				}
+			}
+		}
+	};
+
+	/// from the top limb down, every lane keeps the result of its first differing limb
+	template <typename Vector>
+	struct CompareKernel
+	{
+		__attribute__((always_inline))
+		static inline void run (const BigIntegerBatch& a, const BigIntegerBatch& b, int* results)
+		{
+			typedef Lanes<Vector> L;
+			for (std::size_t i = 0; i < a._stride; i += L::count)
+			{
+				Vector less = {};
+				Vector greater = {};
+				for (std::size_t limb = a._limbCount; limb-- > 0;)
+				{
+					Vector x;
+					L::load (x, a.row (limb) + i);
+					Vector y;
+					L::load (y, b.row (limb) + i);
+					Vector undecided = ~(less | greater);
+					less |= undecided & (Vector) (x < y);
+					greater |= undecided & (Vector) (y < x);
+				}
+				// the masks are all ones for -1, so less - greater is -1 for less and 1 for greater
+				Vector comparison = less - greater;
+				for (std::size_t lane = 0; (lane < L::count) && (i + lane < a._size); ++lane)
+				{
+					results[i + lane] = (int) (long long) comparison[lane];
+				}
+			}
+		}
+	};
+
+	/**
+	 * for every shift from the top down, the modulus times 2^shift is subtracted from all numbers of a group
+	 * which are not below it, which is long division with the quotient bits thrown away
+	 */
+	template <typename Vector>
+	struct ReduceKernel
+	{
+		__attribute__((always_inline))
+		static inline void run (BigIntegerBatch& result, const BigIntegerBatch& a, const std::uint64_t* modulus, unsigned int modulusBits)
+		{
+			typedef Lanes<Vector> L;
+			std::size_t limbCount = a._limbCount;
+			LimbStorage<std::uint64_t> shifted (limbCount);
+			for (std::size_t group = 0; group < a._stride; group += reduceGroup)
+			{
+				std::size_t groupEnd = std::min (group + reduceGroup, a._stride);
+				for (std::size_t limb = 0; limb < limbCount; ++limb)
+				{
+					std::copy (a.row (limb) + group, a.row (limb) + groupEnd, result.row (limb) + group);
+				}
+				std::size_t topLimbs = limbCount;
+				while ((topLimbs > 0) && std::all_of (result.row (topLimbs - 1) + group, result.row (topLimbs - 1) + groupEnd,
+						[] (std::uint64_t limb) { return limb == 0; }))
+				{
+					--topLimbs;
+				}
+				for (long long shift = (long long) topLimbs * 64 - modulusBits; shift >= 0; --shift)
+				{
+					shiftModulus (shifted.data (), modulus, limbCount, (unsigned int) shift);
+					for (std::size_t i = group; i < groupEnd; i += L::count)
+					{
+						// x >= modulus * 2^shift, compared from the top limb down
+						Vector less = {};
+						Vector greater = {};
+						for (std::size_t limb = limbCount; limb-- > 0;)
+						{
+							Vector x;
+							L::load (x, result.row (limb) + i);
+							Vector y = Vector {} + shifted[limb];
+							Vector undecided = ~(less | greater);
+							less |= undecided & (Vector) (x < y);
+							greater |= undecided & (Vector) (y < x);
+						}
+						Vector subtract = ~less;
+						Vector borrow = {};
+						for (std::size_t limb = 0; limb < limbCount; ++limb)
+						{
+							Vector x;
+							L::load (x, result.row (limb) + i);
+							Vector difference = x - ((Vector {} + shifted[limb]) & subtract);
+							Vector generated = (Vector) (x < difference);
+							Vector total = difference + borrow;
+							borrow = generated | (Vector) (difference < total);
+							L::store (result.row (limb) + i, total);
+						}
+					}
+				}
+			}
+		}
+	};
+
+	/// target = modulus * 2^shift in limbCount limbs, the bits shifted out are zero
+	static void shiftModulus (std::uint64_t* target, const std::uint64_t* modulus, std::size_t limbCount, unsigned int shift)
+	{
+		std::size_t limbShift = shift / 64;
+		unsigned int bitShift = shift % 64;
+		for (std::size_t limb = 0; limb < limbCount; ++limb)
+		{
+			std::uint64_t value = 0;
+			if (limb >= limbShift)
+			{
+				value = modulus[limb - limbShift] << bitShift;
+				if ((bitShift > 0) && (limb > limbShift))
+				{
+					value |= modulus[limb - limbShift - 1] >> (64 - bitShift);
+				}
+			}
+			target[limb] = value;
+		}
+	}
+
+	/// the lanes of the numbers i, i + 1, ... below size
+	template <typename Vector>
+	__attribute__((always_inline))
+	static inline void storeLanes (std::uint64_t* target, std::size_t i, std::size_t size, const Vector& value)
+	{
+		for (std::size_t lane = 0; (lane < Lanes<Vector>::count) && (i + lane < size); ++lane)
+		{
+			target[i + lane] = value[lane];
+		}
+	}
+
+	/// like storeLanes for masks, which are stored as 0 or 1
+	template <typename Vector>
+	__attribute__((always_inline))
+	static inline void storeFlags (std::uint64_t* target, std::size_t i, std::size_t size, const Vector& mask)
+	{
+		if (target != nullptr)
+		{
+			Vector flags = mask & 1;
+			storeLanes<Vector> (target, i, size, flags);
+		}
+	}
+};
+
+}
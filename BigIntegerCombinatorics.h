@@ -0,0 +1,483 @@
+/*
+ * BigIntegerCombinatorics.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "BigInteger.h"
+
+namespace Utilities
+{
+
+/**
+ * Products of many factors in balanced product trees, so the operands of every multiplication have about
+ * the same size and the fast multiplication algorithms pay off, unlike in a chain of operator*=. Factorials
+ * multiply the odd parts of the factors only and shift in the powers of two at the end.
+ */
+template <typename BaseType = std::uint64_t>
+class BigIntegerCombinatorics
+{
+public:
+	typedef BigIntegerBase<BaseType> Number;
+
+	/**
+	 * Collects factors and multiplies them in a balanced tree. Machine word factors are packed into words,
+	 * the words are multiplied into leaves of about Tuning::karatsubaThreshold limbs one by one. Complete
+	 * leaves and partial products of the same level are multiplied as soon as there are two of them, like
+	 * in a binary counter, so only a logarithmic number of partial products is kept.
+	 */
+	class ProductTree
+	{
+	public:
+		void multiply (unsigned long long factor, bool isNegative = false);
+
+		void multiply (const Number& factor);
+
+		/// the product of all factors so far, 1 without any, the tree is empty afterwards
+		Number result ();
+
+	private:
+		unsigned long long _word = 1;
+		Number _leaf = Number (1L);
+		bool _isZero = false;
+		bool _isNegative = false;
+		/// partial products with their levels, the levels strictly decrease towards the back
+		std::vector<std::pair<Number, unsigned int>> _levels;
+
+		void flushWord ();
+
+		void pushLeaf (Number& leaf);
+	};
+
+	/// first * (first + 1) * ... * last, 1 if first > last
+	static Number productOfRange (unsigned long long first, unsigned long long last);
+
+	/// the product of a sequence of integral values or numbers, 1 for an empty sequence
+	template <typename Iterator>
+	static Number productOfSequence (Iterator first, Iterator last);
+
+	/// n! from the products of the odd numbers in (n / 2^k, n / 2^(k - 1)], which occur k times
+	static Number factorial (unsigned int n);
+
+	/// n! by the prime factorizations of the swinging factorials n! / ((n / 2)!)^2 (Luschny)
+	static Number primeSwingFactorial (unsigned int n);
+
+	/**
+	 * n over k, 0 for k > n. Large parts of n! / (k! (n - k)!) come from the prime factorization, small k
+	 * from the falling factorial divided by k!.
+	 */
+	static Number binomial (unsigned long long n, unsigned long long k);
+
+	/// the product of all primes up to n
+	static Number primorial (unsigned int n);
+
+private:
+	typedef LimbArithmetic<BaseType> Limbs;
+	typedef BigIntegerTuning<BaseType> Tuning;
+
+	/// binomials with k >= n / primeBinomialRatio sieve up to n, smaller k use the falling factorial
+	static const unsigned long long primeBinomialRatio = 16;
+
+	/// the odd primes up to n
+	static std::vector<unsigned int> oddPrimes (unsigned int n);
+
+	/// the odd part of n!, oddFactorial (n / 2)^2 times the odd part of the swinging factorial
+	static Number oddFactorial (unsigned int n, const std::vector<unsigned int>& primes);
+
+	template <typename T>
+	static typename std::enable_if<std::is_integral<T>::value>::type addFactor (ProductTree& tree, T factor)
+	{
+		bool isNegative = (factor < 0);
+		unsigned long long magnitude = (unsigned long long) factor;
+		tree.multiply (isNegative ? 0 - magnitude : magnitude, isNegative);
+	}
+
+	static void addFactor (ProductTree& tree, const Number& factor)
+	{
+		tree.multiply (factor);
+	}
+};
+
+namespace Internal
+{
+
+/// the limb type of the product of a sequence, the one of the numbers in it or std::uint64_t
+template <typename T>
+struct ProductBaseType
+{
+	typedef std::uint64_t type;
+};
+
+template <typename BaseType>
+struct ProductBaseType<BigIntegerBase<BaseType>>
+{
+	typedef BaseType type;
+};
+
+}
+
+/// first * (first + 1) * ... * last, 1 if first > last
+template <typename BaseType = std::uint64_t>
+BigIntegerBase<BaseType> productOfRange (unsigned long long first, unsigned long long last)
+{
+	return BigIntegerCombinatorics<BaseType>::productOfRange (first, last);
+}
+
+/// the product of a sequence of integral values or big integers in a balanced product tree
+template <typename BaseType, typename Iterator>
+BigIntegerBase<BaseType> productOfSequence (Iterator first, Iterator last)
+{
+	return BigIntegerCombinatorics<BaseType>::productOfSequence (first, last);
+}
+
+/// same with the limbs of the big integers in the sequence, std::uint64_t for integral values
+template <typename Iterator>
+BigIntegerBase<typename Internal::ProductBaseType<typename std::iterator_traits<Iterator>::value_type>::type> productOfSequence (
+		Iterator first, Iterator last)
+{
+	typedef typename Internal::ProductBaseType<typename std::iterator_traits<Iterator>::value_type>::type BaseType;
+	return BigIntegerCombinatorics<BaseType>::productOfSequence (first, last);
+}
+
+template <typename BaseType = std::uint64_t>
+BigIntegerBase<BaseType> factorial (unsigned int n)
+{
+	return BigIntegerCombinatorics<BaseType>::factorial (n);
+}
+
+/// n! by the prime swing algorithm, faster than factorial for large n
+template <typename BaseType = std::uint64_t>
+BigIntegerBase<BaseType> primeSwingFactorial (unsigned int n)
+{
+	return BigIntegerCombinatorics<BaseType>::primeSwingFactorial (n);
+}
+
+/// n over k, 0 for k > n
+template <typename BaseType = std::uint64_t>
+BigIntegerBase<BaseType> binomial (unsigned long long n, unsigned long long k)
+{
+	return BigIntegerCombinatorics<BaseType>::binomial (n, k);
+}
+
+/// the product of all primes up to n
+template <typename BaseType = std::uint64_t>
+BigIntegerBase<BaseType> primorial (unsigned int n)
+{
+	return BigIntegerCombinatorics<BaseType>::primorial (n);
+}
+
+template <typename BaseType>
+void BigIntegerCombinatorics<BaseType>::ProductTree::multiply (unsigned long long factor, bool isNegative)
+{
+	_isNegative = (_isNegative != isNegative);
+	if (factor == 0)
+	{
+		_isZero = true;
+		return;
+	}
+	unsigned long long high;
+	unsigned long long product = WideArithmetic<unsigned long long>::mulWide (_word, factor, high);
+	if (high != 0)
+	{
+		flushWord ();
+		product = factor;
+	}
+	_word = product;
+}
+
+template <typename BaseType>
+void BigIntegerCombinatorics<BaseType>::ProductTree::multiply (const Number& factor)
+{
+	if (factor.getRealSize () == 0)
+	{
+		_isZero = true;
+		return;
+	}
+	_isNegative = (_isNegative != !factor._isPositive);
+	if (factor.getRealSize () < Tuning::karatsubaThreshold)
+	{
+		mul (_leaf, _leaf, factor);
+		_leaf._isPositive = true;
+		if (_leaf.getRealSize () >= Tuning::karatsubaThreshold)
+		{
+			pushLeaf (_leaf);
+		}
+		return;
+	}
+	Number leaf (factor);
+	leaf._isPositive = true;
+	pushLeaf (leaf);
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerCombinatorics<BaseType>::ProductTree::result ()
+{
+	flushWord ();
+	Number product;
+	swap (product, _leaf);
+	// the partial products grow towards the front, so the smaller ones are multiplied first
+	while (!_levels.empty ())
+	{
+		mul (product, product, _levels.back ().first);
+		_levels.pop_back ();
+	}
+	if (_isZero)
+	{
+		product = Number ();
+	}
+	product._isPositive = !_isNegative || (product.getRealSize () == 0);
+	_word = 1;
+	_leaf = Number (1L);
+	_isZero = false;
+	_isNegative = false;
+	return product;
+}
+
+template <typename BaseType>
+void BigIntegerCombinatorics<BaseType>::ProductTree::flushWord ()
+{
+	if (_word == 1)
+	{
+		return;
+	}
+	// _leaf *= _word in place for a single limb word, with one row per limb of the word otherwise
+	LimbStorage<BaseType>& limbs = _leaf._bigNumber;
+	std::size_t size = limbs.size ();
+	if (sizeof(BaseType) >= sizeof(_word))
+	{
+		BaseType carry = Limbs::mulLimb (limbs.data (), limbs.data (), size, (BaseType) _word);
+		if (carry != 0)
+		{
+			limbs.push_back (carry);
+		}
+	}
+	else
+	{
+		const unsigned int wordLimbs = sizeof(_word) / sizeof(BaseType);
+		LimbStorage<BaseType> product (size + wordLimbs);
+		for (unsigned int j = 0; j < wordLimbs; ++j)
+		{
+			BaseType limb = (BaseType) (_word >> (j * Limbs::bits));
+			product[size + j] = Limbs::addMulLimb (product.data () + j, limbs.data (), size, limb);
+		}
+		product.resize (Limbs::normalizedSize (product.data (), product.size ()));
+		limbs.swap (product);
+	}
+	_word = 1;
+	if (_leaf.getRealSize () >= Tuning::karatsubaThreshold)
+	{
+		pushLeaf (_leaf);
+	}
+}
+
+template <typename BaseType>
+void BigIntegerCombinatorics<BaseType>::ProductTree::pushLeaf (Number& leaf)
+{
+	unsigned int level = 0;
+	while (!_levels.empty () && (_levels.back ().second == level))
+	{
+		mul (leaf, _levels.back ().first, leaf);
+		_levels.pop_back ();
+		++level;
+	}
+	_levels.emplace_back (Number (), level);
+	swap (_levels.back ().first, leaf);
+	leaf = Number (1L);
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerCombinatorics<BaseType>::productOfRange (unsigned long long first, unsigned long long last)
+{
+	ProductTree tree;
+	if (first <= last)
+	{
+		for (unsigned long long factor = first; ; ++factor)
+		{
+			tree.multiply (factor);
+			if (factor == last)
+			{
+				break;
+			}
+		}
+	}
+	return tree.result ();
+}
+
+template <typename BaseType>
+template <typename Iterator>
+BigIntegerBase<BaseType> BigIntegerCombinatorics<BaseType>::productOfSequence (Iterator first, Iterator last)
+{
+	ProductTree tree;
+	for (; first != last; ++first)
+	{
+		addFactor (tree, *first);
+	}
+	return tree.result ();
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerCombinatorics<BaseType>::factorial (unsigned int n)
+{
+	// the odd part of n! is the product of the odd numbers up to n >> j over all j, so the odd numbers in
+	// (n >> k, n >> (k - 1)] occur k times. partial collects the ranges from the top down.
+	unsigned int levels = 0;
+	while ((n >> levels) > 2)
+	{
+		++levels;
+	}
+	Number partial (1L);
+	Number odd (1L);
+	for (unsigned int k = levels; k > 0; --k)
+	{
+		unsigned long long high = n >> (k - 1);
+		unsigned long long low = (n >> k) + 1;
+		ProductTree tree;
+		for (unsigned long long factor = low | 1; factor <= high; factor += 2)
+		{
+			tree.multiply (factor);
+		}
+		partial *= tree.result ();
+		odd *= partial;
+	}
+	unsigned int twos = n;
+	for (unsigned int rest = n; rest > 0; rest &= rest - 1)
+	{
+		--twos;
+	}
+	odd.shiftLeft (twos);
+	return odd;
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerCombinatorics<BaseType>::primeSwingFactorial (unsigned int n)
+{
+	Number result = oddFactorial (n, oddPrimes (n));
+	unsigned int twos = n;
+	for (unsigned int rest = n; rest > 0; rest &= rest - 1)
+	{
+		--twos;
+	}
+	result.shiftLeft (twos);
+	return result;
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerCombinatorics<BaseType>::binomial (unsigned long long n, unsigned long long k)
+{
+	if (k > n)
+	{
+		return Number ();
+	}
+	k = std::min (k, n - k);
+	if (k == 0)
+	{
+		return Number (1L);
+	}
+	if ((n > std::numeric_limits<unsigned int>::max ()) || (k < n / primeBinomialRatio))
+	{
+		Number falling = productOfRange (n - k + 1, n);
+		return falling / factorial ((unsigned int) k);
+	}
+	// the exponent of p is the number of borrows when subtracting k from n in base p (Kummer)
+	ProductTree tree;
+	unsigned long long rest = n - k;
+	unsigned int twos = 0;
+	for (unsigned long long power = 2; power <= n; power *= 2)
+	{
+		twos += (unsigned int) (n / power - k / power - rest / power);
+	}
+	for (unsigned int p : oddPrimes ((unsigned int) n))
+	{
+		for (unsigned long long power = p; power <= n; power *= p)
+		{
+			for (unsigned long long borrows = n / power - k / power - rest / power; borrows > 0; --borrows)
+			{
+				tree.multiply (p);
+			}
+			if (power > n / p)
+			{
+				break;
+			}
+		}
+	}
+	Number result = tree.result ();
+	result.shiftLeft (twos);
+	return result;
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerCombinatorics<BaseType>::primorial (unsigned int n)
+{
+	ProductTree tree;
+	if (n >= 2)
+	{
+		tree.multiply (2);
+	}
+	for (unsigned int p : oddPrimes (n))
+	{
+		tree.multiply (p);
+	}
+	return tree.result ();
+}
+
+template <typename BaseType>
+std::vector<unsigned int> BigIntegerCombinatorics<BaseType>::oddPrimes (unsigned int n)
+{
+	// isComposite[i] stands for 2 i + 1
+	std::vector<unsigned int> primes;
+	std::size_t count = ((std::size_t) n + 1) / 2;
+	std::vector<bool> isComposite (count, false);
+	for (std::size_t i = 1; i < count; ++i)
+	{
+		if (isComposite[i])
+		{
+			continue;
+		}
+		std::size_t p = 2 * i + 1;
+		primes.push_back ((unsigned int) p);
+		for (std::size_t multiple = p * p / 2; multiple < count; multiple += p)
+		{
+			isComposite[multiple] = true;
+		}
+	}
+	return primes;
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerCombinatorics<BaseType>::oddFactorial (unsigned int n, const std::vector<unsigned int>& primes)
+{
+	if (n < 3)
+	{
+		return Number (1L);
+	}
+	Number result = oddFactorial (n / 2, primes).square ();
+	// p divides the swinging factorial once for every odd n / p^i
+	ProductTree tree;
+	for (unsigned int p : primes)
+	{
+		if (p > n)
+		{
+			break;
+		}
+		for (unsigned long long quotient = n / p; quotient > 0; quotient /= p)
+		{
+			if ((quotient & 1) != 0)
+			{
+				tree.multiply (p);
+			}
+		}
+	}
+	result *= tree.result ();
+	return result;
+}
+
+}
@@ -0,0 +1,680 @@
+/*
+ * BigIntegerGcd.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include "BigInteger.h"
+#include "BigIntegerTuning.h"
+#include "LimbArithmetic.h"
+#include "LimbStorage.h"
+
+namespace Utilities
+{
+
+/**
+ * Greatest common divisors of big integers. Operands with one 64 bit word use the binary algorithm,
+ * medium sizes Lehmer's algorithm, which replaces many Euclid steps by one matrix computed from the
+ * leading bits, and sizes from BigIntegerTuning::halfGcdThreshold on the subquadratic half gcd of
+ * Schönhage in the formulation of Möller, which reduces the upper halves recursively and combines the
+ * matrices with the fast multiplication. The extended version updates the cofactors of the first
+ * operand along the way and derives the other one at the end.
+ */
+template <typename BaseType = std::uint64_t>
+class BigIntegerGcd
+{
+public:
+	typedef BigIntegerBase<BaseType> Number;
+
+	/// the non negative gcd of a and b, gcd (0, 0) == 0
+	static Number gcd (const Number& a, const Number& b);
+
+	/// the non negative gcd of a and b, x and y are set so that a * x + b * y == gcd
+	static Number extendedGcd (const Number& a, const Number& b, Number& x, Number& y);
+
+private:
+	typedef LimbArithmetic<BaseType> Limbs;
+	typedef BigIntegerTuning<BaseType> Tuning;
+
+	static const unsigned int limbBits = sizeof(BaseType) << 3;
+
+	/// bits of the single precision approximations in a Lehmer step, the matrix entries then fit into a limb
+	static const unsigned int lehmerBits = ((limbBits < 64) ? limbBits : 64) - 2;
+
+	/**
+	 * some Euclid steps in one go, (u, v) becomes (a u + b v, c u + d v). The signs of the entries alternate,
+	 * so one of a and b is positive and the other one not.
+	 */
+	struct LehmerMatrix
+	{
+		long long a, b, c, d;
+	};
+
+	/// (a, b) before a reduction is this matrix times (a, b) after it, the entries are not negative
+	struct Matrix
+	{
+		Matrix () : m00(1L), m01(0L), m10(0L), m11(1L), negativeDeterminant(false)
+		{
+		}
+
+		Number m00, m01, m10, m11;
+		bool negativeDeterminant;
+	};
+
+	/// the limbs for applying a Lehmer matrix, kept over all steps of one gcd
+	struct Scratch
+	{
+		LimbStorage<BaseType> first;
+		LimbStorage<BaseType> second;
+		LimbStorage<BaseType> third;
+	};
+
+	/**
+	 * reduces the non negative a and b until one of them is zero, the other one is the gcd then. With
+	 * cofactors they are transformed like a and b.
+	 */
+	static void reduce (Number& a, Number& b, Number* aCofactor, Number* bCofactor);
+
+	/// u = u mod v for u >= v, the cofactor of u follows
+	static void divisionStep (Number& u, Number& v, Number* uCofactor, Number* vCofactor);
+
+	/**
+	 * the half gcd of Möller: with n the bit length of the larger one and s = n / 2 + 1, a and b are
+	 * reduced by Euclid steps which keep both at least 2^s, until they differ by less than 2^s. The steps
+	 * are collected in matrix, which has to be the identity. Returns false if no step was possible.
+	 */
+	static bool halfGcd (Number& a, Number& b, Matrix& matrix, Scratch& scratch);
+
+	/**
+	 * reduces a and b by the half gcd of their parts from bit shift on and applies the matrix to the
+	 * whole numbers, which is taken over into matrix. Nothing is changed if that fails.
+	 */
+	static bool reduceUpperPart (Number& a, Number& b, unsigned int shift, unsigned int s, Matrix& matrix, Scratch& scratch);
+
+	/**
+	 * one step of the half gcd, a Lehmer step if its result stays at least 2^s, otherwise a single
+	 * subtraction of the largest multiple of the smaller number which leaves the larger one at least 2^s.
+	 * Returns false if the numbers differ by less than 2^s.
+	 */
+	static bool reduceStep (Number& a, Number& b, unsigned int s, Matrix& matrix, Scratch& scratch);
+
+	/**
+	 * the Lehmer matrix for u >= v from their leading bits. If limit is not zero the steps stop before a
+	 * remainder could fall below 2^limit. The matrix is the identity if no step was safe.
+	 */
+	static LehmerMatrix lehmerMatrix (const Number& u, const Number& v, unsigned int limit);
+
+	/**
+	 * (u, v) = (a u + b v, c u + d v) for u >= v, the results are known to be non negative. Returns false
+	 * and keeps u and v if one of the results would have less than minimumBits bits.
+	 */
+	static bool applyLehmer (Number& u, Number& v, const LehmerMatrix& lehmer, unsigned int minimumBits, Scratch& scratch);
+
+	/// result = x * xFactor - y * yFactor for n limbs each, the result is known to be non negative
+	static void combine (LimbStorage<BaseType>& result, const BaseType* x, BaseType xFactor, const BaseType* y, BaseType yFactor,
+			std::size_t n);
+
+	/// (x, y) = (x * f00 + y * f10, x * f01 + y * f11) for non negative x and y, a row of a matrix product
+	static void multiplyRow (Number& x, Number& y, BaseType f00, BaseType f01, BaseType f10, BaseType f11, Scratch& scratch);
+
+	/// (x, y) = (a x + b y, c x + d y) for the cofactors, which have any sign
+	static void transformCofactors (Number& x, Number& y, const LehmerMatrix& lehmer, Scratch& scratch);
+
+	/// result = |x| * |factor|, returns the sign of x * factor
+	static bool scale (LimbStorage<BaseType>& result, const Number& x, long long factor);
+
+	/// the inverse of matrix applied to (x, y), which have any sign
+	static void applyInverse (const Matrix& matrix, Number& x, Number& y);
+
+	/// matrix = matrix * other
+	static void multiply (Matrix& matrix, const Matrix& other);
+
+	/// matrix = matrix * the inverse of lehmer, swapped means the matrix is for (v, u) instead of (u, v)
+	static void multiplyInverse (Matrix& matrix, const LehmerMatrix& lehmer, bool swapped, Scratch& scratch);
+
+	/// the count bits from bit shift on, count is at most 64
+	static unsigned long long bitsAt (const Number& x, unsigned int shift, unsigned int count);
+
+	/// x / y for x, y >= 0, most quotients in Euclid's algorithm are small and a few subtractions are cheaper than a division
+	static long long quotient (long long x, long long y)
+	{
+		for (long long q = 0; q < 4; ++q)
+		{
+			if (x < y)
+			{
+				return q;
+			}
+			x -= y;
+		}
+		return x / y + 4;
+	}
+
+	/// gcd of two words with Stein's binary algorithm
+	static unsigned long long binaryGcd (unsigned long long u, unsigned long long v);
+
+	static bool isZero (const Number& x)
+	{
+		return x.getRealSize () == 0;
+	}
+
+	static Number powerOfTwo (unsigned int exponent)
+	{
+		Number result;
+		result.setBit (exponent);
+		return result;
+	}
+
+	/// the number of bits to keep both numbers above in a half gcd of n bit numbers
+	static unsigned int halfGcdLimit (unsigned int n)
+	{
+		return n / 2 + 1;
+	}
+};
+
+/// the non negative greatest common divisor of a and b
+template <typename BaseType>
+BigIntegerBase<BaseType> gcd (const BigIntegerBase<BaseType>& a, const BigIntegerBase<BaseType>& b)
+{
+	return BigIntegerGcd<BaseType>::gcd (a, b);
+}
+
+/// the non negative greatest common divisor of a and b, x and y are set so that a * x + b * y is the gcd
+template <typename BaseType>
+BigIntegerBase<BaseType> extendedGcd (const BigIntegerBase<BaseType>& a, const BigIntegerBase<BaseType>& b,
+		BigIntegerBase<BaseType>& x, BigIntegerBase<BaseType>& y)
+{
+	return BigIntegerGcd<BaseType>::extendedGcd (a, b, x, y);
+}
+
+/**
+ * the inverse of a modulo modulus in [0, modulus). Throws std::domain_error if modulus is not positive or
+ * a has no inverse.
+ */
+template <typename BaseType>
+BigIntegerBase<BaseType> modInverse (const BigIntegerBase<BaseType>& a, const BigIntegerBase<BaseType>& modulus)
+{
+	const BigIntegerBase<BaseType> zero;
+	const BigIntegerBase<BaseType> one (1L);
+	if (modulus <= zero)
+	{
+		throw std::domain_error("modInverse: the modulus has to be positive");
+	}
+	BigIntegerBase<BaseType> x;
+	BigIntegerBase<BaseType> y;
+	if (!(BigIntegerGcd<BaseType>::extendedGcd (a, modulus, x, y) == one))
+	{
+		throw std::domain_error("modInverse: the number is not invertible");
+	}
+	x %= modulus;
+	if (x < zero)
+	{
+		x += modulus;
+	}
+	return x;
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerGcd<BaseType>::gcd (const Number& a, const Number& b)
+{
+	Number u (a);
+	Number v (b);
+	u._isPositive = true;
+	v._isPositive = true;
+	reduce (u, v, nullptr, nullptr);
+	return isZero (u) ? v : u;
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerGcd<BaseType>::extendedGcd (const Number& a, const Number& b, Number& x, Number& y)
+{
+	const Number one (1L);
+	if (isZero (b))
+	{
+		x = a._isPositive ? one : Number (-1L);
+		y = Number ();
+		Number result (a);
+		result._isPositive = true;
+		if (isZero (a))
+		{
+			x = Number ();
+		}
+		return result;
+	}
+	Number u (a);
+	Number v (b);
+	u._isPositive = true;
+	v._isPositive = true;
+	// the cofactors of |a|: uCofactor * |a| == u and vCofactor * |a| == v modulo |b|
+	Number uCofactor (one);
+	Number vCofactor;
+	reduce (u, v, &uCofactor, &vCofactor);
+	Number result (isZero (u) ? v : u);
+	x = isZero (u) ? vCofactor : uCofactor;
+	// the cofactor of |b| follows from result == x * |a| + y * |b|
+	Number absoluteA (a);
+	absoluteA._isPositive = true;
+	Number absoluteB (b);
+	absoluteB._isPositive = true;
+	y = result;
+	submul (y, x, absoluteA);
+	y /= absoluteB;
+	if (!a._isPositive && !isZero (x))
+	{
+		x._isPositive = !x._isPositive;
+	}
+	if (!b._isPositive && !isZero (y))
+	{
+		y._isPositive = !y._isPositive;
+	}
+	return result;
+}
+
+template <typename BaseType>
+void BigIntegerGcd<BaseType>::reduce (Number& a, Number& b, Number* aCofactor, Number* bCofactor)
+{
+	bool withCofactors = (aCofactor != nullptr);
+	Scratch scratch;
+	while (!isZero (a) && !isZero (b))
+	{
+		bool aIsLarger = !(a < b);
+		Number& u = aIsLarger ? a : b;
+		Number& v = aIsLarger ? b : a;
+		Number* uCofactor = aIsLarger ? aCofactor : bCofactor;
+		Number* vCofactor = aIsLarger ? bCofactor : aCofactor;
+		std::size_t uSize = u.getRealSize ();
+		std::size_t vSize = v.getRealSize ();
+		if (!withCofactors && (u.bitLength () <= 64))
+		{
+			u.setFromNumber (binaryGcd (bitsAt (u, 0, 64), bitsAt (v, 0, 64)));
+			v = Number ();
+			return;
+		}
+		if (uSize > vSize + 1)
+		{
+			divisionStep (u, v, uCofactor, vCofactor);
+			continue;
+		}
+		if (vSize >= Tuning::halfGcdThreshold)
+		{
+			Matrix matrix;
+			if (halfGcd (u, v, matrix, scratch))
+			{
+				if (withCofactors)
+				{
+					applyInverse (matrix, *uCofactor, *vCofactor);
+				}
+				continue;
+			}
+		}
+		else
+		{
+			LehmerMatrix lehmer = lehmerMatrix (u, v, 0);
+			if (lehmer.b != 0)
+			{
+				applyLehmer (u, v, lehmer, 0, scratch);
+				if (withCofactors)
+				{
+					transformCofactors (*uCofactor, *vCofactor, lehmer, scratch);
+				}
+				continue;
+			}
+		}
+		divisionStep (u, v, uCofactor, vCofactor);
+	}
+}
+
+template <typename BaseType>
+void BigIntegerGcd<BaseType>::divisionStep (Number& u, Number& v, Number* uCofactor, Number* vCofactor)
+{
+	std::pair<Number, Number> quotientAndRemainder = u.divmod (v);
+	u = std::move (quotientAndRemainder.second);
+	if (uCofactor != nullptr)
+	{
+		submul (*uCofactor, quotientAndRemainder.first, *vCofactor);
+	}
+}
+
+template <typename BaseType>
+bool BigIntegerGcd<BaseType>::halfGcd (Number& a, Number& b, Matrix& matrix, Scratch& scratch)
+{
+	unsigned int n = std::max (a.bitLength (), b.bitLength ());
+	unsigned int s = halfGcdLimit (n);
+	if (std::min (a.bitLength (), b.bitLength ()) <= s)
+	{
+		return false;
+	}
+	bool progress = false;
+	if (n >= Tuning::halfGcdBasecaseThreshold * limbBits)
+	{
+		// the upper half gives the first quarter of the steps
+		progress = reduceUpperPart (a, b, n / 2, s, matrix, scratch);
+		while (std::max (a.bitLength (), b.bitLength ()) > 3 * n / 4)
+		{
+			if (!reduceStep (a, b, s, matrix, scratch))
+			{
+				return progress;
+			}
+			progress = true;
+		}
+		// the second quarter from the upper part of what is left
+		unsigned int m = std::max (a.bitLength (), b.bitLength ());
+		if ((m > s + 2 * limbBits) && reduceUpperPart (a, b, 2 * s - m + 1, s, matrix, scratch))
+		{
+			progress = true;
+		}
+	}
+	while (reduceStep (a, b, s, matrix, scratch))
+	{
+		progress = true;
+	}
+	return progress;
+}
+
+template <typename BaseType>
+bool BigIntegerGcd<BaseType>::reduceUpperPart (Number& a, Number& b, unsigned int shift, unsigned int s, Matrix& matrix,
+		Scratch& scratch)
+{
+	Number aHigh (a);
+	Number bHigh (b);
+	aHigh.shiftRight (shift);
+	bHigh.shiftRight (shift);
+	Matrix upper;
+	if (!halfGcd (aHigh, bHigh, upper, scratch))
+	{
+		return false;
+	}
+	// (a, b) = 2^shift (aHigh, bHigh) + upper^-1 (aLow, bLow)
+	Number aLow = a.extractBits (0, shift);
+	Number bLow = b.extractBits (0, shift);
+	applyInverse (upper, aLow, bLow);
+	aHigh.shiftLeft (shift);
+	bHigh.shiftLeft (shift);
+	aHigh += aLow;
+	bHigh += bLow;
+	// the bounds of Möller guarantee this, it is checked anyway, so a failure only costs time
+	if ((aHigh.bitLength () <= s) || (bHigh.bitLength () <= s) || !aHigh._isPositive || !bHigh._isPositive)
+	{
+		return false;
+	}
+	a = std::move (aHigh);
+	b = std::move (bHigh);
+	multiply (matrix, upper);
+	return true;
+}
+
+template <typename BaseType>
+bool BigIntegerGcd<BaseType>::reduceStep (Number& a, Number& b, unsigned int s, Matrix& matrix, Scratch& scratch)
+{
+	bool aIsLarger = !(a < b);
+	Number& u = aIsLarger ? a : b;
+	Number& v = aIsLarger ? b : a;
+	Number difference = u - v;
+	if (difference.bitLength () <= s)
+	{
+		return false;
+	}
+	LehmerMatrix lehmer = lehmerMatrix (u, v, s);
+	if ((lehmer.b != 0) && applyLehmer (u, v, lehmer, s + 1, scratch))
+	{
+		multiplyInverse (matrix, lehmer, !aIsLarger, scratch);
+		return true;
+	}
+	// u - q v >= 2^s with the largest possible q
+	Number limit = powerOfTwo (s);
+	difference = u - limit;
+	std::pair<Number, Number> quotientAndRemainder = difference.divmod (v);
+	u = quotientAndRemainder.second + limit;
+	const Number& q = quotientAndRemainder.first;
+	if (aIsLarger)
+	{
+		addmul (matrix.m01, q, matrix.m00);
+		addmul (matrix.m11, q, matrix.m10);
+	}
+	else
+	{
+		addmul (matrix.m00, q, matrix.m01);
+		addmul (matrix.m10, q, matrix.m11);
+	}
+	return true;
+}
+
+template <typename BaseType>
+typename BigIntegerGcd<BaseType>::LehmerMatrix BigIntegerGcd<BaseType>::lehmerMatrix (const Number& u, const Number& v,
+		unsigned int limit)
+{
+	LehmerMatrix lehmer = { 1, 0, 0, 1 };
+	unsigned int n = u.bitLength ();
+	unsigned int shift = (n > lehmerBits) ? n - lehmerBits : 0;
+	// remainders below this bound (in units of 2^shift) could be below 2^limit
+	long long bound = 0;
+	if (limit > 0)
+	{
+		if (limit + 1 >= shift + lehmerBits)
+		{
+			return lehmer;
+		}
+		bound = (limit + 1 > shift) ? 1LL << (limit + 1 - shift) : 1;
+	}
+	long long uHat = (long long) bitsAt (u, shift, lehmerBits);
+	long long vHat = (long long) bitsAt (v, shift, lehmerBits);
+	// Knuth's algorithm L: a quotient is only taken if both bounds of the true values agree on it
+	while ((vHat + lehmer.c != 0) && (vHat + lehmer.d != 0))
+	{
+		long long q = quotient (uHat + lehmer.a, vHat + lehmer.c);
+		if (q != quotient (uHat + lehmer.b, vHat + lehmer.d))
+		{
+			break;
+		}
+		long long remainder = uHat - q * vHat;
+		if (remainder < bound)
+		{
+			break;
+		}
+		long long temp = lehmer.a - q * lehmer.c;
+		lehmer.a = lehmer.c;
+		lehmer.c = temp;
+		temp = lehmer.b - q * lehmer.d;
+		lehmer.b = lehmer.d;
+		lehmer.d = temp;
+		uHat = vHat;
+		vHat = remainder;
+	}
+	return lehmer;
+}
+
+template <typename BaseType>
+bool BigIntegerGcd<BaseType>::applyLehmer (Number& u, Number& v, const LehmerMatrix& lehmer, unsigned int minimumBits, Scratch& scratch)
+{
+	std::size_t n = u.getRealSize ();
+	v._bigNumber.resize (n);
+	const BaseType* uLimbs = u._bigNumber.data ();
+	const BaseType* vLimbs = v._bigNumber.data ();
+	// after an even number of steps a > 0, b <= 0, c <= 0 and d > 0, after an odd number the other way round
+	if (lehmer.b <= 0)
+	{
+		combine (scratch.first, uLimbs, (BaseType) lehmer.a, vLimbs, (BaseType) -lehmer.b, n);
+		combine (scratch.second, vLimbs, (BaseType) lehmer.d, uLimbs, (BaseType) -lehmer.c, n);
+	}
+	else
+	{
+		combine (scratch.first, vLimbs, (BaseType) lehmer.b, uLimbs, (BaseType) -lehmer.a, n);
+		combine (scratch.second, uLimbs, (BaseType) lehmer.c, vLimbs, (BaseType) -lehmer.d, n);
+	}
+	u._bigNumber.swap (scratch.first);
+	v._bigNumber.swap (scratch.second);
+	if ((u.bitLength () < minimumBits) || (v.bitLength () < minimumBits))
+	{
+		// the old limbs are still in the scratch
+		u._bigNumber.swap (scratch.first);
+		v._bigNumber.swap (scratch.second);
+		return false;
+	}
+	u.cleanLeadingZeroes ();
+	v.cleanLeadingZeroes ();
+	return true;
+}
+
+template <typename BaseType>
+void BigIntegerGcd<BaseType>::combine (LimbStorage<BaseType>& result, const BaseType* x, BaseType xFactor, const BaseType* y,
+		BaseType yFactor, std::size_t n)
+{
+	result.resize (n + 1);
+	BaseType high = Limbs::mulLimb (result.data (), x, n, xFactor);
+	result[n] = high - Limbs::subMulLimb (result.data (), y, n, yFactor);
+}
+
+template <typename BaseType>
+void BigIntegerGcd<BaseType>::multiplyRow (Number& x, Number& y, BaseType f00, BaseType f01, BaseType f10, BaseType f11,
+		Scratch& scratch)
+{
+	std::size_t n = std::max (x.getRealSize (), y.getRealSize ());
+	x._bigNumber.resize (n);
+	y._bigNumber.resize (n);
+	const BaseType* xLimbs = x._bigNumber.data ();
+	const BaseType* yLimbs = y._bigNumber.data ();
+	// the factors have two bits less than a limb, so both sums fit into n + 1 limbs
+	scratch.first.resize (n + 1);
+	scratch.first[n] = Limbs::mulLimb (scratch.first.data (), xLimbs, n, f00);
+	scratch.first[n] += Limbs::addMulLimb (scratch.first.data (), yLimbs, n, f10);
+	scratch.second.resize (n + 1);
+	scratch.second[n] = Limbs::mulLimb (scratch.second.data (), xLimbs, n, f01);
+	scratch.second[n] += Limbs::addMulLimb (scratch.second.data (), yLimbs, n, f11);
+	x._bigNumber.swap (scratch.first);
+	y._bigNumber.swap (scratch.second);
+	x.cleanLeadingZeroes ();
+	y.cleanLeadingZeroes ();
+}
+
+template <typename BaseType>
+void BigIntegerGcd<BaseType>::transformCofactors (Number& x, Number& y, const LehmerMatrix& lehmer, Scratch& scratch)
+{
+	bool firstIsPositive = scale (scratch.first, x, lehmer.a);
+	bool secondIsPositive = scale (scratch.second, y, lehmer.b);
+	bool newXIsPositive = Number::addSigned (scratch.first, scratch.first, scratch.first.size (), firstIsPositive, scratch.second,
+			scratch.second.size (), secondIsPositive);
+	secondIsPositive = scale (scratch.second, x, lehmer.c);
+	bool thirdIsPositive = scale (scratch.third, y, lehmer.d);
+	bool newYIsPositive = Number::addSigned (scratch.second, scratch.second, scratch.second.size (), secondIsPositive, scratch.third,
+			scratch.third.size (), thirdIsPositive);
+	x._bigNumber.swap (scratch.first);
+	y._bigNumber.swap (scratch.second);
+	x._isPositive = newXIsPositive;
+	y._isPositive = newYIsPositive;
+	x.cleanLeadingZeroes ();
+	y.cleanLeadingZeroes ();
+	x._isPositive = x._isPositive || isZero (x);
+	y._isPositive = y._isPositive || isZero (y);
+}
+
+template <typename BaseType>
+bool BigIntegerGcd<BaseType>::scale (LimbStorage<BaseType>& result, const Number& x, long long factor)
+{
+	std::size_t n = x.getRealSize ();
+	result.resize (n + 1);
+	result[n] = Limbs::mulLimb (result.data (), x._bigNumber.data (), n, (BaseType) ((factor < 0) ? -factor : factor));
+	result.resize (Limbs::normalizedSize (result.data (), n + 1));
+	return (x._isPositive == (factor >= 0)) || (result.size () == 0);
+}
+
+template <typename BaseType>
+void BigIntegerGcd<BaseType>::applyInverse (const Matrix& matrix, Number& x, Number& y)
+{
+	// the inverse of (m00 m01, m10 m11) is (m11 -m01, -m10 m00) divided by the determinant
+	Number newX;
+	mul (newX, matrix.m11, x);
+	submul (newX, matrix.m01, y);
+	Number newY;
+	mul (newY, matrix.m00, y);
+	submul (newY, matrix.m10, x);
+	if (matrix.negativeDeterminant)
+	{
+		newX._isPositive = !newX._isPositive || isZero (newX);
+		newY._isPositive = !newY._isPositive || isZero (newY);
+	}
+	x = std::move (newX);
+	y = std::move (newY);
+}
+
+template <typename BaseType>
+void BigIntegerGcd<BaseType>::multiply (Matrix& matrix, const Matrix& other)
+{
+	Number m00;
+	mul (m00, matrix.m00, other.m00);
+	addmul (m00, matrix.m01, other.m10);
+	Number m01;
+	mul (m01, matrix.m00, other.m01);
+	addmul (m01, matrix.m01, other.m11);
+	Number m10;
+	mul (m10, matrix.m10, other.m00);
+	addmul (m10, matrix.m11, other.m10);
+	Number m11;
+	mul (m11, matrix.m10, other.m01);
+	addmul (m11, matrix.m11, other.m11);
+	matrix.m00 = std::move (m00);
+	matrix.m01 = std::move (m01);
+	matrix.m10 = std::move (m10);
+	matrix.m11 = std::move (m11);
+	matrix.negativeDeterminant = (matrix.negativeDeterminant != other.negativeDeterminant);
+}
+
+template <typename BaseType>
+void BigIntegerGcd<BaseType>::multiplyInverse (Matrix& matrix, const LehmerMatrix& lehmer, bool swapped, Scratch& scratch)
+{
+	// the inverse of (a b, c d) with determinant e = +-1 is e (d -b, -c a), its entries are not negative
+	long long determinant = (lehmer.b <= 0) ? 1 : -1;
+	BaseType f00 = (BaseType) (determinant * lehmer.d);
+	BaseType f01 = (BaseType) (-determinant * lehmer.b);
+	BaseType f10 = (BaseType) (-determinant * lehmer.c);
+	BaseType f11 = (BaseType) (determinant * lehmer.a);
+	if (swapped)
+	{
+		// the same steps on (v, u), rows and columns are swapped
+		std::swap (f00, f11);
+		std::swap (f01, f10);
+	}
+	multiplyRow (matrix.m00, matrix.m01, f00, f01, f10, f11, scratch);
+	multiplyRow (matrix.m10, matrix.m11, f00, f01, f10, f11, scratch);
+	matrix.negativeDeterminant = (matrix.negativeDeterminant != (determinant < 0));
+}
+
+template <typename BaseType>
+unsigned long long BigIntegerGcd<BaseType>::bitsAt (const Number& x, unsigned int shift, unsigned int count)
+{
+	unsigned long long result = 0;
+	std::size_t size = x._bigNumber.size ();
+	for (std::size_t index = shift / limbBits; (index < size) && (index * limbBits < shift + count); ++index)
+	{
+		unsigned long long limb = x._bigNumber[index];
+		std::size_t position = index * limbBits;
+		result |= (position >= shift) ? limb << (position - shift) : limb >> (shift - position);
+	}
+	return (count < 64) ? result & ((1ULL << count) - 1) : result;
+}
+
+template <typename BaseType>
+unsigned long long BigIntegerGcd<BaseType>::binaryGcd (unsigned long long u, unsigned long long v)
+{
+	if ((u == 0) || (v == 0))
+	{
+		return u | v;
+	}
+	unsigned int shift = __builtin_ctzll (u | v);
+	u >>= __builtin_ctzll (u);
+	while (v != 0)
+	{
+		v >>= __builtin_ctzll (v);
+		if (u > v)
+		{
+			std::swap (u, v);
+		}
+		v -= u;
+	}
+	return u << shift;
+}
+
+}
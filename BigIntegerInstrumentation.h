@@ -0,0 +1,363 @@
+/*
+ * BigIntegerInstrumentation.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <x86intrin.h>
+#define UTILITIES_INSTRUMENTATION_TSC 1
+#endif
+
+/**
+ * The hooks of BigIntegerInstrumentation. Without UTILITIES_INSTRUMENTATION (the CMake option of the same
+ * name) they expand to nothing and their arguments are not evaluated.
+ */
+#if defined(UTILITIES_INSTRUMENTATION)
+#define UTILITIES_INSTRUMENT_OPERATION(operation, limbs) \
+	Utilities::BigIntegerInstrumentation::ScopedOperation instrumentedOperation (Utilities::BigIntegerInstrumentation::operation, (limbs))
+#define UTILITIES_INSTRUMENT_TIER(tier) Utilities::BigIntegerInstrumentation::countTier (Utilities::BigIntegerInstrumentation::tier)
+#define UTILITIES_INSTRUMENT_ALLOCATION(bytes, fromArena) Utilities::BigIntegerInstrumentation::countAllocation ((bytes), (fromArena))
+#define UTILITIES_INSTRUMENT_NUMBER() Utilities::BigIntegerInstrumentation::countNumber ()
+#define UTILITIES_INSTRUMENT_NESTED_TASKS(tasks) Utilities::BigIntegerInstrumentation::nestTasks (tasks)
+#else
+#define UTILITIES_INSTRUMENT_OPERATION(operation, limbs) ((void) 0)
+#define UTILITIES_INSTRUMENT_TIER(tier) ((void) 0)
+#define UTILITIES_INSTRUMENT_ALLOCATION(bytes, fromArena) ((void) 0)
+#define UTILITIES_INSTRUMENT_NUMBER() ((void) 0)
+#define UTILITIES_INSTRUMENT_NESTED_TASKS(tasks) ((void) 0)
+#endif
+
+namespace Utilities
+{
+
+/**
+ * Counters of the BigIntegerBase operations: calls, limbs of the operands, cycles, the algorithms chosen,
+ * limb allocations and numbers created. Every thread counts into its own counters without locked
+ * instructions, snapshot () adds up the counters of all threads, including the ones that have ended.
+ * Cycles are time stamp counter ticks where there is one, nanoseconds otherwise. Only the outermost
+ * operation is counted: the multiplications of a Newton division or the additions of Toom-3 are part of
+ * the calls and cycles of the operation using them, also when they run as tasks on other threads.
+ */
+class BigIntegerInstrumentation
+{
+public:
+#if defined(UTILITIES_INSTRUMENTATION)
+	static const bool enabled = true;
+#else
+	static const bool enabled = false;
+#endif
+
+	enum Operation
+	{
+		Add, Sub, Mul, Div, Shift, ToString, FromString, operationCount
+	};
+
+	/// the algorithm a multiplication or division of magnitudes chose, recursive calls count as well
+	enum Tier
+	{
+		MulBasecase, MulSquare, MulKaratsuba, MulToom3, MulUnbalanced, MulNtt, DivSingleLimb, DivSchoolbook, DivNewton, tierCount
+	};
+
+	struct OperationStatistics
+	{
+		std::uint64_t calls = 0;
+		std::uint64_t limbs = 0;
+		std::uint64_t cycles = 0;
+	};
+
+	struct Statistics
+	{
+		OperationStatistics operations[operationCount];
+		std::uint64_t tiers[tierCount] = {};
+		std::uint64_t heapAllocations = 0;
+		std::uint64_t arenaAllocations = 0;
+		std::uint64_t allocatedBytes = 0;
+		std::uint64_t numbersCreated = 0;
+	};
+
+	/// the sum over all threads, zero if the instrumentation is disabled
+	static Statistics snapshot ()
+	{
+		Registry& all = registry ();
+		std::lock_guard<std::mutex> lock (all.mutex);
+		Statistics result = all.retired;
+		for (const Counters* counters : all.live)
+		{
+			counters->addTo (result);
+		}
+		return result;
+	}
+
+	/// sets the counters of all threads to zero, counts running at the same time may get lost
+	static void reset ()
+	{
+		Registry& all = registry ();
+		std::lock_guard<std::mutex> lock (all.mutex);
+		all.retired = Statistics ();
+		for (Counters* counters : all.live)
+		{
+			counters->clear ();
+		}
+	}
+
+	static const char* operationName (Operation operation)
+	{
+		static const char* const names[operationCount] = {"add", "sub", "mul", "div", "shift", "toString", "fromString"};
+		return names[operation];
+	}
+
+	static const char* tierName (Tier tier)
+	{
+		static const char* const names[tierCount] = {"mulBasecase", "mulSquare", "mulKaratsuba", "mulToom3", "mulUnbalanced", "mulNtt",
+				"divSingleLimb", "divSchoolbook", "divNewton"};
+		return names[tier];
+	}
+
+	/// one line per counter which is not zero
+	static void print (std::ostream& os, const Statistics& statistics)
+	{
+		for (int i = 0; i < operationCount; ++i)
+		{
+			const OperationStatistics& operation = statistics.operations[i];
+			if (operation.calls > 0)
+			{
+				os << operationName ((Operation) i) << ": calls " << operation.calls << ", limbs " << operation.limbs << ", cycles "
+						<< operation.cycles << "\n";
+			}
+		}
+		for (int i = 0; i < tierCount; ++i)
+		{
+			if (statistics.tiers[i] > 0)
+			{
+				os << tierName ((Tier) i) << ": " << statistics.tiers[i] << "\n";
+			}
+		}
+		os << "allocations: heap " << statistics.heapAllocations << ", arena " << statistics.arenaAllocations << ", bytes "
+				<< statistics.allocatedBytes << "\nnumbers created: " << statistics.numbersCreated << "\n";
+	}
+
+	/**
+	 * counts one call of operation with limbs limbs and its cycles until the end of the scope, unless it
+	 * runs inside another operation of the thread
+	 */
+	class ScopedOperation
+	{
+	public:
+		ScopedOperation (Operation operation, std::size_t limbs) : _operation(operation), _isOutermost(local ().depth++ == 0), _start(0)
+		{
+			if (_isOutermost)
+			{
+				Counters& counters = local ();
+				increment (counters.calls[operation], 1);
+				increment (counters.limbs[operation], limbs);
+				_start = cycles ();
+			}
+		}
+
+		ScopedOperation (const ScopedOperation&) = delete;
+		ScopedOperation& operator= (const ScopedOperation&) = delete;
+
+		~ScopedOperation ()
+		{
+			Counters& counters = local ();
+			--counters.depth;
+			if (_isOutermost)
+			{
+				increment (counters.cycles[_operation], cycles () - _start);
+			}
+		}
+
+	private:
+		Operation _operation;
+		bool _isOutermost;
+		std::uint64_t _start;
+	};
+
+	/// makes the operations of the tasks part of the current one, whichever thread runs them
+	static void nestTasks (std::vector<std::function<void ()> >& tasks)
+	{
+		for (std::function<void ()>& task : tasks)
+		{
+			task = [task]
+			{
+				ScopedNesting nested;
+				task ();
+			};
+		}
+	}
+
+	static void countTier (Tier tier)
+	{
+		increment (local ().tiers[tier], 1);
+	}
+
+	static void countAllocation (std::size_t bytes, bool fromArena)
+	{
+		Counters& counters = local ();
+		increment (fromArena ? counters.arenaAllocations : counters.heapAllocations, 1);
+		increment (counters.allocatedBytes, bytes);
+	}
+
+	static void countNumber ()
+	{
+		increment (local ().numbersCreated, 1);
+	}
+
+private:
+	typedef std::atomic<std::uint64_t> Counter;
+
+	/**
+	 * the counters of one thread. Only the thread itself writes them, so an increment is a relaxed load and
+	 * store; they are atomic only for the readers in snapshot ().
+	 */
+	struct Counters
+	{
+		Counter calls[operationCount];
+		Counter limbs[operationCount];
+		Counter cycles[operationCount];
+		Counter tiers[tierCount];
+		Counter heapAllocations;
+		Counter arenaAllocations;
+		Counter allocatedBytes;
+		Counter numbersCreated;
+		/// the operations running on the thread, not a counter, so clear () keeps it
+		unsigned int depth = 0;
+
+		Counters ()
+		{
+			clear ();
+		}
+
+		void clear ()
+		{
+			for (int i = 0; i < operationCount; ++i)
+			{
+				calls[i].store (0, std::memory_order_relaxed);
+				limbs[i].store (0, std::memory_order_relaxed);
+				cycles[i].store (0, std::memory_order_relaxed);
+			}
+			for (int i = 0; i < tierCount; ++i)
+			{
+				tiers[i].store (0, std::memory_order_relaxed);
+			}
+			heapAllocations.store (0, std::memory_order_relaxed);
+			arenaAllocations.store (0, std::memory_order_relaxed);
+			allocatedBytes.store (0, std::memory_order_relaxed);
+			numbersCreated.store (0, std::memory_order_relaxed);
+		}
+
+		void addTo (Statistics& statistics) const
+		{
+			for (int i = 0; i < operationCount; ++i)
+			{
+				statistics.operations[i].calls += calls[i].load (std::memory_order_relaxed);
+				statistics.operations[i].limbs += limbs[i].load (std::memory_order_relaxed);
+				statistics.operations[i].cycles += cycles[i].load (std::memory_order_relaxed);
+			}
+			for (int i = 0; i < tierCount; ++i)
+			{
+				statistics.tiers[i] += tiers[i].load (std::memory_order_relaxed);
+			}
+			statistics.heapAllocations += heapAllocations.load (std::memory_order_relaxed);
+			statistics.arenaAllocations += arenaAllocations.load (std::memory_order_relaxed);
+			statistics.allocatedBytes += allocatedBytes.load (std::memory_order_relaxed);
+			statistics.numbersCreated += numbersCreated.load (std::memory_order_relaxed);
+		}
+	};
+
+	/// the operations within the scope are counted as part of an outer one
+	class ScopedNesting
+	{
+	public:
+		ScopedNesting ()
+		{
+			++local ().depth;
+		}
+
+		ScopedNesting (const ScopedNesting&) = delete;
+		ScopedNesting& operator= (const ScopedNesting&) = delete;
+
+		~ScopedNesting ()
+		{
+			--local ().depth;
+		}
+	};
+
+	/// the counters of the running threads and the sum of the ended ones
+	struct Registry
+	{
+		std::mutex mutex;
+		std::vector<Counters*> live;
+		Statistics retired;
+	};
+
+	/// registers the counters of a thread while it runs
+	struct Registration
+	{
+		Registration ()
+		{
+			Registry& all = registry ();
+			std::lock_guard<std::mutex> lock (all.mutex);
+			all.live.push_back (&counters);
+		}
+
+		~Registration ()
+		{
+			Registry& all = registry ();
+			std::lock_guard<std::mutex> lock (all.mutex);
+			counters.addTo (all.retired);
+			for (std::size_t i = 0; i < all.live.size (); ++i)
+			{
+				if (all.live[i] == &counters)
+				{
+					all.live[i] = all.live.back ();
+					all.live.pop_back ();
+					break;
+				}
+			}
+		}
+
+		Counters counters;
+	};
+
+	/// never destroyed, threads may end after the static objects are gone
+	static Registry& registry ()
+	{
+		static Registry* all = new Registry ();
+		return *all;
+	}
+
+	static Counters& local ()
+	{
+		static thread_local Registration registration;
+		return registration.counters;
+	}
+
+	static void increment (Counter& counter, std::uint64_t amount)
+	{
+		counter.store (counter.load (std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+	}
+
+	static std::uint64_t cycles ()
+	{
+#if defined(UTILITIES_INSTRUMENTATION_TSC)
+		return __rdtsc ();
+#else
+		return std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+#endif
+	}
+};
+
+}
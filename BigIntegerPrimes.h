@@ -0,0 +1,616 @@
+/*
+ * BigIntegerPrimes.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "BigInteger.h"
+#include "BigIntegerRandom.h"
+#include "BigIntegerRoots.h"
+#include "LimbArena.h"
+#include "ModularContext.h"
+
+namespace Utilities
+{
+
+/**
+ * Probable primes: trial division by a table of small primes, Miller-Rabin and Baillie-PSW tests and the
+ * search for primes. The residues of a number modulo all small primes come from one remainder tree, the
+ * search sieves a window of candidates with them, so only candidates without small factors are tested.
+ * All tests of one candidate share its ModularContext.
+ */
+template <typename BaseType = std::uint64_t>
+class BigIntegerPrimes
+{
+public:
+	typedef BigIntegerBase<BaseType> Number;
+	typedef ModularContext<BaseType> Context;
+
+	/// the odd primes below smallPrimeLimit, used for trial division and sieving
+	static const std::vector<unsigned int>& smallPrimes ()
+	{
+		return table ().primes;
+	}
+
+	/**
+	 * residues[i] = |n| mod smallPrimes ()[i]. n is reduced modulo the nodes of a product tree of the small
+	 * primes which have about its size, the remainders are passed down to the leaves, which are products
+	 * of primes fitting into a machine word.
+	 */
+	static void smallPrimeResidues (const Number& n, std::vector<unsigned int>& residues);
+
+	/// the smallest prime factor of |n| >= 2 below smallPrimeLimit, 0 if there is none
+	static unsigned int trialDivision (const Number& n);
+
+	/// strong probable prime test of the odd modulus n > 3 of context to the base
+	static bool millerRabin (const Context& context, const Number& base);
+
+	/// strong Lucas probable prime test with Selfridge's parameters of the odd modulus n > 3 of context
+	static bool strongLucas (const Context& context);
+
+	/**
+	 * Baillie-PSW: trial division, a strong probable prime test to base 2 and a strong Lucas test. No
+	 * composite number passing it is known, below 2^64 there is none.
+	 */
+	static bool isProbablePrime (const Number& n);
+
+	/// Baillie-PSW and rounds more Miller-Rabin tests to random bases from generator
+	template <typename Generator>
+	static bool isProbablePrime (const Number& n, unsigned int rounds, Generator& generator);
+
+	/// the smallest probable prime above n
+	static Number nextPrime (const Number& n);
+
+	/**
+	 * the next probable prime after a random number of bits bits, repeated until it has bits bits as well.
+	 * Throws std::domain_error for less than 2 bits.
+	 */
+	template <typename Generator>
+	static Number randomPrime (unsigned int bits, Generator& generator);
+
+private:
+	static const unsigned int smallPrimeLimit = 1 << 16;
+
+	/// odd candidates per sieve window of nextPrime, several times the average prime gap of 2048 bit numbers
+	static const unsigned int sieveLength = 1 << 12;
+
+	struct Table
+	{
+		std::vector<unsigned int> primes;
+		/// the primes of leaf i are [leafStart[i], leafStart[i + 1])
+		std::vector<std::size_t> leafStart;
+		/// levels[0] are the leaves, the nodes of levels[k + 1] products of two nodes of levels[k] or a copy of the last one
+		std::vector<std::vector<Number>> levels;
+	};
+
+	/// built once, the numbers live on the global heap
+	static const Table& table ()
+	{
+		static const Table smallPrimeTable = buildTable ();
+		return smallPrimeTable;
+	}
+
+	static Table buildTable ();
+
+	/// true if the small primes decide about n, isPrime is set then
+	static bool decidedBySmallPrimes (const Number& n, bool& isPrime);
+
+	static bool passesBailliePsw (const Context& context)
+	{
+		return millerRabin (context, Number (2L)) && strongLucas (context);
+	}
+
+	/// Jacobi symbol (a / n) for an odd positive n
+	static int jacobi (long long a, const Number& n);
+
+	static int jacobiWord (unsigned long long a, unsigned long long n);
+
+	/// |a| modulo q < 2^32
+	static unsigned long long remainder (const Number& a, unsigned long long q);
+
+	/// the lowest 64 bits of the magnitude
+	static unsigned long long lowBits (const Number& x);
+
+	/// a + b modulo n for a, b in [0, n)
+	static Number addMod (const Number& a, const Number& b, const Number& n)
+	{
+		Number sum = a + b;
+		return (sum < n) ? sum : sum - n;
+	}
+
+	/// a - b modulo n for a, b in [0, n)
+	static Number subMod (const Number& a, const Number& b, const Number& n)
+	{
+		return (b <= a) ? a - b : a + n - b;
+	}
+
+	/// x / 2 modulo the odd n for x in [0, n)
+	static Number halfMod (const Number& x, const Number& n)
+	{
+		Number result = x.isBitSet (0) ? x + n : x;
+		result.shiftRight (1);
+		return result;
+	}
+};
+
+/// Baillie-PSW probable prime test
+template <typename BaseType>
+bool isProbablePrime (const BigIntegerBase<BaseType>& n)
+{
+	return BigIntegerPrimes<BaseType>::isProbablePrime (n);
+}
+
+/// Baillie-PSW and rounds Miller-Rabin tests to random bases
+template <typename BaseType, typename Generator>
+bool isProbablePrime (const BigIntegerBase<BaseType>& n, unsigned int rounds, Generator& generator)
+{
+	return BigIntegerPrimes<BaseType>::isProbablePrime (n, rounds, generator);
+}
+
+/// the smallest probable prime above n
+template <typename BaseType>
+BigIntegerBase<BaseType> nextPrime (const BigIntegerBase<BaseType>& n)
+{
+	return BigIntegerPrimes<BaseType>::nextPrime (n);
+}
+
+/// a random probable prime of exactly bits bits, throws std::domain_error for less than 2 bits
+template <typename BaseType = std::uint64_t, typename Generator>
+BigIntegerBase<BaseType> randomPrime (unsigned int bits, Generator& generator)
+{
+	return BigIntegerPrimes<BaseType>::randomPrime (bits, generator);
+}
+
+template <typename BaseType>
+void BigIntegerPrimes<BaseType>::smallPrimeResidues (const Number& n, std::vector<unsigned int>& residues)
+{
+	const Table& primeTable = table ();
+	residues.assign (primeTable.primes.size (), 0);
+	Number x (n);
+	x._isPositive = true;
+	// the lowest level with nodes of about the size of x, the nodes of one level have about the same size
+	unsigned int bits = x.bitLength ();
+	std::size_t level = 0;
+	while ((level + 1 < primeTable.levels.size ()) && (primeTable.levels[level + 1][0].bitLength () <= bits))
+	{
+		++level;
+	}
+	std::vector<Number> remainders (primeTable.levels[level].size ());
+	for (std::size_t i = 0; i < remainders.size (); ++i)
+	{
+		remainders[i] = x % primeTable.levels[level][i];
+	}
+	for (; level > 0; --level)
+	{
+		const std::vector<Number>& children = primeTable.levels[level - 1];
+		std::vector<Number> next (children.size ());
+		for (std::size_t i = 0; i < children.size (); ++i)
+		{
+			next[i] = remainders[i / 2] % children[i];
+		}
+		remainders.swap (next);
+	}
+	for (std::size_t leaf = 0; leaf < remainders.size (); ++leaf)
+	{
+		unsigned long long leafRemainder = lowBits (remainders[leaf]);
+		for (std::size_t i = primeTable.leafStart[leaf]; i < primeTable.leafStart[leaf + 1]; ++i)
+		{
+			residues[i] = (unsigned int) (leafRemainder % primeTable.primes[i]);
+		}
+	}
+}
+
+template <typename BaseType>
+unsigned int BigIntegerPrimes<BaseType>::trialDivision (const Number& n)
+{
+	if (n.getRealSize () == 0)
+	{
+		return 0;
+	}
+	if (!n.isBitSet (0))
+	{
+		return 2;
+	}
+	const std::vector<unsigned int>& primes = smallPrimes ();
+	if (n.bitLength () <= 64)
+	{
+		unsigned long long word = lowBits (n);
+		for (unsigned int p : primes)
+		{
+			if ((unsigned long long) p * p > word)
+			{
+				// word is a prime itself
+				return (word < smallPrimeLimit) ? (unsigned int) word : 0;
+			}
+			if (word % p == 0)
+			{
+				return p;
+			}
+		}
+		return 0;
+	}
+	std::vector<unsigned int> residues;
+	smallPrimeResidues (n, residues);
+	for (std::size_t i = 0; i < residues.size (); ++i)
+	{
+		if (residues[i] == 0)
+		{
+			return primes[i];
+		}
+	}
+	return 0;
+}
+
+template <typename BaseType>
+bool BigIntegerPrimes<BaseType>::millerRabin (const Context& context, const Number& base)
+{
+	const Number& n = context.getModulus ();
+	Number one (1L);
+	Number nMinusOne = n - one;
+	unsigned int twos = nMinusOne.countTrailingZeros ();
+	Number x = context.powmod (base, nMinusOne >> twos);
+	if ((x == one) || (x == nMinusOne))
+	{
+		return true;
+	}
+	for (unsigned int i = 1; i < twos; ++i)
+	{
+		x = context.mulmod (x, x);
+		if (x == nMinusOne)
+		{
+			return true;
+		}
+		if (x == one)
+		{
+			return false;
+		}
+	}
+	return false;
+}
+
+template <typename BaseType>
+bool BigIntegerPrimes<BaseType>::strongLucas (const Context& context)
+{
+	const Number& n = context.getModulus ();
+	// Selfridge: the first D of 5, -7, 9, -11, ... with (D / n) = -1, squares have none
+	long long d = 5;
+	for (unsigned int tries = 0; ; ++tries)
+	{
+		int symbol = jacobi (d, n);
+		if (symbol == -1)
+		{
+			break;
+		}
+		if ((symbol == 0) && !(n == Number ((long) (d < 0 ? -d : d))))
+		{
+			return false;
+		}
+		if ((tries == 8) && isPerfectSquare (n))
+		{
+			return false;
+		}
+		d = (d > 0) ? -(d + 2) : -d + 2;
+	}
+	// P = 1 and Q = (1 - D) / 4, all values in the Montgomery form of context
+	Number k = n + Number (1L);
+	unsigned int twos = k.countTrailingZeros ();
+	k.shiftRight (twos);
+	Number dForm = context.toMontgomery (Number ((long) d));
+	Number qForm = context.toMontgomery (Number ((long) ((1 - d) / 4)));
+	Number u = context.toMontgomery (Number (1L));
+	Number v = u;
+	Number qPower = qForm;
+	// U_k, V_k and Q^k from the top bit of k on
+	for (int bit = (int) k.bitLength () - 2; bit >= 0; --bit)
+	{
+		// U_2k = U_k V_k, V_2k = V_k^2 - 2 Q^k
+		u = context.montgomeryMultiply (u, v);
+		v = subMod (context.montgomeryMultiply (v, v), addMod (qPower, qPower, n), n);
+		qPower = context.montgomeryMultiply (qPower, qPower);
+		if (k.isBitSet (bit))
+		{
+			// U_k+1 = (P U_k + V_k) / 2, V_k+1 = (D U_k + P V_k) / 2
+			Number du = context.montgomeryMultiply (dForm, u);
+			u = halfMod (addMod (u, v, n), n);
+			v = halfMod (addMod (du, v, n), n);
+			qPower = context.montgomeryMultiply (qPower, qForm);
+		}
+	}
+	if ((u.bitLength () == 0) || (v.bitLength () == 0))
+	{
+		return true;
+	}
+	for (unsigned int i = 1; i < twos; ++i)
+	{
+		v = subMod (context.montgomeryMultiply (v, v), addMod (qPower, qPower, n), n);
+		if (v.bitLength () == 0)
+		{
+			return true;
+		}
+		qPower = context.montgomeryMultiply (qPower, qPower);
+	}
+	return false;
+}
+
+template <typename BaseType>
+bool BigIntegerPrimes<BaseType>::isProbablePrime (const Number& n)
+{
+	bool isPrime;
+	if (decidedBySmallPrimes (n, isPrime))
+	{
+		return isPrime;
+	}
+	Context context (n);
+	return passesBailliePsw (context);
+}
+
+template <typename BaseType>
+template <typename Generator>
+bool BigIntegerPrimes<BaseType>::isProbablePrime (const Number& n, unsigned int rounds, Generator& generator)
+{
+	bool isPrime;
+	if (decidedBySmallPrimes (n, isPrime))
+	{
+		return isPrime;
+	}
+	Context context (n);
+	if (!passesBailliePsw (context))
+	{
+		return false;
+	}
+	// bases in [2, n - 2]
+	Number baseCount = n - Number (3L);
+	for (unsigned int round = 0; round < rounds; ++round)
+	{
+		if (!millerRabin (context, BigIntegerRandom<BaseType>::randomBelow (baseCount, generator) + Number (2L)))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerPrimes<BaseType>::nextPrime (const Number& n)
+{
+	if (!n.isPositive () || (n.bitLength () <= 1))
+	{
+		return Number (2L);
+	}
+	Number candidate = n + Number (n.isBitSet (0) ? 2L : 1L);
+	const std::vector<unsigned int>& primes = smallPrimes ();
+	if ((candidate.bitLength () <= 32) && (lowBits (candidate) <= primes.back ()))
+	{
+		return Number ((long) *std::lower_bound (primes.begin (), primes.end (), (unsigned int) lowBits (candidate)));
+	}
+	// candidate + 2j is divisible by p for 2j == -candidate mod p, all candidates are above the small primes
+	std::vector<unsigned int> residues;
+	smallPrimeResidues (candidate, residues);
+	std::vector<bool> isComposite (sieveLength);
+	for (;;)
+	{
+		std::fill (isComposite.begin (), isComposite.end (), false);
+		for (std::size_t i = 0; i < primes.size (); ++i)
+		{
+			unsigned int p = primes[i];
+			unsigned long long first = (unsigned long long) ((p - residues[i]) % p) * ((p + 1) / 2) % p;
+			for (unsigned long long j = first; j < sieveLength; j += p)
+			{
+				isComposite[j] = true;
+			}
+		}
+		for (unsigned int j = 0; j < sieveLength; ++j)
+		{
+			if (!isComposite[j])
+			{
+				Number x = candidate + Number ((long) 2 * j);
+				Context context (x);
+				if (passesBailliePsw (context))
+				{
+					return x;
+				}
+			}
+		}
+		candidate += Number ((long) 2 * sieveLength);
+		for (std::size_t i = 0; i < primes.size (); ++i)
+		{
+			residues[i] = (unsigned int) ((residues[i] + 2ULL * sieveLength) % primes[i]);
+		}
+	}
+}
+
+template <typename BaseType>
+template <typename Generator>
+BigIntegerBase<BaseType> BigIntegerPrimes<BaseType>::randomPrime (unsigned int bits, Generator& generator)
+{
+	if (bits < 2)
+	{
+		throw std::domain_error("BigIntegerPrimes::randomPrime: primes have at least 2 bits");
+	}
+	for (;;)
+	{
+		Number start = BigIntegerRandom<BaseType>::randomBits (bits - 1, generator);
+		start.setBit (bits - 1);
+		Number prime = nextPrime (start - Number (1L));
+		if (prime.bitLength () == bits)
+		{
+			return prime;
+		}
+	}
+}
+
+template <typename BaseType>
+typename BigIntegerPrimes<BaseType>::Table BigIntegerPrimes<BaseType>::buildTable ()
+{
+	// the table outlives any arena of the caller
+	ScopedLimbArena heap (nullptr);
+	Table primeTable;
+	std::vector<bool> isComposite (smallPrimeLimit, false);
+	for (unsigned int p = 3; p < smallPrimeLimit; p += 2)
+	{
+		if (isComposite[p])
+		{
+			continue;
+		}
+		primeTable.primes.push_back (p);
+		for (unsigned long long multiple = (unsigned long long) p * p; multiple < smallPrimeLimit; multiple += 2 * p)
+		{
+			isComposite[multiple] = true;
+		}
+	}
+	// leaves with the largest products of consecutive primes below 2^64
+	std::vector<Number> leaves;
+	unsigned long long product = 1;
+	for (std::size_t i = 0; i < primeTable.primes.size (); ++i)
+	{
+		unsigned int p = primeTable.primes[i];
+		if (product > std::numeric_limits<unsigned long long>::max () / p)
+		{
+			leaves.push_back (Number ());
+			leaves.back ().setFromNumber (product);
+			product = 1;
+		}
+		if (product == 1)
+		{
+			primeTable.leafStart.push_back (i);
+		}
+		product *= p;
+	}
+	leaves.push_back (Number ());
+	leaves.back ().setFromNumber (product);
+	primeTable.leafStart.push_back (primeTable.primes.size ());
+	primeTable.levels.push_back (leaves);
+	while (primeTable.levels.back ().size () > 1)
+	{
+		const std::vector<Number>& nodes = primeTable.levels.back ();
+		std::vector<Number> parents;
+		for (std::size_t i = 0; i < nodes.size (); i += 2)
+		{
+			parents.push_back ((i + 1 < nodes.size ()) ? nodes[i] * nodes[i + 1] : nodes[i]);
+		}
+		primeTable.levels.push_back (parents);
+	}
+	return primeTable;
+}
+
+template <typename BaseType>
+bool BigIntegerPrimes<BaseType>::decidedBySmallPrimes (const Number& n, bool& isPrime)
+{
+	isPrime = false;
+	if (!n.isPositive () || (n.bitLength () <= 1))
+	{
+		return true;
+	}
+	unsigned int factor = trialDivision (n);
+	if (factor != 0)
+	{
+		isPrime = (n == Number ((long) factor));
+		return true;
+	}
+	// numbers below smallPrimeLimit^2 without a small factor are primes
+	isPrime = (n.bitLength () <= 32);
+	return isPrime;
+}
+
+template <typename BaseType>
+int BigIntegerPrimes<BaseType>::jacobi (long long a, const Number& n)
+{
+	int result = 1;
+	unsigned long long nMod8 = lowBits (n) & 7;
+	unsigned long long x = (unsigned long long) a;
+	if (a < 0)
+	{
+		// (-1 / n) = (-1)^((n - 1) / 2)
+		x = 0 - x;
+		if ((nMod8 & 3) == 3)
+		{
+			result = -result;
+		}
+	}
+	if (x == 0)
+	{
+		return (n == Number (1L)) ? 1 : 0;
+	}
+	while ((x & 1) == 0)
+	{
+		// (2 / n) = -1 for n == 3, 5 mod 8
+		x >>= 1;
+		if ((nMod8 == 3) || (nMod8 == 5))
+		{
+			result = -result;
+		}
+	}
+	// reciprocity for the odd x
+	if (((x & 3) == 3) && ((nMod8 & 3) == 3))
+	{
+		result = -result;
+	}
+	return result * jacobiWord (remainder (n, x), x);
+}
+
+template <typename BaseType>
+int BigIntegerPrimes<BaseType>::jacobiWord (unsigned long long a, unsigned long long n)
+{
+	int result = 1;
+	a %= n;
+	while (a != 0)
+	{
+		while ((a & 1) == 0)
+		{
+			a >>= 1;
+			if (((n & 7) == 3) || ((n & 7) == 5))
+			{
+				result = -result;
+			}
+		}
+		std::swap (a, n);
+		if (((a & 3) == 3) && ((n & 3) == 3))
+		{
+			result = -result;
+		}
+		a %= n;
+	}
+	return (n == 1) ? result : 0;
+}
+
+template <typename BaseType>
+unsigned long long BigIntegerPrimes<BaseType>::remainder (const Number& a, unsigned long long q)
+{
+	// chunks of at most 32 bits, so the shifted remainder stays below 2^64
+	const unsigned int limbBits = sizeof(BaseType) << 3;
+	const unsigned int chunk = (limbBits < 32) ? limbBits : 32;
+	const unsigned long long mask = (1ULL << chunk) - 1;
+	unsigned long long result = 0;
+	for (std::size_t index = a.getRealSize (); index-- > 0;)
+	{
+		BaseType limb = a._bigNumber[index];
+		for (int shift = (int) (limbBits - chunk); shift >= 0; shift -= chunk)
+		{
+			result = ((result << chunk) | ((unsigned long long) (limb >> shift) & mask)) % q;
+		}
+	}
+	return result;
+}
+
+template <typename BaseType>
+unsigned long long BigIntegerPrimes<BaseType>::lowBits (const Number& x)
+{
+	const unsigned int limbBits = sizeof(BaseType) << 3;
+	unsigned long long result = 0;
+	std::size_t size = x.getRealSize ();
+	for (std::size_t index = 0; (index < size) && (index * limbBits < 64); ++index)
+	{
+		result |= (unsigned long long) x._bigNumber[index] << (index * limbBits);
+	}
+	return result;
+}
+
+}
@@ -0,0 +1,347 @@
+/*
+ * BigIntegerRNS.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "BigInteger.h"
+#include "LimbArithmetic.h"
+#include "NumberTheoreticTransform.h"
+#include "ThreadPool.h"
+
+namespace Utilities
+{
+
+/**
+ * The primes of a residue number system: the largest primes between 2^61 and 2^62, as many as signed
+ * numbers of the requested bits need. The primes are NttPrimes, so the residues use their Montgomery
+ * arithmetic; their generators are not needed and left 0.
+ */
+class RnsBasis
+{
+public:
+	/// a basis for all numbers with at most bits bits and their negatives
+	explicit RnsBasis (unsigned int bits) : _bits(bits)
+	{
+		// every prime adds more than 61 bits, the product covers [-2^(bits + 1), 2^(bits + 1))
+		std::size_t count = (bits + 2 + primeBits - 2) / (primeBits - 1);
+		for (std::uint64_t candidate = (1ULL << primeBits) - 1; _primes.size () < count; candidate -= 2)
+		{
+			if (isPrime (candidate))
+			{
+				_primes.push_back (NttPrime (candidate, 0));
+			}
+		}
+		// the product of all primes in 64 bit words
+		_modulus.assign (1, 1);
+		for (const NttPrime& prime : _primes)
+		{
+			_modulus.push_back (Words::mulLimb (_modulus.data (), _modulus.data (), _modulus.size (), prime.getModulus ()));
+		}
+	}
+
+	RnsBasis (const RnsBasis&) = delete;
+	RnsBasis& operator= (const RnsBasis&) = delete;
+
+	/// numbers of this many bits are represented exactly, larger results wrap around modulo the product of the primes
+	unsigned int bits () const
+	{
+		return _bits;
+	}
+
+	std::size_t size () const
+	{
+		return _primes.size ();
+	}
+
+	const NttPrime& prime (std::size_t index) const
+	{
+		return _primes[index];
+	}
+
+	/// the product of all primes, least significant 64 bit word first
+	const std::vector<std::uint64_t>& modulus () const
+	{
+		return _modulus;
+	}
+
+private:
+	typedef LimbArithmetic<std::uint64_t> Words;
+
+	static const unsigned int primeBits = 62;
+
+	/// deterministic Miller-Rabin for 64 bit numbers with the bases of Jim Sinclair
+	static bool isPrime (std::uint64_t candidate)
+	{
+		static const unsigned int smallPrimes[] = {3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47};
+		for (unsigned int p : smallPrimes)
+		{
+			if (candidate % p == 0)
+			{
+				return false;
+			}
+		}
+		static const std::uint64_t bases[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+		NttPrime arithmetic (candidate, 0);
+		std::uint64_t oddPart = candidate - 1;
+		unsigned int twos = 0;
+		for (; (oddPart & 1) == 0; oddPart >>= 1)
+		{
+			++twos;
+		}
+		std::uint64_t one = arithmetic.toMontgomery (1);
+		std::uint64_t minusOne = arithmetic.toMontgomery (candidate - 1);
+		for (std::uint64_t base : bases)
+		{
+			std::uint64_t x = arithmetic.power (arithmetic.toMontgomery (base), oddPart);
+			if ((x == one) || (x == minusOne) || (x == 0))
+			{
+				continue;
+			}
+			unsigned int i = 1;
+			for (; i < twos; ++i)
+			{
+				x = arithmetic.multiply (x, x);
+				if (x == minusOne)
+				{
+					break;
+				}
+			}
+			if (i == twos)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	unsigned int _bits;
+	std::vector<NttPrime> _primes;
+	std::vector<std::uint64_t> _modulus;
+};
+
+/**
+ * A signed number as its residues modulo the primes of an RnsBasis, in Montgomery form. Addition,
+ * subtraction and multiplication work on every residue on its own, without any carries, so long chains
+ * of products cost linear time per operation; only the conversions are quadratic. Results outside the
+ * range of the basis wrap around like FixedBigInteger. The basis has to outlive the numbers, operands
+ * of different bases throw std::invalid_argument.
+ */
+class BigIntegerRNS
+{
+public:
+	/// zero
+	explicit BigIntegerRNS (const RnsBasis& basis) : _basis(&basis), _residues(basis.size (), 0)
+	{
+	}
+
+	/**
+	 * the residues of number, throws std::out_of_range if it has more bits than the basis covers. With a
+	 * pool the primes are handled in parallel.
+	 */
+	template <typename BaseType>
+	BigIntegerRNS (const RnsBasis& basis, const BigIntegerBase<BaseType>& number, ThreadPool* pool = nullptr);
+
+	const RnsBasis& basis () const
+	{
+		return *_basis;
+	}
+
+	/// the residue modulo basis ().prime (index), not in Montgomery form
+	std::uint64_t residue (std::size_t index) const
+	{
+		return _basis->prime (index).fromMontgomery (_residues[index]);
+	}
+
+	/// the number in the range [-M / 2, M / 2) of the product M of the primes, by Garner's algorithm
+	template <typename BaseType = std::uint64_t>
+	BigIntegerBase<BaseType> toBigInteger () const;
+
+	BigIntegerRNS& operator+= (const BigIntegerRNS& rhs)
+	{
+		checkBasis (rhs);
+		for (std::size_t i = 0; i < _residues.size (); ++i)
+		{
+			_residues[i] = _basis->prime (i).add (_residues[i], rhs._residues[i]);
+		}
+		return *this;
+	}
+
+	BigIntegerRNS operator+ (const BigIntegerRNS& rhs) const
+	{
+		BigIntegerRNS result (*this);
+		return result += rhs;
+	}
+
+	BigIntegerRNS& operator-= (const BigIntegerRNS& rhs)
+	{
+		checkBasis (rhs);
+		for (std::size_t i = 0; i < _residues.size (); ++i)
+		{
+			_residues[i] = _basis->prime (i).sub (_residues[i], rhs._residues[i]);
+		}
+		return *this;
+	}
+
+	BigIntegerRNS operator- (const BigIntegerRNS& rhs) const
+	{
+		BigIntegerRNS result (*this);
+		return result -= rhs;
+	}
+
+	BigIntegerRNS operator- () const
+	{
+		return BigIntegerRNS (*_basis) - *this;
+	}
+
+	BigIntegerRNS& operator*= (const BigIntegerRNS& rhs)
+	{
+		checkBasis (rhs);
+		for (std::size_t i = 0; i < _residues.size (); ++i)
+		{
+			_residues[i] = _basis->prime (i).multiply (_residues[i], rhs._residues[i]);
+		}
+		return *this;
+	}
+
+	BigIntegerRNS operator* (const BigIntegerRNS& rhs) const
+	{
+		BigIntegerRNS result (*this);
+		return result *= rhs;
+	}
+
+	bool operator== (const BigIntegerRNS& rhs) const
+	{
+		checkBasis (rhs);
+		return _residues == rhs._residues;
+	}
+
+private:
+	typedef LimbArithmetic<std::uint64_t> Words;
+
+	/// primes per task if a pool is used
+	static const std::size_t parallelGrain = 16;
+
+	void checkBasis (const BigIntegerRNS& rhs) const
+	{
+		if (_basis != rhs._basis)
+		{
+			throw std::invalid_argument("BigIntegerRNS: the operands have different bases");
+		}
+	}
+
+	/// a value below 2^62 modulo one of the primes, which are all above 2^61
+	static std::uint64_t reduceOnce (std::uint64_t value, std::uint64_t modulus)
+	{
+		return (value >= modulus) ? value - modulus : value;
+	}
+
+	static int compare (const std::vector<std::uint64_t>& a, const std::vector<std::uint64_t>& b)
+	{
+		for (std::size_t i = a.size (); i-- > 0;)
+		{
+			if (a[i] != b[i])
+			{
+				return (a[i] < b[i]) ? -1 : 1;
+			}
+		}
+		return 0;
+	}
+
+	const RnsBasis* _basis;
+	std::vector<std::uint64_t> _residues;
+};
+
+template <typename BaseType>
+BigIntegerRNS::BigIntegerRNS (const RnsBasis& basis, const BigIntegerBase<BaseType>& number, ThreadPool* pool)
+	: _basis(&basis), _residues(basis.size (), 0)
+{
+	if (number.bitLength () > basis.bits ())
+	{
+		throw std::out_of_range("BigIntegerRNS: the number has more bits than the basis covers");
+	}
+	std::vector<std::uint64_t> words (number.exportWordCount (sizeof(std::uint64_t)));
+	number.exportLimbs (words.data (), sizeof(std::uint64_t));
+	bool isNegative = !number.isPositive ();
+	auto convert = [&] (std::size_t begin, std::size_t end)
+	{
+		for (std::size_t i = begin; i < end; ++i)
+		{
+			// Horner's scheme with radix 2^64 in Montgomery form: (r 2^64 + word) R = toMontgomery (r R) + toMontgomery (word)
+			const NttPrime& prime = basis.prime (i);
+			std::uint64_t value = 0;
+			for (std::size_t j = words.size (); j-- > 0;)
+			{
+				value = prime.add (prime.toMontgomery (value), prime.toMontgomery (words[j]));
+			}
+			_residues[i] = isNegative ? prime.sub (0, value) : value;
+		}
+	};
+	if ((pool == nullptr) || (basis.size () < 2 * parallelGrain))
+	{
+		convert (0, basis.size ());
+	}
+	else
+	{
+		pool->parallelFor (basis.size (), parallelGrain, convert);
+	}
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerRNS::toBigInteger () const
+{
+	// Garner: the number is v_0 + v_1 p_0 + v_2 p_0 p_1 + ... with digits v_i < p_i. sums[i] is the part
+	// of the digits found so far modulo p_i, products[i] the product of the primes so far in Montgomery form
+	const std::size_t count = _residues.size ();
+	std::vector<std::uint64_t> digits (count);
+	std::vector<std::uint64_t> sums (count, 0);
+	std::vector<std::uint64_t> products (count);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		products[i] = _basis->prime (i).toMontgomery (1);
+	}
+	for (std::size_t j = 0; j < count; ++j)
+	{
+		const NttPrime& prime = _basis->prime (j);
+		// multiplying a plain value with a Montgomery one gives a plain one
+		std::uint64_t inverse = prime.inverse (products[j]);
+		digits[j] = prime.multiply (prime.sub (residue (j), sums[j]), inverse);
+		std::uint64_t p = prime.getModulus ();
+		for (std::size_t i = j + 1; i < count; ++i)
+		{
+			const NttPrime& other = _basis->prime (i);
+			std::uint64_t q = other.getModulus ();
+			sums[i] = other.add (sums[i], other.multiply (reduceOnce (digits[j], q), products[i]));
+			products[i] = other.multiply (products[i], other.toMontgomery (reduceOnce (p, q)));
+		}
+	}
+	// the digits in radix p_i by Horner's scheme, the value stays below M
+	std::vector<std::uint64_t> words (count + 2, 0);
+	std::size_t size = 1;
+	for (std::size_t j = count; j-- > 0;)
+	{
+		words[size] = Words::mulLimb (words.data (), words.data (), size, _basis->prime (j).getModulus ());
+		words[size + 1] = Words::addLimb (words.data (), words.data (), size + 1, digits[j]);
+		size = std::max (Words::normalizedSize (words.data (), size + 2), (std::size_t) 1);
+	}
+	// the numbers above M / 2 are negative: M - x < x
+	words.resize (_basis->modulus ().size (), 0);
+	std::vector<std::uint64_t> complement (words.size ());
+	Words::subN (complement.data (), _basis->modulus ().data (), words.data (), words.size ());
+	bool isNegative = (compare (complement, words) < 0);
+	const std::vector<std::uint64_t>& magnitude = isNegative ? complement : words;
+	BigIntegerBase<BaseType> result;
+	result.importLimbs (magnitude.data (), Words::normalizedSize (magnitude.data (), magnitude.size ()), sizeof(std::uint64_t),
+			WordOrder::LeastSignificantFirst, ByteOrder::Native, isNegative);
+	return result;
+}
+
+}
@@ -0,0 +1,113 @@
+/*
+ * BigIntegerRandom.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "BigInteger.h"
+
+namespace Utilities
+{
+
+/**
+ * Uniformly distributed random numbers from any uniform random bit generator of the standard library
+ * kind (std::mt19937_64, std::random_device, ...). The generator is passed in, so the caller decides
+ * about its quality and seeding.
+ */
+template <typename BaseType = std::uint64_t>
+class BigIntegerRandom
+{
+public:
+	typedef BigIntegerBase<BaseType> Number;
+
+	/// uniform in [0, 2^bits)
+	template <typename Generator>
+	static Number randomBits (unsigned int bits, Generator& generator);
+
+	/// uniform in [0, bound) by rejection of numbers with the bits of bound, throws std::domain_error if bound is not positive
+	template <typename Generator>
+	static Number randomBelow (const Number& bound, Generator& generator);
+
+	/// uniform in [low, high], throws std::domain_error if high < low
+	template <typename Generator>
+	static Number randomRange (const Number& low, const Number& high, Generator& generator);
+};
+
+/// uniform in [0, 2^bits)
+template <typename BaseType = std::uint64_t, typename Generator>
+BigIntegerBase<BaseType> randomBits (unsigned int bits, Generator& generator)
+{
+	return BigIntegerRandom<BaseType>::randomBits (bits, generator);
+}
+
+/// uniform in [0, bound), throws std::domain_error if bound is not positive
+template <typename BaseType, typename Generator>
+BigIntegerBase<BaseType> randomBelow (const BigIntegerBase<BaseType>& bound, Generator& generator)
+{
+	return BigIntegerRandom<BaseType>::randomBelow (bound, generator);
+}
+
+/// uniform in [low, high], throws std::domain_error if high < low
+template <typename BaseType, typename Generator>
+BigIntegerBase<BaseType> randomRange (const BigIntegerBase<BaseType>& low, const BigIntegerBase<BaseType>& high, Generator& generator)
+{
+	return BigIntegerRandom<BaseType>::randomRange (low, high, generator);
+}
+
+template <typename BaseType>
+template <typename Generator>
+BigIntegerBase<BaseType> BigIntegerRandom<BaseType>::randomBits (unsigned int bits, Generator& generator)
+{
+	// the distribution takes as many values of the generator as it needs for 64 bits
+	std::uniform_int_distribution<unsigned long long> wordDistribution;
+	std::vector<unsigned long long> words ((bits + 63) / 64);
+	for (unsigned long long& word : words)
+	{
+		word = wordDistribution (generator);
+	}
+	if ((bits % 64) != 0)
+	{
+		words.back () &= (1ULL << (bits % 64)) - 1;
+	}
+	Number result;
+	result.importLimbs (words.data (), words.size (), sizeof(unsigned long long));
+	return result;
+}
+
+template <typename BaseType>
+template <typename Generator>
+BigIntegerBase<BaseType> BigIntegerRandom<BaseType>::randomBelow (const Number& bound, Generator& generator)
+{
+	if (!bound.isPositive () || (bound.bitLength () == 0))
+	{
+		throw std::domain_error("BigIntegerRandom::randomBelow: the bound has to be positive");
+	}
+	// every try succeeds with a probability above 1 / 2
+	unsigned int bits = bound.bitLength ();
+	Number result = randomBits (bits, generator);
+	while (!(result < bound))
+	{
+		result = randomBits (bits, generator);
+	}
+	return result;
+}
+
+template <typename BaseType>
+template <typename Generator>
+BigIntegerBase<BaseType> BigIntegerRandom<BaseType>::randomRange (const Number& low, const Number& high, Generator& generator)
+{
+	if (high < low)
+	{
+		throw std::domain_error("BigIntegerRandom::randomRange: empty range");
+	}
+	return low + randomBelow (high - low + Number (1L), generator);
+}
+
+}
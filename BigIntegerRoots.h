@@ -0,0 +1,544 @@
+/*
+ * BigIntegerRoots.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include "BigInteger.h"
+
+namespace Utilities
+{
+
+/**
+ * Integer roots of big integers. Square roots use Newton steps at doubling precision, each step divides
+ * the top bits of the number by the root found so far, so the whole root costs about as much as the last
+ * division. n-th roots take the root of the upper half of the bits recursively and refine it with Newton
+ * steps from above. Numbers with at most 64 bits are handled in machine words.
+ */
+template <typename BaseType = std::uint64_t>
+class BigIntegerRoots
+{
+public:
+	typedef BigIntegerBase<BaseType> Number;
+
+	/// floor (sqrt (a)), remainder is set to a - root^2. Throws std::domain_error for negative a.
+	static Number sqrtRem (const Number& a, Number& remainder);
+
+	/**
+	 * the n-th root of a rounded towards zero, remainder is set to a - root^n and has the sign of a.
+	 * Throws std::domain_error for n == 0 or negative a with even n.
+	 */
+	static Number rootRem (const Number& a, unsigned int n, Number& remainder);
+
+	/**
+	 * tells if a == root^exponent for some exponent >= 2 and sets root and the largest such exponent.
+	 * 0 and 1 are squares, -1 is a cube.
+	 */
+	static bool perfectPower (const Number& a, Number& root, unsigned int& exponent);
+
+private:
+	static const unsigned int limbBits = sizeof(BaseType) << 3;
+
+	/// the small primes q == 1 mod p tested for a p-th power residue before a root is computed
+	static const unsigned int residueTests = 4;
+
+	/// the moduli of the residue tests stay below this, so all products fit into 64 bits
+	static const unsigned long long residueLimit = 1ULL << 32;
+
+	/// the square root of a positive number and its remainder
+	static Number sqrtMagnitude (const Number& a, Number& remainder);
+
+	/// the n-th root of a positive number for n > 2, rounded down
+	static Number rootMagnitude (const Number& a, unsigned int n);
+
+	/// sets root if the positive a == odd * 2^zeros is a p-th power for the prime p
+	static bool exactRoot (const Number& a, const Number& odd, unsigned int zeros, unsigned int p, Number& root);
+
+	/**
+	 * false if a is no p-th power modulo some small primes q == 1 mod p. For those the p-th powers are a
+	 * subgroup of index p, so every test rules out all but about 1 / p of the other numbers.
+	 */
+	static bool isPowerResidue (const Number& a, unsigned int p);
+
+	/// floor (a^(1 / n)) in machine words
+	static unsigned long long smallRoot (unsigned long long a, unsigned int n);
+
+	/// x^n > limit without overflow
+	static bool exceedsPower (unsigned long long x, unsigned int n, unsigned long long limit);
+
+	/// the lowest 64 bits of the magnitude
+	static unsigned long long lowBits (const Number& x);
+
+	/// log2 of the positive x from its top 64 bits
+	static long double log2 (const Number& x)
+	{
+		unsigned int bits = x.bitLength ();
+		unsigned int shift = (bits > 64) ? bits - 64 : 0;
+		return std::log2 ((long double) lowBits (x.extractBits (shift, 64))) + shift;
+	}
+
+	/// the inverse of the odd x modulo 2^64
+	static unsigned long long inverseWord (unsigned long long x)
+	{
+		// every Newton step doubles the correct low bits, x is its own inverse modulo 8
+		unsigned long long inverse = x;
+		for (int i = 0; i < 5; ++i)
+		{
+			inverse *= 2 - x * inverse;
+		}
+		return inverse;
+	}
+
+	/// x^exponent modulo 2^64
+	static unsigned long long powWord (unsigned long long x, unsigned long long exponent)
+	{
+		unsigned long long result = 1;
+		for (; exponent > 0; exponent >>= 1)
+		{
+			if ((exponent & 1) != 0)
+			{
+				result *= x;
+			}
+			x *= x;
+		}
+		return result;
+	}
+
+	static Number fromWord (unsigned long long value)
+	{
+		Number result;
+		result.setFromNumber (value);
+		return result;
+	}
+
+	/// the magnitude of a modulo a q < residueLimit
+	static unsigned long long remainder (const Number& a, unsigned long long q);
+
+	static unsigned long long powMod (unsigned long long base, unsigned long long exponent, unsigned long long modulus);
+
+	static bool isSmallPrime (unsigned long long n);
+};
+
+/// floor (sqrt (a)), throws std::domain_error for negative a
+template <typename BaseType>
+BigIntegerBase<BaseType> isqrt (const BigIntegerBase<BaseType>& a)
+{
+	BigIntegerBase<BaseType> remainder;
+	return BigIntegerRoots<BaseType>::sqrtRem (a, remainder);
+}
+
+/// floor (sqrt (a)) and remainder = a - root^2, throws std::domain_error for negative a
+template <typename BaseType>
+BigIntegerBase<BaseType> sqrtRem (const BigIntegerBase<BaseType>& a, BigIntegerBase<BaseType>& remainder)
+{
+	return BigIntegerRoots<BaseType>::sqrtRem (a, remainder);
+}
+
+/// the n-th root of a rounded towards zero, throws std::domain_error for n == 0 or negative a with even n
+template <typename BaseType>
+BigIntegerBase<BaseType> iroot (const BigIntegerBase<BaseType>& a, unsigned int n)
+{
+	BigIntegerBase<BaseType> remainder;
+	return BigIntegerRoots<BaseType>::rootRem (a, n, remainder);
+}
+
+/// the n-th root of a rounded towards zero and remainder = a - root^n
+template <typename BaseType>
+BigIntegerBase<BaseType> rootRem (const BigIntegerBase<BaseType>& a, unsigned int n, BigIntegerBase<BaseType>& remainder)
+{
+	return BigIntegerRoots<BaseType>::rootRem (a, n, remainder);
+}
+
+template <typename BaseType>
+bool isPerfectSquare (const BigIntegerBase<BaseType>& a)
+{
+	BigIntegerBase<BaseType> remainder;
+	if (!a.isPositive () && (a.bitLength () > 0))
+	{
+		return false;
+	}
+	BigIntegerRoots<BaseType>::sqrtRem (a, remainder);
+	return remainder.bitLength () == 0;
+}
+
+/// tells if a == root^exponent for some exponent >= 2
+template <typename BaseType>
+bool isPerfectPower (const BigIntegerBase<BaseType>& a)
+{
+	BigIntegerBase<BaseType> root;
+	unsigned int exponent;
+	return BigIntegerRoots<BaseType>::perfectPower (a, root, exponent);
+}
+
+/// tells if a == root^exponent for some exponent >= 2 and sets root and the largest such exponent
+template <typename BaseType>
+bool isPerfectPower (const BigIntegerBase<BaseType>& a, BigIntegerBase<BaseType>& root, unsigned int& exponent)
+{
+	return BigIntegerRoots<BaseType>::perfectPower (a, root, exponent);
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerRoots<BaseType>::sqrtRem (const Number& a, Number& remainder)
+{
+	if (a.getRealSize () == 0)
+	{
+		remainder = Number ();
+		return Number ();
+	}
+	if (!a._isPositive)
+	{
+		throw std::domain_error("sqrtRem: negative number");
+	}
+	return sqrtMagnitude (a, remainder);
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerRoots<BaseType>::rootRem (const Number& a, unsigned int n, Number& remainder)
+{
+	if (n == 0)
+	{
+		throw std::domain_error("rootRem: there is no 0-th root");
+	}
+	bool isNegative = !a._isPositive && (a.getRealSize () > 0);
+	if (isNegative && (n % 2 == 0))
+	{
+		throw std::domain_error("rootRem: even root of a negative number");
+	}
+	Number magnitude (a);
+	magnitude._isPositive = true;
+	Number root;
+	if ((n == 1) || (magnitude.getRealSize () == 0))
+	{
+		root = magnitude;
+		remainder = Number ();
+	}
+	else if (n == 2)
+	{
+		root = sqrtMagnitude (magnitude, remainder);
+	}
+	else
+	{
+		root = rootMagnitude (magnitude, n);
+		remainder = magnitude - root.pow (n);
+	}
+	if (isNegative)
+	{
+		root._isPositive = (root.getRealSize () == 0);
+		remainder._isPositive = (remainder.getRealSize () == 0);
+	}
+	return root;
+}
+
+template <typename BaseType>
+bool BigIntegerRoots<BaseType>::perfectPower (const Number& a, Number& root, unsigned int& exponent)
+{
+	bool isNegative = !a._isPositive && (a.getRealSize () > 0);
+	Number x (a);
+	x._isPositive = true;
+	if (x.bitLength () <= 1)
+	{
+		root = a;
+		exponent = isNegative ? 3 : 2;
+		return true;
+	}
+	// x^total == |a|, every found root is reduced further starting with the same prime
+	unsigned int total = 1;
+	std::vector<bool> isComposite (x.bitLength (), false);
+	Number candidate;
+	unsigned int zeros = x.countTrailingZeros ();
+	Number odd = x >> zeros;
+	unsigned int p = 2;
+	while (p < x.bitLength ())
+	{
+		if (isComposite[p])
+		{
+			++p;
+			continue;
+		}
+		// the power of two in a p-th power is a p-th power as well
+		if (((zeros == 0) || (zeros % p == 0)) && exactRoot (x, odd, zeros, p, candidate))
+		{
+			swap (x, candidate);
+			total *= p;
+			zeros = x.countTrailingZeros ();
+			odd = x >> zeros;
+			continue;
+		}
+		for (std::size_t multiple = (std::size_t) p * p; multiple < isComposite.size (); multiple += p)
+		{
+			isComposite[multiple] = true;
+		}
+		++p;
+	}
+	if (isNegative)
+	{
+		// only odd exponents work for negative numbers, the factors 2 go into the root
+		while (total % 2 == 0)
+		{
+			total /= 2;
+			x = x.square ();
+		}
+		x._isPositive = false;
+	}
+	if (total == 1)
+	{
+		return false;
+	}
+	swap (root, x);
+	exponent = total;
+	return true;
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerRoots<BaseType>::sqrtMagnitude (const Number& a, Number& remainder)
+{
+	unsigned int bits = a.bitLength ();
+	if (bits <= 64)
+	{
+		unsigned long long value = lowBits (a);
+		unsigned long long root = smallRoot (value, 2);
+		remainder = fromWord (value - root * root);
+		return fromWord (root);
+	}
+	// Newton steps at increasing precision: after the step for d the root has d + 1 bits and is the
+	// square root of the top bits of a within one, d runs through the prefixes of the bits of c
+	unsigned int c = (bits - 1) / 2;
+	int s = 0;
+	while ((c >> (s + 1)) > 0)
+	{
+		++s;
+	}
+	unsigned int d = 0;
+	unsigned long long wordRoot = 1;
+	for (; (s >= 0) && ((c >> s) <= 31); --s)
+	{
+		unsigned int e = d;
+		d = c >> s;
+		unsigned long long top = lowBits (a.extractBits (2 * c - e - d + 1, 2 * d + 2));
+		wordRoot = (wordRoot << (d - e - 1)) + top / wordRoot;
+	}
+	Number root = fromWord (wordRoot);
+	for (; s >= 0; --s)
+	{
+		unsigned int e = d;
+		d = c >> s;
+		Number top (a);
+		top.shiftRight (2 * c - e - d + 1);
+		top /= root;
+		root.shiftLeft (d - e - 1);
+		root += top;
+	}
+	// the root is now exact or one too large
+	remainder = a - root.square ();
+	if (!remainder._isPositive && (remainder.getRealSize () > 0))
+	{
+		root -= Number (1L);
+		remainder += root;
+		remainder += root;
+		remainder += Number (1L);
+	}
+	return root;
+}
+
+template <typename BaseType>
+BigIntegerBase<BaseType> BigIntegerRoots<BaseType>::rootMagnitude (const Number& a, unsigned int n)
+{
+	unsigned int bits = a.bitLength ();
+	if (bits <= 64)
+	{
+		return fromWord (smallRoot (lowBits (a), n));
+	}
+	if (n >= bits)
+	{
+		return Number (1L);
+	}
+	// the root has at most rootBits bits, the root of the top bits gives the upper half of them
+	unsigned int rootBits = (bits + n - 1) / n;
+	unsigned int shift = rootBits / 2;
+	Number top (a);
+	top.shiftRight (n * shift);
+	Number root = rootMagnitude (top, n) + Number (1L);
+	root.shiftLeft (shift);
+	// Newton steps x = ((n - 1) x + a / x^(n - 1)) / n decrease from above until they reach the root
+	Number nMinusOne ((long) n - 1);
+	Number nNumber ((long) n);
+	while (true)
+	{
+		Number next = a / root.pow (n - 1);
+		addmul (next, root, nMinusOne);
+		next /= nNumber;
+		if (next >= root)
+		{
+			return root;
+		}
+		swap (root, next);
+	}
+}
+
+template <typename BaseType>
+bool BigIntegerRoots<BaseType>::exactRoot (const Number& a, const Number& odd, unsigned int zeros, unsigned int p, Number& root)
+{
+	if (p == 2)
+	{
+		// odd squares are 1 mod 8
+		if ((lowBits (odd) & 7) != 1)
+		{
+			return false;
+		}
+	}
+	else if ((odd.bitLength () - 1) / p < 64)
+	{
+		// an odd number has exactly one p-th root modulo 2^64, for a root with at most 64 bits that is the
+		// root itself. Its size is checked against the logarithm before the full power is computed.
+		unsigned long long oddRoot = powWord (lowBits (odd), inverseWord (p));
+		if (std::fabs (p * std::log2 ((long double) oddRoot) - log2 (odd)) > 1e-6L)
+		{
+			return false;
+		}
+		root = fromWord (oddRoot);
+		if (!(root.pow (p) == odd))
+		{
+			return false;
+		}
+		root.shiftLeft (zeros / p);
+		return true;
+	}
+	if (!isPowerResidue (a, p))
+	{
+		return false;
+	}
+	Number remainder;
+	root = rootRem (a, p, remainder);
+	return remainder.getRealSize () == 0;
+}
+
+template <typename BaseType>
+bool BigIntegerRoots<BaseType>::isPowerResidue (const Number& a, unsigned int p)
+{
+	unsigned int tests = 0;
+	for (unsigned long long q = 2ULL * p + 1; (q < residueLimit) && (tests < residueTests); q += 2ULL * p)
+	{
+		if (!isSmallPrime (q))
+		{
+			continue;
+		}
+		unsigned long long r = remainder (a, q);
+		if ((r != 0) && (powMod (r, (q - 1) / p, q) != 1))
+		{
+			return false;
+		}
+		++tests;
+	}
+	return true;
+}
+
+template <typename BaseType>
+unsigned long long BigIntegerRoots<BaseType>::smallRoot (unsigned long long a, unsigned int n)
+{
+	if ((n == 1) || (a < 2))
+	{
+		return a;
+	}
+	if (n >= 64)
+	{
+		return 1;
+	}
+	// the floating point estimate is off by a few units at most
+	unsigned long long root = (unsigned long long) std::pow ((long double) a, 1.0L / n);
+	while ((root > 1) && exceedsPower (root, n, a))
+	{
+		--root;
+	}
+	while (!exceedsPower (root + 1, n, a))
+	{
+		++root;
+	}
+	return root;
+}
+
+template <typename BaseType>
+bool BigIntegerRoots<BaseType>::exceedsPower (unsigned long long x, unsigned int n, unsigned long long limit)
+{
+	unsigned long long power = 1;
+	for (unsigned int i = 0; i < n; ++i)
+	{
+		if (power > limit / x)
+		{
+			return true;
+		}
+		power *= x;
+	}
+	return power > limit;
+}
+
+template <typename BaseType>
+unsigned long long BigIntegerRoots<BaseType>::lowBits (const Number& x)
+{
+	unsigned long long result = 0;
+	std::size_t size = x.getRealSize ();
+	for (std::size_t index = 0; (index < size) && (index * limbBits < 64); ++index)
+	{
+		result |= (unsigned long long) x._bigNumber[index] << (index * limbBits);
+	}
+	return result;
+}
+
+template <typename BaseType>
+unsigned long long BigIntegerRoots<BaseType>::remainder (const Number& a, unsigned long long q)
+{
+	// chunks of at most 32 bits, so the shifted remainder stays below 2^64
+	const unsigned int chunk = (limbBits < 32) ? limbBits : 32;
+	const unsigned long long mask = (1ULL << chunk) - 1;
+	unsigned long long result = 0;
+	for (std::size_t index = a.getRealSize (); index-- > 0;)
+	{
+		BaseType limb = a._bigNumber[index];
+		for (int shift = (int) (limbBits - chunk); shift >= 0; shift -= chunk)
+		{
+			result = ((result << chunk) | ((unsigned long long) (limb >> shift) & mask)) % q;
+		}
+	}
+	return (unsigned long long) result;
+}
+
+template <typename BaseType>
+unsigned long long BigIntegerRoots<BaseType>::powMod (unsigned long long base, unsigned long long exponent, unsigned long long modulus)
+{
+	unsigned long long result = 1;
+	unsigned long long power = base % modulus;
+	for (; exponent > 0; exponent >>= 1)
+	{
+		if ((exponent & 1) != 0)
+		{
+			result = result * power % modulus;
+		}
+		power = power * power % modulus;
+	}
+	return (unsigned long long) result;
+}
+
+template <typename BaseType>
+bool BigIntegerRoots<BaseType>::isSmallPrime (unsigned long long n)
+{
+	if (n < 2)
+	{
+		return false;
+	}
+	for (unsigned long long divisor = 2; divisor * divisor <= n; ++divisor)
+	{
+		if (n % divisor == 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+}
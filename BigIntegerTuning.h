@@ -0,0 +1,82 @@
+/*
+ * BigIntegerTuning.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace Utilities
+{
+
+class ThreadPool;
+
+/**
+ * Crossover points between the algorithms of BigIntegerBase, all sizes are given in limbs of BaseType.
+ * The values are plain statics, so they can be tuned per BaseType at startup (not while other threads
+ * are calculating).
+ */
+template <typename BaseType>
+struct BigIntegerTuning
+{
+	/// products with a smaller operand below this size use the schoolbook method
+	static std::size_t karatsubaThreshold;
+	/// products with a smaller operand below this size use Karatsuba, Toom-3 above
+	static std::size_t toom3Threshold;
+	/// same as karatsubaThreshold for squares
+	static std::size_t karatsubaSquareThreshold;
+	/// same as toom3Threshold for squares
+	static std::size_t toom3SquareThreshold;
+	/// products (and squares) with a smaller operand of at least this size use the number theoretic transform
+	static std::size_t nttThreshold;
+	/// divisions where divisor and quotient have at least this size use a Newton reciprocal instead of Knuth's algorithm D
+	static std::size_t newtonDivisionThreshold;
+	/// decimal conversions of numbers below this size use repeated single limb operations instead of divide and conquer
+	static std::size_t decimalConversionThreshold;
+	/// gcds of numbers from this size on use the subquadratic half gcd instead of Lehmer's algorithm
+	static std::size_t halfGcdThreshold;
+	/// half gcds below this size do Lehmer steps instead of recursing
+	static std::size_t halfGcdBasecaseThreshold;
+	/// opt in to parallel multiplication, the pool has to outlive all calculations using it
+	static ThreadPool* threadPool;
+	/// with a thread pool, products with a smaller operand of at least this size split their work over the threads
+	static std::size_t parallelThreshold;
+};
+
+template <typename BaseType>
+std::size_t BigIntegerTuning<BaseType>::karatsubaThreshold = 32;
+
+template <typename BaseType>
+std::size_t BigIntegerTuning<BaseType>::toom3Threshold = 160;
+
+template <typename BaseType>
+std::size_t BigIntegerTuning<BaseType>::karatsubaSquareThreshold = 48;
+
+template <typename BaseType>
+std::size_t BigIntegerTuning<BaseType>::toom3SquareThreshold = 200;
+
+template <typename BaseType>
+std::size_t BigIntegerTuning<BaseType>::nttThreshold = 12000 * 8 / sizeof(BaseType);
+
+template <typename BaseType>
+std::size_t BigIntegerTuning<BaseType>::newtonDivisionThreshold = 2500 * 8 / sizeof(BaseType);
+
+template <typename BaseType>
+std::size_t BigIntegerTuning<BaseType>::decimalConversionThreshold = 40 * 8 / sizeof(BaseType);
+
+template <typename BaseType>
+std::size_t BigIntegerTuning<BaseType>::halfGcdThreshold = 200 * 8 / sizeof(BaseType);
+
+template <typename BaseType>
+std::size_t BigIntegerTuning<BaseType>::halfGcdBasecaseThreshold = 100 * 8 / sizeof(BaseType);
+
+template <typename BaseType>
+ThreadPool* BigIntegerTuning<BaseType>::threadPool = nullptr;
+
+template <typename BaseType>
+std::size_t BigIntegerTuning<BaseType>::parallelThreshold = 2000 * 8 / sizeof(BaseType);
+
+}
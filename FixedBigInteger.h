@@ -0,0 +1,666 @@
+/*
+ * FixedBigInteger.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "LimbArithmetic.h"
+
+namespace Utilities
+{
+
+template <typename BaseType>
+class BigIntegerBase;
+
+/**
+ * An integer of exactly Bits bits in a plain array, Bits has to be a multiple of 64. Like the built in
+ * integers the arithmetic wraps around modulo 2^Bits, signed numbers are stored in two's complement and
+ * division rounds towards zero. Everything but the string output is constexpr. All loops run over the
+ * fixed number of limbs, so the compiler unrolls them for the small sizes.
+ */
+template <unsigned int Bits, bool Signed = false>
+class FixedBigInteger
+{
+	static_assert((Bits > 0) && (Bits % 64 == 0), "FixedBigInteger needs a positive multiple of 64 bits");
+
+public:
+	static const unsigned int limbCount = Bits / 64;
+
+	constexpr FixedBigInteger () : _limbs{}
+	{
+	}
+
+	/// sign extended like a conversion between the built in integers
+	constexpr FixedBigInteger (long long number) : _limbs{}
+	{
+		_limbs[0] = (std::uint64_t) number;
+		for (unsigned int i = 1; i < limbCount; ++i)
+		{
+			_limbs[i] = (number < 0) ? ~(std::uint64_t) 0 : 0;
+		}
+	}
+
+	/// widening conversion, sign extended if other is signed
+	template <unsigned int OtherBits, bool OtherSigned, typename std::enable_if<(OtherBits <= Bits), int>::type = 0>
+	constexpr FixedBigInteger (const FixedBigInteger<OtherBits, OtherSigned>& other) : _limbs{}
+	{
+		assignFrom (other);
+	}
+
+	/// narrowing conversion, keeps the low Bits bits
+	template <unsigned int OtherBits, bool OtherSigned, typename std::enable_if<(OtherBits > Bits), int>::type = 0>
+	constexpr explicit FixedBigInteger (const FixedBigInteger<OtherBits, OtherSigned>& other) : _limbs{}
+	{
+		assignFrom (other);
+	}
+
+	/// the low Bits bits of the two's complement of number
+	template <typename BaseType>
+	explicit FixedBigInteger (const BigIntegerBase<BaseType>& number) : _limbs{}
+	{
+		number.extractBits (0, Bits).exportLimbs (_limbs, sizeof(std::uint64_t));
+	}
+
+	template <typename BaseType>
+	operator BigIntegerBase<BaseType> () const
+	{
+		FixedBigInteger magnitude = isNegative () ? -*this : *this;
+		BigIntegerBase<BaseType> result;
+		result.importLimbs (magnitude._limbs, limbCount, sizeof(std::uint64_t));
+		return isNegative () ? BigIntegerBase<BaseType> () - result : result;
+	}
+
+	/**
+	 * the number given by count digits in base 2 to 16, the separator ' is skipped. Throws
+	 * std::invalid_argument for other characters, which makes a constant expression fail to compile.
+	 */
+	static constexpr FixedBigInteger fromDigits (const char* digits, std::size_t count, unsigned int base)
+	{
+		FixedBigInteger result;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			if (digits[i] == '\'')
+			{
+				continue;
+			}
+			unsigned int digit = digitValue (digits[i]);
+			if (digit >= base)
+			{
+				throw std::invalid_argument("FixedBigInteger: invalid digit");
+			}
+			result.multiplyAdd (base, digit);
+		}
+		return result;
+	}
+
+	constexpr bool isNegative () const
+	{
+		return Signed && ((_limbs[limbCount - 1] >> 63) != 0);
+	}
+
+	/// the limb with the given index, the lowest first
+	constexpr std::uint64_t getLimb (unsigned int index) const
+	{
+		return _limbs[index];
+	}
+
+	constexpr FixedBigInteger& operator+= (const FixedBigInteger& rhs)
+	{
+		unsigned char carry = 0;
+		for (unsigned int i = 0; i < limbCount; ++i)
+		{
+			_limbs[i] = Limbs::addWithCarry (_limbs[i], rhs._limbs[i], carry);
+		}
+		return *this;
+	}
+
+	constexpr FixedBigInteger& operator-= (const FixedBigInteger& rhs)
+	{
+		unsigned char borrow = 0;
+		for (unsigned int i = 0; i < limbCount; ++i)
+		{
+			_limbs[i] = Limbs::subWithBorrow (_limbs[i], rhs._limbs[i], borrow);
+		}
+		return *this;
+	}
+
+	constexpr FixedBigInteger operator- () const
+	{
+		return FixedBigInteger () - *this;
+	}
+
+	/// the low Bits bits of the product, the same for signed and unsigned numbers
+	constexpr FixedBigInteger& operator*= (const FixedBigInteger& rhs)
+	{
+		FixedBigInteger result;
+		for (unsigned int i = 0; i < limbCount; ++i)
+		{
+			std::uint64_t carry = 0;
+			for (unsigned int j = 0; i + j < limbCount; ++j)
+			{
+				std::uint64_t high = 0;
+				std::uint64_t low = Limbs::Wide::mulWide (_limbs[i], rhs._limbs[j], high);
+				low += carry;
+				high += (low < carry);
+				low += result._limbs[i + j];
+				high += (low < result._limbs[i + j]);
+				result._limbs[i + j] = low;
+				carry = high;
+			}
+		}
+		return *this = result;
+	}
+
+	/// rounds towards zero, throws std::domain_error for a zero divisor
+	constexpr FixedBigInteger& operator/= (const FixedBigInteger& rhs)
+	{
+		FixedBigInteger quotient;
+		FixedBigInteger remainder;
+		divmod (rhs, quotient, remainder);
+		return *this = quotient;
+	}
+
+	/// has the sign of this like for the built in types, throws std::domain_error for a zero divisor
+	constexpr FixedBigInteger& operator%= (const FixedBigInteger& rhs)
+	{
+		FixedBigInteger quotient;
+		FixedBigInteger remainder;
+		divmod (rhs, quotient, remainder);
+		return *this = remainder;
+	}
+
+	/// quotient rounded towards zero and the remainder with the sign of this
+	constexpr void divmod (const FixedBigInteger& divisor, FixedBigInteger& quotient, FixedBigInteger& remainder) const
+	{
+		FixedBigInteger dividendMagnitude = isNegative () ? -*this : *this;
+		FixedBigInteger divisorMagnitude = divisor.isNegative () ? -divisor : divisor;
+		divideMagnitudes (dividendMagnitude, divisorMagnitude, quotient, remainder);
+		if (isNegative () != divisor.isNegative ())
+		{
+			quotient = -quotient;
+		}
+		if (isNegative ())
+		{
+			remainder = -remainder;
+		}
+	}
+
+	/// shifts of Bits or more give 0
+	constexpr FixedBigInteger operator<< (unsigned int howMuch) const
+	{
+		FixedBigInteger result;
+		unsigned int limbShift = howMuch / 64;
+		unsigned int bitShift = howMuch % 64;
+		for (unsigned int i = limbShift; i < limbCount; ++i)
+		{
+			result._limbs[i] = _limbs[i - limbShift] << bitShift;
+			if ((bitShift > 0) && (i > limbShift))
+			{
+				result._limbs[i] |= _limbs[i - limbShift - 1] >> (64 - bitShift);
+			}
+		}
+		return result;
+	}
+
+	constexpr FixedBigInteger& operator<<= (unsigned int howMuch)
+	{
+		return *this = *this << howMuch;
+	}
+
+	/// arithmetic shift for signed numbers, so negative numbers are rounded towards minus infinity
+	constexpr FixedBigInteger operator>> (unsigned int howMuch) const
+	{
+		std::uint64_t fill = isNegative () ? ~(std::uint64_t) 0 : 0;
+		FixedBigInteger result;
+		unsigned int limbShift = howMuch / 64;
+		unsigned int bitShift = howMuch % 64;
+		for (unsigned int i = 0; i < limbCount; ++i)
+		{
+			std::uint64_t low = (i + limbShift < limbCount) ? _limbs[i + limbShift] : fill;
+			std::uint64_t high = (i + limbShift + 1 < limbCount) ? _limbs[i + limbShift + 1] : fill;
+			result._limbs[i] = (bitShift == 0) ? low : (low >> bitShift) | (high << (64 - bitShift));
+		}
+		return result;
+	}
+
+	constexpr FixedBigInteger& operator>>= (unsigned int howMuch)
+	{
+		return *this = *this >> howMuch;
+	}
+
+	/// -1, 0 or 1 like the comparison of the built in integers
+	constexpr int compare (const FixedBigInteger& rhs) const
+	{
+		if (isNegative () != rhs.isNegative ())
+		{
+			return isNegative () ? -1 : 1;
+		}
+		// two's complements of the same sign compare like their unsigned bits
+		for (unsigned int i = limbCount; i-- > 0;)
+		{
+			if (_limbs[i] != rhs._limbs[i])
+			{
+				return (_limbs[i] < rhs._limbs[i]) ? -1 : 1;
+			}
+		}
+		return 0;
+	}
+
+	/// the decimal digits with a leading - for negative numbers
+	std::string asString () const
+	{
+		// 10^19 is the largest power of ten in a limb, every limb gives at most 20 digits
+		const std::uint64_t chunkPower = 10000000000000000000ULL;
+		char buffer[20 * limbCount + 1];
+		char* position = buffer + sizeof(buffer);
+		FixedBigInteger magnitude = isNegative () ? -*this : *this;
+		do
+		{
+			std::uint64_t chunk = magnitude.divideByLimb (chunkPower);
+			bool isTop = magnitude == FixedBigInteger ();
+			for (int digit = 0; (digit < 19) && (!isTop || (chunk > 0) || (digit == 0)); ++digit)
+			{
+				*--position = (char) ('0' + chunk % 10);
+				chunk /= 10;
+			}
+		}
+		while (magnitude != FixedBigInteger ());
+		if (isNegative ())
+		{
+			*--position = '-';
+		}
+		return std::string (position, buffer + sizeof(buffer));
+	}
+
+private:
+	template <unsigned int OtherBits, bool OtherSigned>
+	friend class FixedBigInteger;
+
+	typedef LimbArithmetic<std::uint64_t> Limbs;
+
+	std::uint64_t _limbs[limbCount];
+
+	template <unsigned int OtherBits, bool OtherSigned>
+	constexpr void assignFrom (const FixedBigInteger<OtherBits, OtherSigned>& other)
+	{
+		typedef FixedBigInteger<OtherBits, OtherSigned> Other;
+		std::uint64_t fill = other.isNegative () ? ~(std::uint64_t) 0 : 0;
+		for (unsigned int i = 0; i < limbCount; ++i)
+		{
+			_limbs[i] = (i < Other::limbCount) ? other._limbs[i] : fill;
+		}
+	}
+
+	static constexpr unsigned int digitValue (char character)
+	{
+		if ((character >= '0') && (character <= '9'))
+		{
+			return character - '0';
+		}
+		if ((character >= 'a') && (character <= 'f'))
+		{
+			return character - 'a' + 10;
+		}
+		if ((character >= 'A') && (character <= 'F'))
+		{
+			return character - 'A' + 10;
+		}
+		throw std::invalid_argument("FixedBigInteger: invalid digit");
+	}
+
+	/// this = this * factor + addend
+	constexpr void multiplyAdd (std::uint64_t factor, std::uint64_t addend)
+	{
+		std::uint64_t carry = addend;
+		for (unsigned int i = 0; i < limbCount; ++i)
+		{
+			std::uint64_t high = 0;
+			std::uint64_t low = Limbs::Wide::mulWide (_limbs[i], factor, high);
+			low += carry;
+			carry = high + (low < carry);
+			_limbs[i] = low;
+		}
+	}
+
+	/// divides the bits as an unsigned number by divisor and returns the remainder
+	constexpr std::uint64_t divideByLimb (std::uint64_t divisor)
+	{
+		std::uint64_t remainder = 0;
+		for (unsigned int i = limbCount; i-- > 0;)
+		{
+			_limbs[i] = Limbs::Wide::divWide (remainder, _limbs[i], divisor, remainder);
+		}
+		return remainder;
+	}
+
+	/// number of limbs without the leading zero limbs
+	constexpr unsigned int realSize () const
+	{
+		unsigned int size = limbCount;
+		while ((size > 0) && (_limbs[size - 1] == 0))
+		{
+			--size;
+		}
+		return size;
+	}
+
+	/**
+	 * division of the bits as unsigned numbers, see Knuth, TAOCP Vol. 2, 4.3.1 Algorithm D. It follows
+	 * LimbDivision::divide on the fixed arrays.
+	 */
+	static constexpr void divideMagnitudes (const FixedBigInteger& a, const FixedBigInteger& b, FixedBigInteger& quotient,
+			FixedBigInteger& remainder)
+	{
+		unsigned int aSize = a.realSize ();
+		unsigned int bSize = b.realSize ();
+		if (bSize == 0)
+		{
+			throw std::domain_error("FixedBigInteger division by zero");
+		}
+		quotient = FixedBigInteger ();
+		remainder = FixedBigInteger ();
+		if (aSize < bSize)
+		{
+			remainder = a;
+			return;
+		}
+		if (bSize == 1)
+		{
+			quotient = a;
+			remainder._limbs[0] = quotient.divideByLimb (b._limbs[0]);
+			return;
+		}
+		// normalize, so the highest bit of the divisor is set, the dividend gets an additional limb
+		unsigned int shift = Limbs::leadingZeros (b._limbs[bSize - 1]);
+		std::uint64_t u[limbCount + 1] = {};
+		std::uint64_t v[limbCount] = {};
+		for (unsigned int i = 0; i < limbCount; ++i)
+		{
+			u[i] = a._limbs[i] << shift;
+			v[i] = b._limbs[i] << shift;
+			if ((shift > 0) && (i > 0))
+			{
+				u[i] |= a._limbs[i - 1] >> (64 - shift);
+				v[i] |= b._limbs[i - 1] >> (64 - shift);
+			}
+		}
+		u[limbCount] = (shift > 0) ? a._limbs[limbCount - 1] >> (64 - shift) : 0;
+
+		std::uint64_t divisorTop = v[bSize - 1];
+		std::uint64_t divisorNext = v[bSize - 2];
+		for (unsigned int j = aSize - bSize + 1; j-- > 0;)
+		{
+			std::uint64_t high = u[j + bSize];
+			std::uint64_t middle = u[j + bSize - 1];
+			std::uint64_t low = u[j + bSize - 2];
+
+			// estimate the quotient limb from the top two limbs, it is at most two too big
+			std::uint64_t quotientEstimate = 0;
+			std::uint64_t rest = 0;
+			bool restOverflow = false;
+			if (high >= divisorTop)
+			{
+				quotientEstimate = ~(std::uint64_t) 0;
+				rest = middle + divisorTop;
+				restOverflow = (rest < middle);
+			}
+			else
+			{
+				quotientEstimate = Limbs::Wide::divWide (high, middle, divisorTop, rest);
+			}
+			while (!restOverflow)
+			{
+				std::uint64_t productHigh = 0;
+				std::uint64_t productLow = Limbs::Wide::mulWide (quotientEstimate, divisorNext, productHigh);
+				if ((productHigh < rest) || ((productHigh == rest) && (productLow <= low)))
+				{
+					break;
+				}
+				--quotientEstimate;
+				std::uint64_t oldRest = rest;
+				rest += divisorTop;
+				restOverflow = (rest < oldRest);
+			}
+
+			// multiply and subtract, in rare cases the estimate is still one too big
+			std::uint64_t borrow = 0;
+			for (unsigned int i = 0; i < bSize; ++i)
+			{
+				std::uint64_t productHigh = 0;
+				std::uint64_t productLow = Limbs::Wide::mulWide (quotientEstimate, v[i], productHigh);
+				productLow += borrow;
+				productHigh += (productLow < borrow);
+				std::uint64_t entry = u[j + i];
+				u[j + i] = entry - productLow;
+				borrow = productHigh + (entry < productLow);
+			}
+			u[j + bSize] = high - borrow;
+			if (high < borrow)
+			{
+				--quotientEstimate;
+				unsigned char carry = 0;
+				for (unsigned int i = 0; i < bSize; ++i)
+				{
+					u[j + i] = Limbs::addWithCarry (u[j + i], v[i], carry);
+				}
+				u[j + bSize] += carry;
+			}
+			quotient._limbs[j] = quotientEstimate;
+		}
+
+		for (unsigned int i = 0; i < bSize; ++i)
+		{
+			remainder._limbs[i] = u[i] >> shift;
+			if (shift > 0)
+			{
+				remainder._limbs[i] |= u[i + 1] << (64 - shift);
+			}
+		}
+	}
+};
+
+/**
+ * the type of the arithmetic and the comparisons of two FixedBigIntegers, like the usual arithmetic
+ * conversions of the built in integers: the wider one, and for the same width unsigned unless both are
+ * signed. The operands are converted to it first, signed ones sign extended.
+ */
+template <unsigned int BitsA, bool SignedA, unsigned int BitsB, bool SignedB>
+using FixedBigIntegerCommon = FixedBigInteger<(BitsA > BitsB) ? BitsA : BitsB,
+		(BitsA > BitsB) ? SignedA : ((BitsB > BitsA) ? SignedB : (SignedA && SignedB))>;
+
+template <unsigned int BitsA, bool SignedA, unsigned int BitsB, bool SignedB>
+constexpr FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> operator+ (const FixedBigInteger<BitsA, SignedA>& a,
+		const FixedBigInteger<BitsB, SignedB>& b)
+{
+	FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> result (a);
+	return result += FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> (b);
+}
+
+template <unsigned int BitsA, bool SignedA, unsigned int BitsB, bool SignedB>
+constexpr FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> operator- (const FixedBigInteger<BitsA, SignedA>& a,
+		const FixedBigInteger<BitsB, SignedB>& b)
+{
+	FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> result (a);
+	return result -= FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> (b);
+}
+
+template <unsigned int BitsA, bool SignedA, unsigned int BitsB, bool SignedB>
+constexpr FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> operator* (const FixedBigInteger<BitsA, SignedA>& a,
+		const FixedBigInteger<BitsB, SignedB>& b)
+{
+	FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> result (a);
+	return result *= FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> (b);
+}
+
+template <unsigned int BitsA, bool SignedA, unsigned int BitsB, bool SignedB>
+constexpr FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> operator/ (const FixedBigInteger<BitsA, SignedA>& a,
+		const FixedBigInteger<BitsB, SignedB>& b)
+{
+	FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> result (a);
+	return result /= FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> (b);
+}
+
+template <unsigned int BitsA, bool SignedA, unsigned int BitsB, bool SignedB>
+constexpr FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> operator% (const FixedBigInteger<BitsA, SignedA>& a,
+		const FixedBigInteger<BitsB, SignedB>& b)
+{
+	FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> result (a);
+	return result %= FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> (b);
+}
+
+template <unsigned int BitsA, bool SignedA, unsigned int BitsB, bool SignedB>
+constexpr bool operator== (const FixedBigInteger<BitsA, SignedA>& a, const FixedBigInteger<BitsB, SignedB>& b)
+{
+	return FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> (a).compare (b) == 0;
+}
+
+template <unsigned int BitsA, bool SignedA, unsigned int BitsB, bool SignedB>
+constexpr bool operator!= (const FixedBigInteger<BitsA, SignedA>& a, const FixedBigInteger<BitsB, SignedB>& b)
+{
+	return FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> (a).compare (b) != 0;
+}
+
+template <unsigned int BitsA, bool SignedA, unsigned int BitsB, bool SignedB>
+constexpr bool operator< (const FixedBigInteger<BitsA, SignedA>& a, const FixedBigInteger<BitsB, SignedB>& b)
+{
+	return FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> (a).compare (b) < 0;
+}
+
+template <unsigned int BitsA, bool SignedA, unsigned int BitsB, bool SignedB>
+constexpr bool operator<= (const FixedBigInteger<BitsA, SignedA>& a, const FixedBigInteger<BitsB, SignedB>& b)
+{
+	return FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> (a).compare (b) <= 0;
+}
+
+template <unsigned int BitsA, bool SignedA, unsigned int BitsB, bool SignedB>
+constexpr bool operator> (const FixedBigInteger<BitsA, SignedA>& a, const FixedBigInteger<BitsB, SignedB>& b)
+{
+	return FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> (a).compare (b) > 0;
+}
+
+template <unsigned int BitsA, bool SignedA, unsigned int BitsB, bool SignedB>
+constexpr bool operator>= (const FixedBigInteger<BitsA, SignedA>& a, const FixedBigInteger<BitsB, SignedB>& b)
+{
+	return FixedBigIntegerCommon<BitsA, SignedA, BitsB, SignedB> (a).compare (b) >= 0;
+}
+
+template <unsigned int Bits, bool Signed>
+std::string to_string (const FixedBigInteger<Bits, Signed>& number)
+{
+	return number.asString ();
+}
+
+template <unsigned int Bits, bool Signed>
+std::ostream& operator<< (std::ostream& os, const FixedBigInteger<Bits, Signed>& number)
+{
+	return os << number.asString ();
+}
+
+/**
+ * The size and base of a literal for _fixed and _bigInt: 0x starts hexadecimal, 0b binary and another
+ * leading 0 octal digits like for the built in literals.
+ */
+struct FixedBigIntegerLiteral
+{
+	static constexpr unsigned int base (const char* characters, std::size_t count)
+	{
+		if ((count > 1) && (characters[0] == '0'))
+		{
+			if ((characters[1] == 'x') || (characters[1] == 'X'))
+			{
+				return 16;
+			}
+			if ((characters[1] == 'b') || (characters[1] == 'B'))
+			{
+				return 2;
+			}
+			return 8;
+		}
+		return 10;
+	}
+
+	static constexpr std::size_t prefixLength (const char* characters, std::size_t count)
+	{
+		unsigned int literalBase = base (characters, count);
+		return (literalBase == 16) || (literalBase == 2) ? 2 : 0;
+	}
+
+	/// true for at least one digit below the base after the prefix and separators, false for floating literals
+	static constexpr bool isInteger (const char* characters, std::size_t count)
+	{
+		unsigned int literalBase = base (characters, count);
+		std::size_t digits = 0;
+		for (std::size_t i = prefixLength (characters, count); i < count; ++i)
+		{
+			if (characters[i] == '\'')
+			{
+				continue;
+			}
+			char character = characters[i];
+			unsigned int digit = ((character >= '0') && (character <= '9')) ? character - '0'
+					: ((character >= 'a') && (character <= 'f')) ? character - 'a' + 10
+					: ((character >= 'A') && (character <= 'F')) ? character - 'A' + 10 : 16;
+			if (digit >= literalBase)
+			{
+				return false;
+			}
+			++digits;
+		}
+		return digits > 0;
+	}
+
+	template <char... Characters>
+	static constexpr bool isInteger ()
+	{
+		const char characters[] = {Characters...};
+		return isInteger (characters, sizeof...(Characters));
+	}
+
+	/// enough bits for all digits, rounded up to whole limbs
+	static constexpr unsigned int bits (const char* characters, std::size_t count)
+	{
+		unsigned int literalBase = base (characters, count);
+		std::size_t digits = 0;
+		for (std::size_t i = prefixLength (characters, count); i < count; ++i)
+		{
+			digits += (characters[i] != '\'');
+		}
+		// 3322 / 1000 is slightly above log2(10)
+		std::size_t digitBits = (literalBase == 10) ? digits * 3322 / 1000 + 1 : digits * ((literalBase == 16) ? 4 : (literalBase == 8) ? 3 : 1);
+		return (unsigned int) ((digitBits + 63) / 64 * 64);
+	}
+
+	template <char... Characters>
+	static constexpr unsigned int bits ()
+	{
+		const char characters[] = {Characters...};
+		return bits (characters, sizeof...(Characters));
+	}
+};
+
+/**
+ * an unsigned FixedBigInteger just large enough for the literal, computed by the compiler, e.g.
+ * constexpr auto x = 12345678901234567890_fixed. Its arithmetic wraps around like for all FixedBigIntegers,
+ * use _bigInt for exact results.
+ */
+template <char... Characters>
+constexpr FixedBigInteger<FixedBigIntegerLiteral::bits<Characters...> ()> operator"" _fixed ()
+{
+	static_assert(FixedBigIntegerLiteral::isInteger<Characters...> (), "_fixed needs an integer literal");
+	const char characters[] = {Characters...};
+	std::size_t count = sizeof...(Characters);
+	std::size_t prefix = FixedBigIntegerLiteral::prefixLength (characters, count);
+	return FixedBigInteger<FixedBigIntegerLiteral::bits<Characters...> ()>::fromDigits (characters + prefix, count - prefix,
+			FixedBigIntegerLiteral::base (characters, count));
+}
+
+}
@@ -24,4 +24,25 @@ namespace Utilities
 			return (NumberType) -1;
 		}
 	}
-}
\ No newline at end of file
+
+	/// result = a + b, false if the sum does not fit into IntegerType, result is wrapped around then
+	template<typename IntegerType>
+	bool checkedAdd (IntegerType a, IntegerType b, IntegerType& result)
+	{
+		return !__builtin_add_overflow (a, b, &result);
+	}
+
+	/// result = a - b, false if the difference does not fit into IntegerType, result is wrapped around then
+	template<typename IntegerType>
+	bool checkedSub (IntegerType a, IntegerType b, IntegerType& result)
+	{
+		return !__builtin_sub_overflow (a, b, &result);
+	}
+
+	/// result = a * b, false if the product does not fit into IntegerType, result is wrapped around then
+	template<typename IntegerType>
+	bool checkedMul (IntegerType a, IntegerType b, IntegerType& result)
+	{
+		return !__builtin_mul_overflow (a, b, &result);
+	}
+}
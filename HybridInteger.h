@@ -0,0 +1,260 @@
+/*
+ * HybridInteger.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include "BigInteger.h"
+#include "HelperFunctions.h"
+
+namespace Utilities
+{
+
+/**
+ * An integer which stays in a std::int64_t as long as it fits and only becomes a BigIntegerBase when an
+ * operation overflows. +, - and * use the checked machine operations of HelperFunctions.h, so small
+ * values never touch limbs or the heap. Results of the large representation which fit into a
+ * std::int64_t again become small, so a temporary overflow does not slow down all later operations.
+ */
+template <typename BaseType = std::uint64_t>
+class HybridInteger
+{
+public:
+	typedef BigIntegerBase<BaseType> Number;
+
+	HybridInteger (std::int64_t value = 0) : _small(value)
+	{
+	}
+
+	HybridInteger (const Number& value) : _small(0)
+	{
+		assign (Number (value));
+	}
+
+	HybridInteger (const std::string& value) : HybridInteger (Number (value))
+	{
+	}
+
+	HybridInteger (const HybridInteger& copy) : _small(copy._small), _big(copy._big ? new Number (*copy._big) : nullptr)
+	{
+	}
+
+	HybridInteger (HybridInteger&& source) = default;
+
+	HybridInteger& operator= (const HybridInteger& rhs)
+	{
+		if (this != &rhs)
+		{
+			_small = rhs._small;
+			_big.reset (rhs._big ? new Number (*rhs._big) : nullptr);
+		}
+		return *this;
+	}
+
+	HybridInteger& operator= (HybridInteger&& rhs) = default;
+
+	/// true while the value is kept in a machine word
+	bool isSmall () const
+	{
+		return !_big;
+	}
+
+	/// the value of a small number
+	std::int64_t smallValue () const
+	{
+		return _small;
+	}
+
+	Number toBigInteger () const
+	{
+		return isSmall () ? fromSmall (_small) : *_big;
+	}
+
+	std::string asString (int base = 10) const
+	{
+		return toBigInteger ().asString (base);
+	}
+
+	HybridInteger& operator+= (const HybridInteger& rhs)
+	{
+		std::int64_t result;
+		if (isSmall () && rhs.isSmall () && checkedAdd (_small, rhs._small, result))
+		{
+			_small = result;
+			return *this;
+		}
+		return assign (toBigInteger () + rhs.toBigInteger ());
+	}
+
+	HybridInteger operator+ (const HybridInteger& rhs) const
+	{
+		HybridInteger result (*this);
+		return result += rhs;
+	}
+
+	HybridInteger& operator-= (const HybridInteger& rhs)
+	{
+		std::int64_t result;
+		if (isSmall () && rhs.isSmall () && checkedSub (_small, rhs._small, result))
+		{
+			_small = result;
+			return *this;
+		}
+		return assign (toBigInteger () - rhs.toBigInteger ());
+	}
+
+	HybridInteger operator- (const HybridInteger& rhs) const
+	{
+		HybridInteger result (*this);
+		return result -= rhs;
+	}
+
+	HybridInteger operator- () const
+	{
+		return HybridInteger () - *this;
+	}
+
+	HybridInteger& operator*= (const HybridInteger& rhs)
+	{
+		std::int64_t result;
+		if (isSmall () && rhs.isSmall () && checkedMul (_small, rhs._small, result))
+		{
+			_small = result;
+			return *this;
+		}
+		return assign (toBigInteger () * rhs.toBigInteger ());
+	}
+
+	HybridInteger operator* (const HybridInteger& rhs) const
+	{
+		HybridInteger result (*this);
+		return result *= rhs;
+	}
+
+	/// truncating like BigIntegerBase, throws std::domain_error for a zero divisor
+	HybridInteger& operator/= (const HybridInteger& rhs)
+	{
+		if (isSmall () && rhs.isSmall () && isSafeDivision (rhs._small))
+		{
+			_small /= rhs._small;
+			return *this;
+		}
+		return assign (toBigInteger () / rhs.toBigInteger ());
+	}
+
+	HybridInteger operator/ (const HybridInteger& rhs) const
+	{
+		HybridInteger result (*this);
+		return result /= rhs;
+	}
+
+	/// the sign of the dividend like BigIntegerBase, throws std::domain_error for a zero divisor
+	HybridInteger& operator%= (const HybridInteger& rhs)
+	{
+		if (isSmall () && rhs.isSmall () && isSafeDivision (rhs._small))
+		{
+			_small %= rhs._small;
+			return *this;
+		}
+		return assign (toBigInteger () % rhs.toBigInteger ());
+	}
+
+	HybridInteger operator% (const HybridInteger& rhs) const
+	{
+		HybridInteger result (*this);
+		return result %= rhs;
+	}
+
+	bool operator== (const HybridInteger& rhs) const
+	{
+		// both representations are canonical, a large number never fits into a machine word
+		if (isSmall () || rhs.isSmall ())
+		{
+			return isSmall () && rhs.isSmall () && (_small == rhs._small);
+		}
+		return *_big == *rhs._big;
+	}
+
+	bool operator< (const HybridInteger& rhs) const
+	{
+		if (isSmall () && rhs.isSmall ())
+		{
+			return _small < rhs._small;
+		}
+		return toBigInteger () < rhs.toBigInteger ();
+	}
+
+	bool operator<= (const HybridInteger& rhs) const
+	{
+		return !(rhs < *this);
+	}
+
+	bool operator> (const HybridInteger& rhs) const
+	{
+		return rhs < *this;
+	}
+
+	bool operator>= (const HybridInteger& rhs) const
+	{
+		return !(*this < rhs);
+	}
+
+private:
+	static Number fromSmall (std::int64_t value)
+	{
+		Number result;
+		result.setFromNumber (value);
+		return result;
+	}
+
+	/// only a zero divisor and the one quotient above INT64_MAX need the large representation
+	bool isSafeDivision (std::int64_t divisor) const
+	{
+		return (divisor != 0) && !((divisor == -1) && (_small == INT64_MIN));
+	}
+
+	/// stores value small if it fits into a std::int64_t
+	HybridInteger& assign (Number&& value)
+	{
+		std::uint64_t magnitude = 0;
+		if (value.bitLength () <= 64)
+		{
+			value.exportLimbs (&magnitude, sizeof(magnitude));
+		}
+		const std::uint64_t limit = (std::uint64_t) INT64_MAX + (value.isPositive () ? 0 : 1);
+		if ((value.bitLength () <= 64) && (magnitude <= limit))
+		{
+			_small = value.isPositive () ? (std::int64_t) magnitude : (std::int64_t) (0 - magnitude);
+			_big.reset ();
+		}
+		else if (_big)
+		{
+			*_big = std::move (value);
+		}
+		else
+		{
+			_big.reset (new Number (std::move (value)));
+		}
+		return *this;
+	}
+
+	std::int64_t _small;
+	/// the value if it does not fit into _small, empty otherwise
+	std::unique_ptr<Number> _big;
+};
+
+template <typename BaseType>
+std::ostream& operator<< (std::ostream& os, const HybridInteger<BaseType>& num)
+{
+	return os << num.toBigInteger ();
+}
+
+}
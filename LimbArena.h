@@ -0,0 +1,141 @@
+/*
+ * LimbArena.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <new>
+
+namespace Utilities
+{
+
+/**
+ * Bump allocator for the heap limbs of LimbStorage. Allocations only move a pointer forward, freeing the
+ * most recent allocation moves it back, everything else is kept until release () or the destructor frees
+ * all blocks in one go. Numbers with limbs from an arena must not outlive it. An arena must only be used
+ * by one thread at a time.
+ */
+class LimbArena
+{
+public:
+	explicit LimbArena (std::size_t blockSize = 1 << 16) : _blockSize(blockSize), _top(nullptr), _end(nullptr), _bytesUsed(0)
+	{
+	}
+
+	LimbArena (const LimbArena&) = delete;
+	LimbArena& operator= (const LimbArena&) = delete;
+
+	~LimbArena ()
+	{
+		release ();
+	}
+
+	void* allocate (std::size_t bytes)
+	{
+		bytes = roundUp (bytes);
+		if ((std::size_t) (_end - _top) < bytes)
+		{
+			std::size_t size = (bytes > _blockSize) ? bytes : _blockSize;
+			_top = static_cast<char*> (::operator new (size));
+			_end = _top + size;
+			_blocks.push_back (_top);
+		}
+		void* result = _top;
+		_top += bytes;
+		_bytesUsed += bytes;
+		return result;
+	}
+
+	/// only the most recent allocation is given back, all others stay until release ()
+	void deallocate (void* data, std::size_t bytes)
+	{
+		bytes = roundUp (bytes);
+		if (static_cast<char*> (data) + bytes == _top)
+		{
+			_top -= bytes;
+			_bytesUsed -= bytes;
+		}
+	}
+
+	/// frees all blocks, all limbs allocated from this arena become invalid
+	void release ()
+	{
+		for (std::size_t i = 0; i < _blocks.size (); ++i)
+		{
+			::operator delete (_blocks[i]);
+		}
+		_blocks.clear ();
+		_top = _end = nullptr;
+		_bytesUsed = 0;
+	}
+
+	/// bytes handed out and not given back since the last release
+	std::size_t getBytesUsed () const
+	{
+		return _bytesUsed;
+	}
+
+	/// the arena new limbs of this thread come from, nullptr for the global heap
+	static LimbArena* current ()
+	{
+		return currentSlot ();
+	}
+
+private:
+	friend class ScopedLimbArena;
+
+	static LimbArena*& currentSlot ()
+	{
+		static thread_local LimbArena* arena = nullptr;
+		return arena;
+	}
+
+	static std::size_t roundUp (std::size_t bytes)
+	{
+		const std::size_t alignment = alignof(std::max_align_t);
+		return (bytes + alignment - 1) & ~(alignment - 1);
+	}
+
+	std::size_t _blockSize;
+	char* _top;
+	char* _end;
+	std::size_t _bytesUsed;
+	std::vector<char*> _blocks;
+};
+
+/**
+ * Makes an arena the source of new limbs of this thread for its lifetime and restores the previous one
+ * afterwards. Only numbers created inside the scope take limbs from the arena, numbers created before it
+ * stay on the global heap when they grow or get results assigned. With nullptr the limbs come from the
+ * global heap again, e.g. for results which have to outlive the arena.
+ */
+class ScopedLimbArena
+{
+public:
+	explicit ScopedLimbArena (LimbArena* arena) : _previous(LimbArena::currentSlot ())
+	{
+		LimbArena::currentSlot () = arena;
+	}
+
+	explicit ScopedLimbArena (LimbArena& arena) : ScopedLimbArena (&arena)
+	{
+	}
+
+	ScopedLimbArena (const ScopedLimbArena&) = delete;
+	ScopedLimbArena& operator= (const ScopedLimbArena&) = delete;
+
+	~ScopedLimbArena ()
+	{
+		LimbArena::currentSlot () = _previous;
+	}
+
+private:
+	LimbArena* _previous;
+};
+
+}
@@ -0,0 +1,719 @@
+/*
+ * LimbArithmetic.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+#include "LimbVectorArithmetic.h"
+
+namespace Utilities
+{
+
+/**
+ * The unsigned type with twice the width of a limb, used for the single instruction multiply and divide.
+ * There is no specialization for std::uint64_t if the compiler does not support unsigned __int128,
+ * in that case WideArithmetic falls back to half word arithmetic.
+ */
+template <typename BaseType>
+struct DoubleWidth;
+
+template <>
+struct DoubleWidth<unsigned char>
+{
+	typedef std::uint16_t type;
+};
+
+template <>
+struct DoubleWidth<unsigned short>
+{
+	typedef std::uint32_t type;
+};
+
+template <>
+struct DoubleWidth<unsigned int>
+{
+	typedef std::uint64_t type;
+};
+
+#if defined(__SIZEOF_INT128__)
+template <>
+struct DoubleWidth<unsigned long>
+{
+	typedef unsigned __int128 type;
+};
+
+template <>
+struct DoubleWidth<unsigned long long>
+{
+	typedef unsigned __int128 type;
+};
+#endif
+
+/**
+ * Single limb operations producing or consuming a double limb, BaseType has to be unsigned. They are
+ * constexpr, so FixedBigInteger can use them at compile time.
+ */
+template <typename BaseType, typename DoubleType = typename DoubleWidth<BaseType>::type>
+struct WideArithmetic
+{
+	static const unsigned int bits = sizeof(BaseType) << 3;
+
+	/// returns the low part of a * b, the high part is stored in high
+	static constexpr BaseType mulWide (BaseType a, BaseType b, BaseType& high)
+	{
+		DoubleType product = (DoubleType) a * b;
+		high = (BaseType) (product >> bits);
+		return (BaseType) product;
+	}
+
+	/// divides (high, low) by divisor, high has to be smaller than divisor
+	static constexpr BaseType divWide (BaseType high, BaseType low, BaseType divisor, BaseType& remainder)
+	{
+		DoubleType dividend = ((DoubleType) high << bits) | low;
+		remainder = (BaseType) (dividend % divisor);
+		return (BaseType) (dividend / divisor);
+	}
+};
+
+/**
+ * Fallback for limbs without a hardware supported double width type, the halves of the limbs are
+ * multiplied separately and the division follows Hacker's Delight (divlu).
+ */
+template <typename BaseType>
+struct HalfWordArithmetic
+{
+	static const unsigned int bits = sizeof(BaseType) << 3;
+	static const unsigned int halfBits = sizeof(BaseType) << 2;
+	static const BaseType lowMask = ((BaseType) 1 << halfBits) - 1;
+
+	static constexpr BaseType mulWide (BaseType a, BaseType b, BaseType& high)
+	{
+		BaseType aLow = a & lowMask;
+		BaseType aHigh = a >> halfBits;
+		BaseType bLow = b & lowMask;
+		BaseType bHigh = b >> halfBits;
+		BaseType low = aLow * bLow;
+		BaseType middle1 = aLow * bHigh;
+		BaseType middle2 = aHigh * bLow;
+		BaseType middle = (low >> halfBits) + (middle1 & lowMask) + (middle2 & lowMask);
+		high = aHigh * bHigh + (middle1 >> halfBits) + (middle2 >> halfBits) + (middle >> halfBits);
+		return (low & lowMask) | (middle << halfBits);
+	}
+
+	static constexpr BaseType divWide (BaseType high, BaseType low, BaseType divisor, BaseType& remainder)
+	{
+		unsigned int shift = 0;
+		while ((divisor & ((BaseType) 1 << (bits - 1))) == 0)
+		{
+			divisor <<= 1;
+			++shift;
+		}
+		if (shift > 0)
+		{
+			high = (high << shift) | (low >> (bits - shift));
+			low <<= shift;
+		}
+		BaseType divHigh = divisor >> halfBits;
+		BaseType divLow = divisor & lowMask;
+		BaseType lowHigh = low >> halfBits;
+		BaseType lowLow = low & lowMask;
+
+		BaseType q1 = high / divHigh;
+		BaseType rest = high - q1 * divHigh;
+		while ((q1 > lowMask) || (q1 * divLow > ((rest << halfBits) | lowHigh)))
+		{
+			--q1;
+			rest += divHigh;
+			if (rest > lowMask)
+			{
+				break;
+			}
+		}
+		BaseType middle = (high << halfBits) + lowHigh - q1 * divisor;
+
+		BaseType q0 = middle / divHigh;
+		rest = middle - q0 * divHigh;
+		while ((q0 > lowMask) || (q0 * divLow > ((rest << halfBits) | lowLow)))
+		{
+			--q0;
+			rest += divHigh;
+			if (rest > lowMask)
+			{
+				break;
+			}
+		}
+		remainder = ((middle << halfBits) + lowLow - q0 * divisor) >> shift;
+		return (q1 << halfBits) | q0;
+	}
+};
+
+#if !defined(__SIZEOF_INT128__)
+template <>
+struct DoubleWidth<unsigned long>
+{
+	typedef void type;
+};
+
+template <>
+struct DoubleWidth<unsigned long long>
+{
+	typedef void type;
+};
+
+template <>
+struct WideArithmetic<unsigned long, void> : public HalfWordArithmetic<unsigned long>
+{
+};
+
+template <>
+struct WideArithmetic<unsigned long long, void> : public HalfWordArithmetic<unsigned long long>
+{
+};
+#endif
+
+/**
+ * Kernels working on little endian limb arrays (least significant limb first). Results may alias the
+ * first operand, the sizes are given in limbs and are never zero unless stated otherwise.
+ */
+template <typename BaseType>
+struct LimbArithmetic
+{
+	static_assert(!std::numeric_limits<BaseType>::is_signed, "LimbArithmetic needs an unsigned BaseType");
+
+	typedef WideArithmetic<BaseType> Wide;
+
+	static const unsigned int bits = sizeof(BaseType) << 3;
+
+	/// a + b + carry, the new carry (0 or 1) is written back to carry
+	static constexpr BaseType addWithCarry (BaseType a, BaseType b, unsigned char& carry)
+	{
+		BaseType sum = a + b;
+		unsigned char carryOut = (sum < a);
+		BaseType result = sum + carry;
+		carry = carryOut | (result < sum);
+		return result;
+	}
+
+	/// a - b - borrow, the new borrow (0 or 1) is written back to borrow
+	static constexpr BaseType subWithBorrow (BaseType a, BaseType b, unsigned char& borrow)
+	{
+		BaseType difference = a - b;
+		unsigned char borrowOut = (a < b);
+		BaseType result = difference - borrow;
+		borrow = borrowOut | (difference < borrow);
+		return result;
+	}
+
+	/// result = a + b for n limbs, returns the carry
+	static BaseType addN (BaseType* result, const BaseType* a, const BaseType* b, std::size_t n)
+	{
+		unsigned char carry = 0;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			result[i] = addWithCarry (a[i], b[i], carry);
+		}
+		return carry;
+	}
+
+	/// result = a - b for n limbs, returns the borrow
+	static BaseType subN (BaseType* result, const BaseType* a, const BaseType* b, std::size_t n)
+	{
+		unsigned char borrow = 0;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			result[i] = subWithBorrow (a[i], b[i], borrow);
+		}
+		return borrow;
+	}
+
+	/// result = a + limb, returns the carry, n may be zero
+	static BaseType addLimb (BaseType* result, const BaseType* a, std::size_t n, BaseType limb)
+	{
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			BaseType sum = a[i] + limb;
+			limb = (sum < limb);
+			result[i] = sum;
+			if (limb == 0)
+			{
+				copyRest (result, a, i + 1, n);
+				return 0;
+			}
+		}
+		return limb;
+	}
+
+	/// result = a - limb, returns the borrow, n may be zero
+	static BaseType subLimb (BaseType* result, const BaseType* a, std::size_t n, BaseType limb)
+	{
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			BaseType entry = a[i];
+			result[i] = entry - limb;
+			limb = (entry < limb);
+			if (limb == 0)
+			{
+				copyRest (result, a, i + 1, n);
+				return 0;
+			}
+		}
+		return limb;
+	}
+
+	/// result = a + b with aSize >= bSize, returns the carry
+	static BaseType add (BaseType* result, const BaseType* a, std::size_t aSize, const BaseType* b, std::size_t bSize)
+	{
+		BaseType carry = addN (result, a, b, bSize);
+		return addLimb (result + bSize, a + bSize, aSize - bSize, carry);
+	}
+
+	/// result = a - b with aSize >= bSize, returns the borrow
+	static BaseType sub (BaseType* result, const BaseType* a, std::size_t aSize, const BaseType* b, std::size_t bSize)
+	{
+		BaseType borrow = subN (result, a, b, bSize);
+		return subLimb (result + bSize, a + bSize, aSize - bSize, borrow);
+	}
+
+	/// result = a * limb, returns the high limb
+	static BaseType mulLimb (BaseType* result, const BaseType* a, std::size_t n, BaseType limb)
+	{
+		BaseType carry = 0;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			BaseType high;
+			BaseType low = Wide::mulWide (a[i], limb, high);
+			low += carry;
+			carry = high + (low < carry);
+			result[i] = low;
+		}
+		return carry;
+	}
+
+	/// result += a * limb, returns the limb carried out of result[n-1]
+	static BaseType addMulLimb (BaseType* result, const BaseType* a, std::size_t n, BaseType limb)
+	{
+		BaseType carry = 0;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			BaseType high;
+			BaseType low = Wide::mulWide (a[i], limb, high);
+			low += carry;
+			high += (low < carry);
+			BaseType entry = result[i];
+			low += entry;
+			carry = high + (low < entry);
+			result[i] = low;
+		}
+		return carry;
+	}
+
+	/// result -= a * limb, returns the limb borrowed beyond result[n-1]
+	static BaseType subMulLimb (BaseType* result, const BaseType* a, std::size_t n, BaseType limb)
+	{
+		BaseType borrow = 0;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			BaseType high;
+			BaseType low = Wide::mulWide (a[i], limb, high);
+			low += borrow;
+			high += (low < borrow);
+			BaseType entry = result[i];
+			result[i] = entry - low;
+			borrow = high + (entry < low);
+		}
+		return borrow;
+	}
+
+	/// number of leading zero bits of a limb that is not zero
+	static constexpr unsigned int leadingZeros (BaseType limb)
+	{
+		return __builtin_clzll ((unsigned long long) limb) - (64 - bits);
+	}
+
+	/// number of trailing zero bits of a limb that is not zero
+	static unsigned int trailingZeros (BaseType limb)
+	{
+		return __builtin_ctzll ((unsigned long long) limb);
+	}
+
+	/// number of set bits in n limbs
+	static std::size_t popCountN (const BaseType* a, std::size_t n)
+	{
+		std::size_t count = 0;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			count += __builtin_popcountll ((unsigned long long) a[i]);
+		}
+		return count;
+	}
+
+	/// result = 2^(n * bits) - a, the two's complement of n limbs, returns 1 unless a is zero
+	static BaseType negateN (BaseType* result, const BaseType* a, std::size_t n)
+	{
+		std::size_t i = 0;
+		for (; (i < n) && (a[i] == 0); ++i)
+		{
+			result[i] = 0;
+		}
+		if (i == n)
+		{
+			return 0;
+		}
+		result[i] = (BaseType) -a[i];
+		for (++i; i < n; ++i)
+		{
+			result[i] = (BaseType) ~a[i];
+		}
+		return 1;
+	}
+
+	/**
+	 * floor ((B^2 - 1) / divisor) - B for a normalized divisor (highest bit set), B = 2^bits.
+	 * With it divWidePreinverted replaces the hardware division by two multiplications.
+	 */
+	static BaseType reciprocal (BaseType divisor)
+	{
+		BaseType remainder;
+		return Wide::divWide ((BaseType) ~divisor, (BaseType) ~(BaseType) 0, divisor, remainder);
+	}
+
+	/**
+	 * divides (high, low) by a normalized divisor with high < divisor, inverse = reciprocal (divisor).
+	 * Algorithm 4 of Moeller and Granlund, "Improved division by invariant integers".
+	 */
+	static BaseType divWidePreinverted (BaseType high, BaseType low, BaseType divisor, BaseType inverse, BaseType& remainder)
+	{
+		BaseType quotientHigh;
+		BaseType quotientLow = Wide::mulWide (inverse, high, quotientHigh);
+		quotientLow += low;
+		quotientHigh += high + 1 + (quotientLow < low);
+		BaseType rest = low - quotientHigh * divisor;
+		if (rest > quotientLow)
+		{
+			--quotientHigh;
+			rest += divisor;
+		}
+		if (rest >= divisor)
+		{
+			++quotientHigh;
+			rest -= divisor;
+		}
+		remainder = rest;
+		return quotientHigh;
+	}
+
+	/// quotient = a / divisor, returns the remainder. quotient may alias a, n may be zero
+	static BaseType divRemLimb (BaseType* quotient, const BaseType* a, std::size_t n, BaseType divisor)
+	{
+		if (n == 0)
+		{
+			return 0;
+		}
+		unsigned int shift = leadingZeros (divisor);
+		divisor <<= shift;
+		BaseType inverse = reciprocal (divisor);
+		BaseType remainder = 0;
+		if (shift == 0)
+		{
+			for (std::size_t i = n; i > 0; --i)
+			{
+				quotient[i - 1] = divWidePreinverted (remainder, a[i - 1], divisor, inverse, remainder);
+			}
+			return remainder;
+		}
+		// the dividend is shifted on the fly, the shifted remainder is shifted back at the end
+		remainder = a[n - 1] >> (bits - shift);
+		for (std::size_t i = n - 1; i > 0; --i)
+		{
+			BaseType shifted = (BaseType) (a[i] << shift) | (a[i - 1] >> (bits - shift));
+			quotient[i] = divWidePreinverted (remainder, shifted, divisor, inverse, remainder);
+		}
+		quotient[0] = divWidePreinverted (remainder, (BaseType) (a[0] << shift), divisor, inverse, remainder);
+		return remainder >> shift;
+	}
+
+	/// result = a << shift with 0 < shift < bits, returns the bits shifted out
+	static BaseType shiftLeftBits (BaseType* result, const BaseType* a, std::size_t n, unsigned int shift)
+	{
+		BaseType outBits = a[n - 1] >> (bits - shift);
+		for (std::size_t i = n - 1; i > 0; --i)
+		{
+			result[i] = (a[i] << shift) | (a[i - 1] >> (bits - shift));
+		}
+		result[0] = a[0] << shift;
+		return outBits;
+	}
+
+	/// result = a >> shift with 0 < shift < bits, returns the bits shifted out (in the high part of the limb)
+	static BaseType shiftRightBits (BaseType* result, const BaseType* a, std::size_t n, unsigned int shift)
+	{
+		BaseType outBits = a[0] << (bits - shift);
+		for (std::size_t i = 0; i < n - 1; ++i)
+		{
+			result[i] = (a[i] >> shift) | (a[i + 1] << (bits - shift));
+		}
+		result[n - 1] = a[n - 1] >> shift;
+		return outBits;
+	}
+
+	/// compares n limbs, returns -1, 0 or 1
+	static int compareN (const BaseType* a, const BaseType* b, std::size_t n)
+	{
+		for (std::size_t i = n; i > 0; --i)
+		{
+			if (a[i - 1] != b[i - 1])
+			{
+				return (a[i - 1] < b[i - 1]) ? -1 : 1;
+			}
+		}
+		return 0;
+	}
+
+	/// compares two limb arrays without leading zeroes, returns -1, 0 or 1
+	static int compare (const BaseType* a, std::size_t aSize, const BaseType* b, std::size_t bSize)
+	{
+		if (aSize != bSize)
+		{
+			return (aSize < bSize) ? -1 : 1;
+		}
+		return compareN (a, b, aSize);
+	}
+
+	/// copies a[from, n) to result unless both are the same array
+	static void copyRest (BaseType* result, const BaseType* a, std::size_t from, std::size_t n)
+	{
+		if (result != a)
+		{
+			for (std::size_t i = from; i < n; ++i)
+			{
+				result[i] = a[i];
+			}
+		}
+	}
+
+	/// number of 64 bit words needed for n limbs
+	static std::size_t wordCount (std::size_t n)
+	{
+		return (n * sizeof(BaseType) + 7) / 8;
+	}
+
+	/// packs n limbs into wordCount (n) 64 bit words, least significant first
+	static void packWords (std::uint64_t* words, const BaseType* a, std::size_t n)
+	{
+		const std::size_t limbsPerWord = 8 / sizeof(BaseType);
+		for (std::size_t i = 0; i < wordCount (n); ++i)
+		{
+			words[i] = 0;
+		}
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			words[i / limbsPerWord] |= (std::uint64_t) a[i] << ((i % limbsPerWord) * bits);
+		}
+	}
+
+	/// unpacks n limbs out of 64 bit words, the inverse of packWords
+	static void unpackWords (BaseType* result, const std::uint64_t* words, std::size_t n)
+	{
+		const std::size_t limbsPerWord = 8 / sizeof(BaseType);
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			result[i] = (BaseType) (words[i / limbsPerWord] >> ((i % limbsPerWord) * bits));
+		}
+	}
+
+	/// number of limbs without the leading zero limbs
+	static std::size_t normalizedSize (const BaseType* a, std::size_t n)
+	{
+		while ((n > 0) && (a[n - 1] == 0))
+		{
+			--n;
+		}
+		return n;
+	}
+};
+
+#if defined(__x86_64__)
+template <>
+inline unsigned long long LimbArithmetic<unsigned long long>::addN (unsigned long long* result, const unsigned long long* a,
+		const unsigned long long* b, std::size_t n)
+{
+#if defined(UTILITIES_VECTOR_LIMBS)
+	if ((n >= LimbVectorArithmetic::minimumSize) && (LimbVectorArithmetic::level () != LimbVectorArithmetic::Scalar))
+	{
+		return LimbVectorArithmetic::addN (result, a, b, n);
+	}
+#endif
+	unsigned char carry = 0;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		carry = _addcarry_u64 (carry, a[i], b[i], result + i);
+	}
+	return carry;
+}
+
+template <>
+inline unsigned long long LimbArithmetic<unsigned long long>::subN (unsigned long long* result, const unsigned long long* a,
+		const unsigned long long* b, std::size_t n)
+{
+#if defined(UTILITIES_VECTOR_LIMBS)
+	if ((n >= LimbVectorArithmetic::minimumSize) && (LimbVectorArithmetic::level () != LimbVectorArithmetic::Scalar))
+	{
+		return LimbVectorArithmetic::subN (result, a, b, n);
+	}
+#endif
+	unsigned char borrow = 0;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		borrow = _subborrow_u64 (borrow, a[i], b[i], result + i);
+	}
+	return borrow;
+}
+
+template <>
+inline unsigned long LimbArithmetic<unsigned long>::addN (unsigned long* result, const unsigned long* a,
+		const unsigned long* b, std::size_t n)
+{
+#if defined(UTILITIES_VECTOR_LIMBS)
+	if ((n >= LimbVectorArithmetic::minimumSize) && (LimbVectorArithmetic::level () != LimbVectorArithmetic::Scalar))
+	{
+		return LimbVectorArithmetic::addN (result, a, b, n);
+	}
+#endif
+	unsigned char carry = 0;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		// the intrinsic writes an unsigned long long, which must not alias the unsigned long array
+		unsigned long long sum;
+		carry = _addcarry_u64 (carry, a[i], b[i], &sum);
+		result[i] = sum;
+	}
+	return carry;
+}
+
+template <>
+inline unsigned long LimbArithmetic<unsigned long>::subN (unsigned long* result, const unsigned long* a,
+		const unsigned long* b, std::size_t n)
+{
+#if defined(UTILITIES_VECTOR_LIMBS)
+	if ((n >= LimbVectorArithmetic::minimumSize) && (LimbVectorArithmetic::level () != LimbVectorArithmetic::Scalar))
+	{
+		return LimbVectorArithmetic::subN (result, a, b, n);
+	}
+#endif
+	unsigned char borrow = 0;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		unsigned long long difference;
+		borrow = _subborrow_u64 (borrow, a[i], b[i], &difference);
+		result[i] = difference;
+	}
+	return borrow;
+}
+#endif
+
+#if defined(UTILITIES_VECTOR_LIMBS)
+template <>
+inline int LimbArithmetic<unsigned long long>::compareN (const unsigned long long* a, const unsigned long long* b, std::size_t n)
+{
+	if ((n >= LimbVectorArithmetic::minimumSize) && (LimbVectorArithmetic::level () != LimbVectorArithmetic::Scalar))
+	{
+		return LimbVectorArithmetic::compareN (a, b, n);
+	}
+	for (std::size_t i = n; i > 0; --i)
+	{
+		if (a[i - 1] != b[i - 1])
+		{
+			return (a[i - 1] < b[i - 1]) ? -1 : 1;
+		}
+	}
+	return 0;
+}
+
+template <>
+inline int LimbArithmetic<unsigned long>::compareN (const unsigned long* a, const unsigned long* b, std::size_t n)
+{
+	if ((n >= LimbVectorArithmetic::minimumSize) && (LimbVectorArithmetic::level () != LimbVectorArithmetic::Scalar))
+	{
+		return LimbVectorArithmetic::compareN (a, b, n);
+	}
+	for (std::size_t i = n; i > 0; --i)
+	{
+		if (a[i - 1] != b[i - 1])
+		{
+			return (a[i - 1] < b[i - 1]) ? -1 : 1;
+		}
+	}
+	return 0;
+}
+
+/// most numbers have a non zero top limb, so that one is checked before the kernel is called
+template <>
+inline std::size_t LimbArithmetic<unsigned long long>::normalizedSize (const unsigned long long* a, std::size_t n)
+{
+	if ((n >= LimbVectorArithmetic::minimumSize) && (a[n - 1] == 0) && (LimbVectorArithmetic::level () != LimbVectorArithmetic::Scalar))
+	{
+		return LimbVectorArithmetic::normalizedSize (a, n);
+	}
+	while ((n > 0) && (a[n - 1] == 0))
+	{
+		--n;
+	}
+	return n;
+}
+
+template <>
+inline std::size_t LimbArithmetic<unsigned long>::normalizedSize (const unsigned long* a, std::size_t n)
+{
+	if ((n >= LimbVectorArithmetic::minimumSize) && (a[n - 1] == 0) && (LimbVectorArithmetic::level () != LimbVectorArithmetic::Scalar))
+	{
+		return LimbVectorArithmetic::normalizedSize (a, n);
+	}
+	while ((n > 0) && (a[n - 1] == 0))
+	{
+		--n;
+	}
+	return n;
+}
+
+template <>
+inline std::size_t LimbArithmetic<unsigned long long>::popCountN (const unsigned long long* a, std::size_t n)
+{
+	if (LimbVectorArithmetic::level () != LimbVectorArithmetic::Scalar)
+	{
+		return LimbVectorArithmetic::popCountN (a, n);
+	}
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		count += __builtin_popcountll (a[i]);
+	}
+	return count;
+}
+
+template <>
+inline std::size_t LimbArithmetic<unsigned long>::popCountN (const unsigned long* a, std::size_t n)
+{
+	if (LimbVectorArithmetic::level () != LimbVectorArithmetic::Scalar)
+	{
+		return LimbVectorArithmetic::popCountN (a, n);
+	}
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		count += __builtin_popcountl (a[i]);
+	}
+	return count;
+}
+#endif
+
+}
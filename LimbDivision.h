@@ -0,0 +1,108 @@
+/*
+ * LimbDivision.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include "LimbArithmetic.h"
+#include "LimbStorage.h"
+
+namespace Utilities
+{
+
+/**
+ * Long division on limb arrays, see Knuth, TAOCP Vol. 2, 4.3.1 Algorithm D.
+ */
+template <typename BaseType>
+struct LimbDivision
+{
+	typedef LimbArithmetic<BaseType> Limbs;
+
+	/**
+	 * quotient = a / b and remainder = a % b for aSize >= bSize >= 2 and b without leading zeroes.
+	 * quotient gets aSize - bSize + 1 limbs, remainder bSize limbs, neither may overlap a or b.
+	 */
+	static void divide (BaseType* quotient, BaseType* remainder, const BaseType* a, std::size_t aSize, const BaseType* b, std::size_t bSize)
+	{
+		// normalize, so the highest bit of the divisor is set, the dividend gets an additional limb
+		unsigned int shift = Limbs::leadingZeros (b[bSize - 1]);
+		LimbStorage<BaseType> scratch (aSize + 1 + bSize);
+		BaseType* u = scratch.data ();
+		BaseType* v = u + aSize + 1;
+		if (shift > 0)
+		{
+			Limbs::shiftLeftBits (v, b, bSize, shift);
+			u[aSize] = Limbs::shiftLeftBits (u, a, aSize, shift);
+		}
+		else
+		{
+			std::copy (b, b + bSize, v);
+			std::copy (a, a + aSize, u);
+			u[aSize] = 0;
+		}
+
+		BaseType divisorTop = v[bSize - 1];
+		BaseType divisorNext = v[bSize - 2];
+		BaseType inverse = Limbs::reciprocal (divisorTop);
+		for (std::size_t j = aSize - bSize + 1; j-- > 0;)
+		{
+			BaseType high = u[j + bSize];
+			BaseType middle = u[j + bSize - 1];
+			BaseType low = u[j + bSize - 2];
+
+			// estimate the quotient limb from the top two limbs, it is at most two too big
+			BaseType quotientEstimate;
+			BaseType rest;
+			bool restOverflow = false;
+			if (high >= divisorTop)
+			{
+				quotientEstimate = ~(BaseType) 0;
+				rest = middle + divisorTop;
+				restOverflow = (rest < middle);
+			}
+			else
+			{
+				quotientEstimate = Limbs::divWidePreinverted (high, middle, divisorTop, inverse, rest);
+			}
+			while (!restOverflow)
+			{
+				BaseType productHigh;
+				BaseType productLow = Limbs::Wide::mulWide (quotientEstimate, divisorNext, productHigh);
+				if ((productHigh < rest) || ((productHigh == rest) && (productLow <= low)))
+				{
+					break;
+				}
+				--quotientEstimate;
+				BaseType oldRest = rest;
+				rest += divisorTop;
+				restOverflow = (rest < oldRest);
+			}
+
+			// multiply and subtract, in rare cases the estimate is still one too big
+			BaseType borrow = Limbs::subMulLimb (u + j, v, bSize, quotientEstimate);
+			u[j + bSize] = high - borrow;
+			if (high < borrow)
+			{
+				--quotientEstimate;
+				u[j + bSize] += Limbs::addN (u + j, u + j, v, bSize);
+			}
+			quotient[j] = quotientEstimate;
+		}
+
+		if (shift > 0)
+		{
+			Limbs::shiftRightBits (remainder, u, bSize, shift);
+		}
+		else
+		{
+			std::copy (u, u + bSize, remainder);
+		}
+	}
+};
+
+}
@@ -0,0 +1,181 @@
+/*
+ * LimbMultiplication.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include "LimbArithmetic.h"
+#include "LimbStorage.h"
+#include "BigIntegerTuning.h"
+
+namespace Utilities
+{
+
+/**
+ * Schoolbook and Karatsuba multiplication on limb arrays. The result never overlaps the operands and
+ * has room for aSize + bSize limbs, the operands are not empty.
+ */
+template <typename BaseType>
+struct LimbMultiplication
+{
+	typedef LimbArithmetic<BaseType> Limbs;
+	typedef BigIntegerTuning<BaseType> Tuning;
+
+	static void basecaseMultiply (BaseType* result, const BaseType* a, std::size_t aSize, const BaseType* b, std::size_t bSize)
+	{
+		result[aSize] = Limbs::mulLimb (result, a, aSize, b[0]);
+		for (std::size_t i = 1; i < bSize; ++i)
+		{
+			result[aSize + i] = Limbs::addMulLimb (result + i, a, aSize, b[i]);
+		}
+	}
+
+	/**
+	 * every product a[i] * a[j] with i != j is computed only once, the sum of them is doubled
+	 * and the squares a[i] * a[i] are added afterwards
+	 */
+	static void basecaseSquare (BaseType* result, const BaseType* a, std::size_t n)
+	{
+		result[0] = 0;
+		result[n] = Limbs::mulLimb (result + 1, a + 1, n - 1, a[0]);
+		for (std::size_t i = 1; i < n; ++i)
+		{
+			// the row ends in result[i + n], which none of the previous rows has touched yet
+			result[i + n] = Limbs::addMulLimb (result + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+		}
+		Limbs::shiftLeftBits (result, result, 2 * n, 1);
+		unsigned char carry = 0;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			BaseType high;
+			BaseType low = Limbs::Wide::mulWide (a[i], a[i], high);
+			result[2 * i] = Limbs::addWithCarry (result[2 * i], low, carry);
+			result[2 * i + 1] = Limbs::addWithCarry (result[2 * i + 1], high, carry);
+		}
+	}
+
+	/// picks schoolbook or Karatsuba, the operands may come in any order
+	static void multiply (BaseType* result, const BaseType* a, std::size_t aSize, const BaseType* b, std::size_t bSize)
+	{
+		if (aSize < bSize)
+		{
+			std::swap (a, b);
+			std::swap (aSize, bSize);
+		}
+		if ((bSize < 2) || (bSize < Tuning::karatsubaThreshold))
+		{
+			basecaseMultiply (result, a, aSize, b, bSize);
+		}
+		else
+		{
+			karatsubaMultiply (result, a, aSize, b, bSize);
+		}
+	}
+
+	static void square (BaseType* result, const BaseType* a, std::size_t n)
+	{
+		if ((n < 2) || (n < Tuning::karatsubaSquareThreshold))
+		{
+			basecaseSquare (result, a, n);
+		}
+		else
+		{
+			karatsubaSquare (result, a, n);
+		}
+	}
+
+	/**
+	 * a * b with aSize >= bSize. With a = a1 * B^m + a0 and b = b1 * B^m + b0 the middle coefficient
+	 * a0 * b1 + a1 * b0 is computed as a0 * b0 + a1 * b1 - (a0 - a1) * (b0 - b1), so three products of
+	 * half the size are needed.
+	 */
+	static void karatsubaMultiply (BaseType* result, const BaseType* a, std::size_t aSize, const BaseType* b, std::size_t bSize)
+	{
+		std::size_t m = (aSize + 1) / 2;
+		if (bSize <= m)
+		{
+			// b has no upper half, so a is multiplied in two pieces
+			multiply (result, a, m, b, bSize);
+			std::fill (result + m + bSize, result + aSize + bSize, 0);
+			LimbStorage<BaseType> upper (aSize - m + bSize);
+			multiply (upper.data (), a + m, aSize - m, b, bSize);
+			Limbs::addN (result + m, result + m, upper.data (), upper.size ());
+			return;
+		}
+		std::size_t aHighSize = aSize - m;
+		std::size_t bHighSize = bSize - m;
+
+		multiply (result, a, m, b, m);
+		multiply (result + 2 * m, a + m, aHighSize, b + m, bHighSize);
+
+		LimbStorage<BaseType> scratch (6 * m + 1);
+		BaseType* aDiff = scratch.data ();
+		BaseType* bDiff = aDiff + m;
+		BaseType* middle = bDiff + m;
+		BaseType* diffProduct = middle + 2 * m + 1;
+		bool aNegative = absoluteDifference (aDiff, a, m, a + m, aHighSize);
+		bool bNegative = absoluteDifference (bDiff, b, m, b + m, bHighSize);
+		multiply (diffProduct, aDiff, m, bDiff, m);
+
+		std::size_t highSize = aHighSize + bHighSize;
+		middle[2 * m] = Limbs::add (middle, result, 2 * m, result + 2 * m, highSize);
+		if (aNegative == bNegative)
+		{
+			middle[2 * m] -= Limbs::subN (middle, middle, diffProduct, 2 * m);
+		}
+		else
+		{
+			middle[2 * m] += Limbs::addN (middle, middle, diffProduct, 2 * m);
+		}
+		addShifted (result, aSize + bSize, middle, 2 * m + 1, m);
+	}
+
+	static void karatsubaSquare (BaseType* result, const BaseType* a, std::size_t n)
+	{
+		std::size_t m = (n + 1) / 2;
+		std::size_t highSize = n - m;
+
+		square (result, a, m);
+		square (result + 2 * m, a + m, highSize);
+
+		LimbStorage<BaseType> scratch (5 * m + 1);
+		BaseType* diff = scratch.data ();
+		BaseType* middle = diff + m;
+		BaseType* diffSquare = middle + 2 * m + 1;
+		absoluteDifference (diff, a, m, a + m, highSize);
+		square (diffSquare, diff, m);
+
+		middle[2 * m] = Limbs::add (middle, result, 2 * m, result + 2 * m, 2 * highSize);
+		middle[2 * m] -= Limbs::subN (middle, middle, diffSquare, 2 * m);
+		addShifted (result, 2 * n, middle, 2 * m + 1, m);
+	}
+
+	/**
+	 * result = |x - y| with xSize >= ySize, result has xSize limbs. Returns true if x < y.
+	 */
+	static bool absoluteDifference (BaseType* result, const BaseType* x, std::size_t xSize, const BaseType* y, std::size_t ySize)
+	{
+		if ((Limbs::normalizedSize (x + ySize, xSize - ySize) == 0) && (Limbs::compareN (x, y, ySize) < 0))
+		{
+			Limbs::subN (result, y, x, ySize);
+			std::fill (result + ySize, result + xSize, 0);
+			return true;
+		}
+		Limbs::sub (result, x, xSize, y, ySize);
+		return false;
+	}
+
+	/// target += value * B^offset, the sum has to fit into targetSize limbs
+	static void addShifted (BaseType* target, std::size_t targetSize, const BaseType* value, std::size_t valueSize, std::size_t offset)
+	{
+		valueSize = Limbs::normalizedSize (value, valueSize);
+		Limbs::add (target + offset, target + offset, targetSize - offset, value, valueSize);
+	}
+};
+
+}
@@ -0,0 +1,315 @@
+/*
+ * LimbStorage.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <new>
+#include <utility>
+#include "BigIntegerInstrumentation.h"
+#include "LimbArena.h"
+
+namespace Utilities
+{
+
+/**
+ * Number of limbs a LimbStorage keeps inside the object before it goes to the heap. Specialize it to
+ * change the default of 32 bytes, which are four 64 bit limbs.
+ */
+template <typename BaseType>
+struct LimbStorageTraits
+{
+	static const std::size_t inlineLimbs = 32 / sizeof(BaseType);
+};
+
+/**
+ * A vector of limbs with a small buffer: up to InlineLimbs limbs live inside the object, only longer
+ * arrays are allocated. Like in std::vector, resize fills new limbs with zero. Moving takes over the heap
+ * buffer or copies the inline one, both in constant time. A storage belongs to the LimbArena which was
+ * current when it was constructed: its heap limbs come from that arena while it is still current, otherwise
+ * from the global heap. So a number made outside of a ScopedLimbArena never gets limbs from an arena, even
+ * if it grows inside the scope, and limbs of an arena are copied rather than moved into such a number.
+ */
+template <typename BaseType, std::size_t InlineLimbs = LimbStorageTraits<BaseType>::inlineLimbs>
+class LimbStorage
+{
+	static_assert(InlineLimbs > 0, "LimbStorage needs at least one inline limb");
+
+public:
+	typedef BaseType value_type;
+	typedef BaseType* iterator;
+	typedef const BaseType* const_iterator;
+
+	LimbStorage () : LimbStorage (HomeTag (), LimbArena::current ())
+	{
+	}
+	explicit LimbStorage (std::size_t size, BaseType value = 0) : LimbStorage ()
+	{
+		resize (size, value);
+	}
+	LimbStorage (const BaseType* first, const BaseType* last) : LimbStorage ()
+	{
+		assign (first, last);
+	}
+	LimbStorage (const LimbStorage& copy) : LimbStorage ()
+	{
+		assign (copy.begin (), copy.end ());
+	}
+	LimbStorage (LimbStorage&& source) : LimbStorage ()
+	{
+		moveFrom (source);
+	}
+	~LimbStorage ()
+	{
+		release ();
+	}
+
+	LimbStorage& operator= (const LimbStorage& rhs)
+	{
+		if (this != &rhs)
+		{
+			assign (rhs.begin (), rhs.end ());
+		}
+		return *this;
+	}
+
+	LimbStorage& operator= (LimbStorage&& rhs)
+	{
+		if (this != &rhs)
+		{
+			release ();
+			moveFrom (rhs);
+		}
+		return *this;
+	}
+
+	std::size_t size () const
+	{
+		return _size;
+	}
+
+	bool empty () const
+	{
+		return _size == 0;
+	}
+
+	std::size_t capacity () const
+	{
+		return _capacity;
+	}
+
+	/// true as long as the limbs live inside the object
+	bool isInline () const
+	{
+		return _data == _inline;
+	}
+
+	BaseType* data ()
+	{
+		return _data;
+	}
+
+	const BaseType* data () const
+	{
+		return _data;
+	}
+
+	BaseType& operator[] (std::size_t index)
+	{
+		return _data[index];
+	}
+
+	const BaseType& operator[] (std::size_t index) const
+	{
+		return _data[index];
+	}
+
+	BaseType& back ()
+	{
+		return _data[_size - 1];
+	}
+
+	const BaseType& back () const
+	{
+		return _data[_size - 1];
+	}
+
+	iterator begin ()
+	{
+		return _data;
+	}
+
+	iterator end ()
+	{
+		return _data + _size;
+	}
+
+	const_iterator begin () const
+	{
+		return _data;
+	}
+
+	const_iterator end () const
+	{
+		return _data + _size;
+	}
+
+	void clear ()
+	{
+		_size = 0;
+	}
+
+	void push_back (BaseType limb)
+	{
+		if (_size == _capacity)
+		{
+			grow (_size + 1);
+		}
+		_data[_size++] = limb;
+	}
+
+	void pop_back ()
+	{
+		--_size;
+	}
+
+	void reserve (std::size_t capacity)
+	{
+		if (capacity > _capacity)
+		{
+			grow (capacity);
+		}
+	}
+
+	void resize (std::size_t size, BaseType value = 0)
+	{
+		reserve (size);
+		if (size > _size)
+		{
+			std::fill (_data + _size, _data + size, value);
+		}
+		_size = size;
+	}
+
+	void assign (std::size_t size, BaseType value)
+	{
+		_size = 0;
+		resize (size, value);
+	}
+
+	/// the range must not be part of this storage
+	void assign (const BaseType* first, const BaseType* last)
+	{
+		_size = 0;
+		reserve (last - first);
+		std::copy (first, last, _data);
+		_size = last - first;
+	}
+
+	void swap (LimbStorage& other)
+	{
+		LimbStorage temp (HomeTag (), other._home);
+		temp.moveFrom (other);
+		other = std::move (*this);
+		*this = std::move (temp);
+	}
+
+private:
+	struct HomeTag
+	{
+	};
+
+	LimbStorage (HomeTag, LimbArena* home) : _data(_inline), _size(0), _capacity(InlineLimbs), _arena(nullptr), _home(home)
+	{
+	}
+
+	/// at least doubles the capacity, so push_back is amortized constant
+	void grow (std::size_t minimum)
+	{
+		std::size_t capacity = std::max (minimum, 2 * _capacity);
+		LimbArena* arena = (_home == LimbArena::current ()) ? _home : nullptr;
+		BaseType* data = allocate (capacity, arena);
+		std::copy (_data, _data + _size, data);
+		release ();
+		_data = data;
+		_capacity = capacity;
+		_arena = arena;
+	}
+
+	/// frees a heap buffer and goes back to the inline one, the size is not touched
+	void release ()
+	{
+		if (_data != _inline)
+		{
+			deallocate (_data, _capacity, _arena);
+		}
+		_data = _inline;
+		_capacity = InlineLimbs;
+		_arena = nullptr;
+	}
+
+	/// this has to be empty and inline, source is left empty. Limbs of an arena this storage does not belong to are copied.
+	void moveFrom (LimbStorage& source)
+	{
+		if (source.isInline () || ((source._arena != nullptr) && (source._arena != _home)))
+		{
+			assign (source.begin (), source.end ());
+			source.release ();
+		}
+		else
+		{
+			_data = source._data;
+			_capacity = source._capacity;
+			_arena = source._arena;
+			source._data = source._inline;
+			source._capacity = InlineLimbs;
+			source._arena = nullptr;
+		}
+		_size = source._size;
+		source._size = 0;
+	}
+
+	static BaseType* allocate (std::size_t size, LimbArena* arena)
+	{
+		UTILITIES_INSTRUMENT_ALLOCATION (size * sizeof(BaseType), arena != nullptr);
+		if (arena != nullptr)
+		{
+			return static_cast<BaseType*> (arena->allocate (size * sizeof(BaseType)));
+		}
+		return static_cast<BaseType*> (::operator new (size * sizeof(BaseType)));
+	}
+
+	static void deallocate (BaseType* data, std::size_t size, LimbArena* arena)
+	{
+		if (arena != nullptr)
+		{
+			arena->deallocate (data, size * sizeof(BaseType));
+		}
+		else
+		{
+			::operator delete (data);
+		}
+	}
+
+	BaseType* _data;
+	std::size_t _size;
+	std::size_t _capacity;
+	/// where the heap limbs came from, nullptr for the global heap
+	LimbArena* _arena;
+	/// the arena current at construction, the only one new heap limbs may come from
+	LimbArena* _home;
+	BaseType _inline[InlineLimbs];
+};
+
+template <typename BaseType, std::size_t InlineLimbs>
+void swap (LimbStorage<BaseType, InlineLimbs>& a, LimbStorage<BaseType, InlineLimbs>& b)
+{
+	a.swap (b);
+}
+
+}
@@ -0,0 +1,347 @@
+/*
+ * LimbVectorArithmetic.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define UTILITIES_VECTOR_LIMBS 1
+#endif
+
+namespace Utilities
+{
+
+#if defined(UTILITIES_VECTOR_LIMBS)
+
+/**
+ * AVX2 and AVX-512 kernels for arrays of 64 bit limbs, selected at runtime by the features of the CPU.
+ * Limb is unsigned long or unsigned long long, the limbs are only accessed by unaligned vector loads and
+ * stores and by the scalar tails. Carries and borrows are resolved for a whole block at once: every lane
+ * either generates a carry (its sum wrapped around) or propagates an incoming one (its sum is all ones),
+ * so the carry into every lane follows from one scalar addition of the lane bit masks, like in a carry
+ * lookahead adder. The sums are then corrected by adding the carries lane by lane.
+ */
+struct LimbVectorArithmetic
+{
+	enum Level
+	{
+		Scalar, Avx2, Avx512
+	};
+
+	/// the kernels in use, detected on first use, it can be lowered (not raised) at startup, e.g. for comparisons
+	static Level& level ()
+	{
+		static Level level = detectLevel ();
+		return level;
+	}
+
+	/// arrays below this size stay with the scalar code, the setup of the vector kernels does not pay off for them
+	static const std::size_t minimumSize = 32;
+
+	template <typename Limb>
+	static Limb addN (Limb* result, const Limb* a, const Limb* b, std::size_t n)
+	{
+		return (level () == Avx512) ? addN512 (result, a, b, n) : addN256 (result, a, b, n);
+	}
+
+	template <typename Limb>
+	static Limb subN (Limb* result, const Limb* a, const Limb* b, std::size_t n)
+	{
+		return (level () == Avx512) ? subN512 (result, a, b, n) : subN256 (result, a, b, n);
+	}
+
+	template <typename Limb>
+	static int compareN (const Limb* a, const Limb* b, std::size_t n)
+	{
+		return (level () == Avx512) ? compareN512 (a, b, n) : compareN256 (a, b, n);
+	}
+
+	template <typename Limb>
+	static std::size_t normalizedSize (const Limb* a, std::size_t n)
+	{
+		return (level () == Avx512) ? normalizedSize512 (a, n) : normalizedSize256 (a, n);
+	}
+
+	/// every CPU with AVX2 has the popcnt instruction, which the builtin only uses with the target enabled
+	template <typename Limb>
+	__attribute__((target("popcnt")))
+	static std::size_t popCountN (const Limb* a, std::size_t n)
+	{
+		std::size_t count = 0;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			count += __builtin_popcountll (a[i]);
+		}
+		return count;
+	}
+
+private:
+	static Level detectLevel ()
+	{
+		__builtin_cpu_init ();
+		if (__builtin_cpu_supports ("avx512f"))
+		{
+			return Avx512;
+		}
+		return __builtin_cpu_supports ("avx2") ? Avx2 : Scalar;
+	}
+
+	/**
+	 * the carries into the lanes of a block for the lane masks of generated and propagated carries and the
+	 * carry into the block, the carry out of the block goes to carry
+	 */
+	static unsigned int laneCarries (unsigned int generate, unsigned int propagate, unsigned int lanes, unsigned int& carry)
+	{
+		unsigned int sum = (generate | propagate) + generate + carry;
+		carry = sum >> lanes;
+		return (sum ^ propagate) & ((1u << lanes) - 1);
+	}
+
+	template <typename Limb>
+	static Limb addTail (Limb* result, const Limb* a, const Limb* b, std::size_t i, std::size_t n, unsigned char carry)
+	{
+		for (; i < n; ++i)
+		{
+			unsigned long long sum;
+			carry = _addcarry_u64 (carry, a[i], b[i], &sum);
+			result[i] = sum;
+		}
+		return carry;
+	}
+
+	template <typename Limb>
+	static Limb subTail (Limb* result, const Limb* a, const Limb* b, std::size_t i, std::size_t n, unsigned char borrow)
+	{
+		for (; i < n; ++i)
+		{
+			unsigned long long difference;
+			borrow = _subborrow_u64 (borrow, a[i], b[i], &difference);
+			result[i] = difference;
+		}
+		return borrow;
+	}
+
+	/// lanes of 0 or 1 for the low four bits of mask
+	__attribute__((target("avx2")))
+	static __m256i laneBits256 (unsigned int mask)
+	{
+		return _mm256_and_si256 (_mm256_srlv_epi64 (_mm256_set1_epi64x (mask), _mm256_set_epi64x (3, 2, 1, 0)), _mm256_set1_epi64x (1));
+	}
+
+	/// unsigned a < b by a signed comparison with flipped sign bits
+	__attribute__((target("avx2")))
+	static unsigned int lessMask256 (__m256i a, __m256i b)
+	{
+		const __m256i signBit = _mm256_set1_epi64x ((long long) (1ULL << 63));
+		__m256i less = _mm256_cmpgt_epi64 (_mm256_xor_si256 (b, signBit), _mm256_xor_si256 (a, signBit));
+		return _mm256_movemask_pd (_mm256_castsi256_pd (less));
+	}
+
+	__attribute__((target("avx2")))
+	static unsigned int equalMask256 (__m256i a, __m256i b)
+	{
+		return _mm256_movemask_pd (_mm256_castsi256_pd (_mm256_cmpeq_epi64 (a, b)));
+	}
+
+	/// two vectors of four lanes per step, so the scalar carry chain is shared by eight limbs
+	template <typename Limb>
+	__attribute__((target("avx2")))
+	static Limb addN256 (Limb* result, const Limb* a, const Limb* b, std::size_t n)
+	{
+		const __m256i ones = _mm256_set1_epi64x (-1);
+		unsigned int carry = 0;
+		std::size_t i = 0;
+		for (; i + 8 <= n; i += 8)
+		{
+			__m256i aLow = _mm256_loadu_si256 ((const __m256i*) (a + i));
+			__m256i aHigh = _mm256_loadu_si256 ((const __m256i*) (a + i + 4));
+			__m256i low = _mm256_add_epi64 (aLow, _mm256_loadu_si256 ((const __m256i*) (b + i)));
+			__m256i high = _mm256_add_epi64 (aHigh, _mm256_loadu_si256 ((const __m256i*) (b + i + 4)));
+			unsigned int generate = lessMask256 (low, aLow) | (lessMask256 (high, aHigh) << 4);
+			unsigned int propagate = equalMask256 (low, ones) | (equalMask256 (high, ones) << 4);
+			unsigned int carries = laneCarries (generate, propagate, 8, carry);
+			_mm256_storeu_si256 ((__m256i*) (result + i), _mm256_add_epi64 (low, laneBits256 (carries)));
+			_mm256_storeu_si256 ((__m256i*) (result + i + 4), _mm256_add_epi64 (high, laneBits256 (carries >> 4)));
+		}
+		return addTail (result, a, b, i, n, (unsigned char) carry);
+	}
+
+	/// a lane generates a borrow if a < b and propagates one if the difference is zero
+	template <typename Limb>
+	__attribute__((target("avx2")))
+	static Limb subN256 (Limb* result, const Limb* a, const Limb* b, std::size_t n)
+	{
+		const __m256i zero = _mm256_setzero_si256 ();
+		unsigned int borrow = 0;
+		std::size_t i = 0;
+		for (; i + 8 <= n; i += 8)
+		{
+			__m256i aLow = _mm256_loadu_si256 ((const __m256i*) (a + i));
+			__m256i aHigh = _mm256_loadu_si256 ((const __m256i*) (a + i + 4));
+			__m256i bLow = _mm256_loadu_si256 ((const __m256i*) (b + i));
+			__m256i bHigh = _mm256_loadu_si256 ((const __m256i*) (b + i + 4));
+			__m256i low = _mm256_sub_epi64 (aLow, bLow);
+			__m256i high = _mm256_sub_epi64 (aHigh, bHigh);
+			unsigned int generate = lessMask256 (aLow, bLow) | (lessMask256 (aHigh, bHigh) << 4);
+			unsigned int propagate = equalMask256 (low, zero) | (equalMask256 (high, zero) << 4);
+			unsigned int borrows = laneCarries (generate, propagate, 8, borrow);
+			_mm256_storeu_si256 ((__m256i*) (result + i), _mm256_sub_epi64 (low, laneBits256 (borrows)));
+			_mm256_storeu_si256 ((__m256i*) (result + i + 4), _mm256_sub_epi64 (high, laneBits256 (borrows >> 4)));
+		}
+		return subTail (result, a, b, i, n, (unsigned char) borrow);
+	}
+
+	/// the top n % 4 limbs are compared first, then blocks of four from the top
+	template <typename Limb>
+	__attribute__((target("avx2")))
+	static int compareN256 (const Limb* a, const Limb* b, std::size_t n)
+	{
+		for (; n % 4 != 0; --n)
+		{
+			if (a[n - 1] != b[n - 1])
+			{
+				return (a[n - 1] < b[n - 1]) ? -1 : 1;
+			}
+		}
+		for (; n > 0; n -= 4)
+		{
+			unsigned int equal = equalMask256 (_mm256_loadu_si256 ((const __m256i*) (a + n - 4)),
+					_mm256_loadu_si256 ((const __m256i*) (b + n - 4)));
+			if (equal != 0xF)
+			{
+				std::size_t lane = n - 4 + 31 - __builtin_clz (~equal & 0xF);
+				return (a[lane] < b[lane]) ? -1 : 1;
+			}
+		}
+		return 0;
+	}
+
+	template <typename Limb>
+	__attribute__((target("avx2")))
+	static std::size_t normalizedSize256 (const Limb* a, std::size_t n)
+	{
+		for (; n % 4 != 0; --n)
+		{
+			if (a[n - 1] != 0)
+			{
+				return n;
+			}
+		}
+		for (; n > 0; n -= 4)
+		{
+			__m256i block = _mm256_loadu_si256 ((const __m256i*) (a + n - 4));
+			if (!_mm256_testz_si256 (block, block))
+			{
+				unsigned int zero = equalMask256 (block, _mm256_setzero_si256 ());
+				return n - 4 + 32 - __builtin_clz (~zero & 0xF);
+			}
+		}
+		return 0;
+	}
+
+	/// two vectors of eight lanes per step with the carries in mask registers
+	template <typename Limb>
+	__attribute__((target("avx512f")))
+	static Limb addN512 (Limb* result, const Limb* a, const Limb* b, std::size_t n)
+	{
+		const __m512i ones = _mm512_set1_epi64 (-1);
+		const __m512i one = _mm512_set1_epi64 (1);
+		unsigned int carry = 0;
+		std::size_t i = 0;
+		for (; i + 16 <= n; i += 16)
+		{
+			__m512i aLow = _mm512_loadu_si512 (a + i);
+			__m512i aHigh = _mm512_loadu_si512 (a + i + 8);
+			__m512i low = _mm512_add_epi64 (aLow, _mm512_loadu_si512 (b + i));
+			__m512i high = _mm512_add_epi64 (aHigh, _mm512_loadu_si512 (b + i + 8));
+			unsigned int generate = _mm512_cmplt_epu64_mask (low, aLow) | (_mm512_cmplt_epu64_mask (high, aHigh) << 8);
+			unsigned int propagate = _mm512_cmpeq_epi64_mask (low, ones) | (_mm512_cmpeq_epi64_mask (high, ones) << 8);
+			unsigned int carries = laneCarries (generate, propagate, 16, carry);
+			_mm512_storeu_si512 (result + i, _mm512_mask_add_epi64 (low, (__mmask8) carries, low, one));
+			_mm512_storeu_si512 (result + i + 8, _mm512_mask_add_epi64 (high, (__mmask8) (carries >> 8), high, one));
+		}
+		return addTail (result, a, b, i, n, (unsigned char) carry);
+	}
+
+	template <typename Limb>
+	__attribute__((target("avx512f")))
+	static Limb subN512 (Limb* result, const Limb* a, const Limb* b, std::size_t n)
+	{
+		const __m512i zero = _mm512_setzero_si512 ();
+		const __m512i one = _mm512_set1_epi64 (1);
+		unsigned int borrow = 0;
+		std::size_t i = 0;
+		for (; i + 16 <= n; i += 16)
+		{
+			__m512i aLow = _mm512_loadu_si512 (a + i);
+			__m512i aHigh = _mm512_loadu_si512 (a + i + 8);
+			__m512i bLow = _mm512_loadu_si512 (b + i);
+			__m512i bHigh = _mm512_loadu_si512 (b + i + 8);
+			__m512i low = _mm512_sub_epi64 (aLow, bLow);
+			__m512i high = _mm512_sub_epi64 (aHigh, bHigh);
+			unsigned int generate = _mm512_cmplt_epu64_mask (aLow, bLow) | (_mm512_cmplt_epu64_mask (aHigh, bHigh) << 8);
+			unsigned int propagate = _mm512_cmpeq_epi64_mask (low, zero) | (_mm512_cmpeq_epi64_mask (high, zero) << 8);
+			unsigned int borrows = laneCarries (generate, propagate, 16, borrow);
+			_mm512_storeu_si512 (result + i, _mm512_mask_sub_epi64 (low, (__mmask8) borrows, low, one));
+			_mm512_storeu_si512 (result + i + 8, _mm512_mask_sub_epi64 (high, (__mmask8) (borrows >> 8), high, one));
+		}
+		return subTail (result, a, b, i, n, (unsigned char) borrow);
+	}
+
+	template <typename Limb>
+	__attribute__((target("avx512f")))
+	static int compareN512 (const Limb* a, const Limb* b, std::size_t n)
+	{
+		for (; n % 8 != 0; --n)
+		{
+			if (a[n - 1] != b[n - 1])
+			{
+				return (a[n - 1] < b[n - 1]) ? -1 : 1;
+			}
+		}
+		for (; n > 0; n -= 8)
+		{
+			unsigned int different = _mm512_cmpneq_epi64_mask (_mm512_loadu_si512 (a + n - 8), _mm512_loadu_si512 (b + n - 8));
+			if (different != 0)
+			{
+				std::size_t lane = n - 8 + 31 - __builtin_clz (different);
+				return (a[lane] < b[lane]) ? -1 : 1;
+			}
+		}
+		return 0;
+	}
+
+	template <typename Limb>
+	__attribute__((target("avx512f")))
+	static std::size_t normalizedSize512 (const Limb* a, std::size_t n)
+	{
+		for (; n % 8 != 0; --n)
+		{
+			if (a[n - 1] != 0)
+			{
+				return n;
+			}
+		}
+		for (; n > 0; n -= 8)
+		{
+			__m512i block = _mm512_loadu_si512 (a + n - 8);
+			unsigned int nonZero = _mm512_test_epi64_mask (block, block);
+			if (nonZero != 0)
+			{
+				return n - 8 + 32 - __builtin_clz (nonZero);
+			}
+		}
+		return 0;
+	}
+};
+
+#endif
+
+}
@@ -0,0 +1,425 @@
+/*
+ * ModularContext.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include "BigInteger.h"
+#include "LimbArithmetic.h"
+#include "LimbMultiplication.h"
+#include "LimbStorage.h"
+
+namespace Utilities
+{
+
+/**
+ * Arithmetic modulo a fixed positive modulus of n limbs. Odd moduli use Montgomery reduction with
+ * R = B^n, even ones Barrett reduction, both precomputed once in the constructor. All operations work on
+ * n limb arrays with scratch buffers of a size fixed by n, no division is done after the constructor.
+ * For even moduli the Montgomery form is simply the reduced number.
+ */
+template <typename BaseType = std::uint64_t>
+class ModularContext
+{
+public:
+	typedef BigIntegerBase<BaseType> Number;
+
+	/// throws std::domain_error if modulus is not positive
+	explicit ModularContext (const Number& modulus);
+
+	const Number& getModulus () const
+	{
+		return _modulus;
+	}
+
+	bool usesMontgomery () const
+	{
+		return _montgomery;
+	}
+
+	/// x mod modulus in [0, modulus), also for negative x
+	Number reduce (const Number& x) const;
+
+	/// a * b mod modulus for any a and b
+	Number mulmod (const Number& a, const Number& b) const;
+
+	/**
+	 * base^exponent mod modulus with sliding windows over the exponent bits, only the odd powers of base
+	 * up to the window size are precomputed. Throws std::domain_error for a negative exponent.
+	 */
+	Number powmod (const Number& base, const Number& exponent) const;
+
+	/// x * R mod modulus
+	Number toMontgomery (const Number& x) const;
+
+	/// x / R mod modulus for x in Montgomery form
+	Number fromMontgomery (const Number& x) const;
+
+	/// a * b / R mod modulus for a and b in Montgomery form, the result is in Montgomery form as well
+	Number montgomeryMultiply (const Number& a, const Number& b) const;
+
+private:
+	typedef LimbArithmetic<BaseType> Limbs;
+	typedef LimbMultiplication<BaseType> Multiplication;
+
+	/// limbs needed as scratch by reduceProduct
+	std::size_t scratchSize () const
+	{
+		return 4 * _size + 3;
+	}
+
+	/// the reduced a * b, with removeFactor the factor 1 / R of the Montgomery product is multiplied away
+	Number multiplyReduced (const Number& a, const Number& b, bool removeFactor) const;
+
+	/// result = a * b, reduced into the form, all arrays have n limbs, product 2n
+	void multiplyInForm (BaseType* result, const BaseType* a, const BaseType* b, BaseType* product, BaseType* scratch) const;
+
+	void squareInForm (BaseType* result, const BaseType* a, BaseType* product, BaseType* scratch) const;
+
+	/// result = product / R mod modulus or product mod modulus, the product of 2n limbs is overwritten
+	void reduceProduct (BaseType* result, BaseType* product, BaseType* scratch) const;
+
+	/// Montgomery's REDC on the 2n limb product, see Handbook of Applied Cryptography 14.32
+	void montgomeryReduce (BaseType* result, BaseType* product) const;
+
+	/// Barrett reduction of the 2n limb product, see Handbook of Applied Cryptography 14.42
+	void barrettReduce (BaseType* result, const BaseType* product, BaseType* scratch) const;
+
+	/// the n limbs of a number in [0, modulus)
+	void toLimbs (BaseType* limbs, const Number& reduced) const;
+
+	Number fromLimbs (const BaseType* limbs) const
+	{
+		return Number::fromLimbs (limbs, _size);
+	}
+
+	/// window width for the sliding window exponentiation
+	static unsigned int windowSize (unsigned int exponentBits);
+
+	Number _modulus;
+	std::size_t _size;
+	bool _montgomery;
+	/// -modulus^-1 mod B
+	BaseType _negativeInverse;
+	/// R^2 mod modulus, n limbs
+	LimbStorage<BaseType> _rSquared;
+	/// 1 in the form, n limbs
+	LimbStorage<BaseType> _one;
+	/// B^2n / modulus, n + 1 limbs
+	LimbStorage<BaseType> _barrettFactor;
+};
+
+template <typename BaseType>
+ModularContext<BaseType>::ModularContext (const Number& modulus) : _modulus(modulus), _negativeInverse(0)
+{
+	_size = _modulus.getRealSize ();
+	if ((_size == 0) || !_modulus.isPositive ())
+	{
+		throw std::domain_error("ModularContext needs a positive modulus");
+	}
+	_modulus.cleanLeadingZeroes ();
+	const BaseType* modulusLimbs = _modulus._bigNumber.data ();
+	_montgomery = ((modulusLimbs[0] & 1) != 0);
+	unsigned int limbBits = Number::_baseTypeSize;
+
+	Number power;
+	_one.resize (_size);
+	if (_montgomery)
+	{
+		// Newton iteration for modulus^-1 mod B, every step doubles the correct bits, starting with 3
+		unsigned long long inverse = modulusLimbs[0];
+		for (unsigned int bits = 3; bits < limbBits; bits *= 2)
+		{
+			inverse *= 2 - (unsigned long long) modulusLimbs[0] * inverse;
+		}
+		_negativeInverse = (BaseType) (0 - inverse);
+		power.setBit (2 * _size * limbBits);
+		_rSquared.resize (_size);
+		toLimbs (_rSquared.data (), power % _modulus);
+		power = Number ();
+		power.setBit (_size * limbBits);
+		toLimbs (_one.data (), power % _modulus);
+	}
+	else
+	{
+		power.setBit (2 * _size * limbBits);
+		Number factor = power / _modulus;
+		_barrettFactor.assign (factor._bigNumber.begin (), factor._bigNumber.end ());
+		_barrettFactor.resize (_size + 1);
+		toLimbs (_one.data (), Number (1) % _modulus);
+	}
+}
+
+template <typename BaseType>
+typename ModularContext<BaseType>::Number ModularContext<BaseType>::reduce (const Number& x) const
+{
+	if (x.isPositive () && (x < _modulus))
+	{
+		return x;
+	}
+	Number result = x % _modulus;
+	if (!result.isPositive () && (result.getRealSize () > 0))
+	{
+		result += _modulus;
+	}
+	return result;
+}
+
+template <typename BaseType>
+typename ModularContext<BaseType>::Number ModularContext<BaseType>::mulmod (const Number& a, const Number& b) const
+{
+	return multiplyReduced (a, b, _montgomery);
+}
+
+template <typename BaseType>
+typename ModularContext<BaseType>::Number ModularContext<BaseType>::toMontgomery (const Number& x) const
+{
+	if (!_montgomery)
+	{
+		return reduce (x);
+	}
+	LimbStorage<BaseType> limbs (_size);
+	LimbStorage<BaseType> product (2 * _size);
+	LimbStorage<BaseType> scratch (scratchSize ());
+	toLimbs (limbs.data (), reduce (x));
+	multiplyInForm (limbs.data (), limbs.data (), _rSquared.data (), product.data (), scratch.data ());
+	return fromLimbs (limbs.data ());
+}
+
+template <typename BaseType>
+typename ModularContext<BaseType>::Number ModularContext<BaseType>::fromMontgomery (const Number& x) const
+{
+	if (!_montgomery)
+	{
+		return reduce (x);
+	}
+	LimbStorage<BaseType> limbs (_size);
+	LimbStorage<BaseType> product (2 * _size);
+	toLimbs (product.data (), reduce (x));
+	montgomeryReduce (limbs.data (), product.data ());
+	return fromLimbs (limbs.data ());
+}
+
+template <typename BaseType>
+typename ModularContext<BaseType>::Number ModularContext<BaseType>::montgomeryMultiply (const Number& a, const Number& b) const
+{
+	return multiplyReduced (a, b, false);
+}
+
+template <typename BaseType>
+typename ModularContext<BaseType>::Number ModularContext<BaseType>::multiplyReduced (const Number& a, const Number& b, bool removeFactor) const
+{
+	LimbStorage<BaseType> aLimbs (_size);
+	LimbStorage<BaseType> bLimbs (_size);
+	LimbStorage<BaseType> product (2 * _size);
+	LimbStorage<BaseType> scratch (scratchSize ());
+	toLimbs (aLimbs.data (), reduce (a));
+	toLimbs (bLimbs.data (), reduce (b));
+	multiplyInForm (aLimbs.data (), aLimbs.data (), bLimbs.data (), product.data (), scratch.data ());
+	if (removeFactor)
+	{
+		// a * b / R * R^2 / R = a * b
+		multiplyInForm (aLimbs.data (), aLimbs.data (), _rSquared.data (), product.data (), scratch.data ());
+	}
+	return fromLimbs (aLimbs.data ());
+}
+
+template <typename BaseType>
+typename ModularContext<BaseType>::Number ModularContext<BaseType>::powmod (const Number& base, const Number& exponent) const
+{
+	if (!exponent.isPositive () && (exponent.getRealSize () > 0))
+	{
+		throw std::domain_error("ModularContext::powmod needs a non negative exponent");
+	}
+	unsigned int exponentBits = exponent.bitLength ();
+	if (exponentBits == 0)
+	{
+		return reduce (Number (1));
+	}
+	unsigned int window = windowSize (exponentBits);
+	std::size_t n = _size;
+	LimbStorage<BaseType> product (2 * n);
+	LimbStorage<BaseType> scratch (scratchSize ());
+	LimbStorage<BaseType> result (n);
+
+	// table[i] = base^(2i + 1) in the form
+	std::size_t tableSize = (std::size_t) 1 << (window - 1);
+	LimbStorage<BaseType> table (tableSize * n);
+	toLimbs (table.data (), toMontgomery (base));
+	if (tableSize > 1)
+	{
+		squareInForm (result.data (), table.data (), product.data (), scratch.data ());
+		for (std::size_t i = 1; i < tableSize; ++i)
+		{
+			multiplyInForm (table.data () + i * n, table.data () + (i - 1) * n, result.data (), product.data (), scratch.data ());
+		}
+	}
+
+	std::copy (_one.begin (), _one.end (), result.begin ());
+	bool isOne = true;
+	int bit = (int) exponentBits - 1;
+	while (bit >= 0)
+	{
+		if (!exponent.isBitSet (bit))
+		{
+			if (!isOne)
+			{
+				squareInForm (result.data (), result.data (), product.data (), scratch.data ());
+			}
+			--bit;
+			continue;
+		}
+		// the longest window of at most window bits starting at bit which ends with a one
+		int low = std::max (bit - (int) window + 1, 0);
+		while (!exponent.isBitSet (low))
+		{
+			++low;
+		}
+		std::size_t value = 0;
+		for (int i = bit; i >= low; --i)
+		{
+			value = (value << 1) | (exponent.isBitSet (i) ? 1 : 0);
+		}
+		const BaseType* power = table.data () + (value >> 1) * n;
+		if (isOne)
+		{
+			std::copy (power, power + n, result.begin ());
+			isOne = false;
+		}
+		else
+		{
+			for (int i = bit; i >= low; --i)
+			{
+				squareInForm (result.data (), result.data (), product.data (), scratch.data ());
+			}
+			multiplyInForm (result.data (), result.data (), power, product.data (), scratch.data ());
+		}
+		bit = low - 1;
+	}
+	if (!_montgomery)
+	{
+		return fromLimbs (result.data ());
+	}
+	std::fill (product.begin (), product.end (), 0);
+	std::copy (result.begin (), result.end (), product.begin ());
+	montgomeryReduce (result.data (), product.data ());
+	return fromLimbs (result.data ());
+}
+
+template <typename BaseType>
+void ModularContext<BaseType>::multiplyInForm (BaseType* result, const BaseType* a, const BaseType* b, BaseType* product,
+		BaseType* scratch) const
+{
+	Multiplication::multiply (product, a, _size, b, _size);
+	reduceProduct (result, product, scratch);
+}
+
+template <typename BaseType>
+void ModularContext<BaseType>::squareInForm (BaseType* result, const BaseType* a, BaseType* product, BaseType* scratch) const
+{
+	Multiplication::square (product, a, _size);
+	reduceProduct (result, product, scratch);
+}
+
+template <typename BaseType>
+void ModularContext<BaseType>::reduceProduct (BaseType* result, BaseType* product, BaseType* scratch) const
+{
+	if (_montgomery)
+	{
+		montgomeryReduce (result, product);
+	}
+	else
+	{
+		barrettReduce (result, product, scratch);
+	}
+}
+
+template <typename BaseType>
+void ModularContext<BaseType>::montgomeryReduce (BaseType* result, BaseType* product) const
+{
+	std::size_t n = _size;
+	const BaseType* modulus = _modulus._bigNumber.data ();
+	BaseType negativeInverse = _negativeInverse;
+	// every step clears the lowest limb by adding a multiple of modulus, the carry out of the row goes
+	// into product[i + n] and a carry beyond that is kept for the next row
+	BaseType topCarry = 0;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		BaseType factor = (BaseType) ((unsigned long long) product[i] * negativeInverse);
+		BaseType carry = Limbs::addMulLimb (product + i, modulus, n, factor);
+		BaseType sum = product[i + n] + carry;
+		BaseType nextCarry = (sum < carry);
+		sum += topCarry;
+		nextCarry += (sum < topCarry);
+		product[i + n] = sum;
+		topCarry = nextCarry;
+	}
+	// the sum is below 2 * modulus * B^n, so one subtraction is enough
+	if ((topCarry != 0) || (Limbs::compareN (product + n, modulus, n) >= 0))
+	{
+		Limbs::subN (result, product + n, modulus, n);
+	}
+	else
+	{
+		std::copy (product + n, product + 2 * n, result);
+	}
+}
+
+template <typename BaseType>
+void ModularContext<BaseType>::barrettReduce (BaseType* result, const BaseType* product, BaseType* scratch) const
+{
+	std::size_t n = _size;
+	const BaseType* modulus = _modulus._bigNumber.data ();
+	// the quotient estimate (product / B^(n-1)) * factor / B^(n+1) is at most 2 below the real one
+	BaseType* estimate = scratch;
+	BaseType* multiple = scratch + 2 * n + 2;
+	Multiplication::multiply (estimate, product + n - 1, n + 1, _barrettFactor.data (), n + 1);
+	const BaseType* quotient = estimate + n + 1;
+	Multiplication::multiply (multiple, quotient, n + 1, modulus, n);
+	// only the lowest n + 1 limbs matter, the remainder is below 3 * modulus
+	BaseType* remainder = estimate;
+	Limbs::subN (remainder, product, multiple, n + 1);
+	while (Limbs::compare (remainder, Limbs::normalizedSize (remainder, n + 1), modulus, n) >= 0)
+	{
+		Limbs::sub (remainder, remainder, n + 1, modulus, n);
+	}
+	std::copy (remainder, remainder + n, result);
+}
+
+template <typename BaseType>
+void ModularContext<BaseType>::toLimbs (BaseType* limbs, const Number& reduced) const
+{
+	std::size_t size = reduced.getRealSize ();
+	std::copy (reduced._bigNumber.begin (), reduced._bigNumber.begin () + size, limbs);
+	std::fill (limbs + size, limbs + _size, 0);
+}
+
+template <typename BaseType>
+unsigned int ModularContext<BaseType>::windowSize (unsigned int exponentBits)
+{
+	// the table costs 2^(w-1) multiplications, every window saves about exponentBits / (w + 1) of them
+	if (exponentBits > 671)
+	{
+		return 6;
+	}
+	if (exponentBits > 239)
+	{
+		return 5;
+	}
+	if (exponentBits > 79)
+	{
+		return 4;
+	}
+	if (exponentBits > 23)
+	{
+		return 3;
+	}
+	return (exponentBits > 1) ? 2 : 1;
+}
+
+}
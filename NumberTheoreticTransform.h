@@ -0,0 +1,409 @@
+/*
+ * NumberTheoreticTransform.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "LimbArithmetic.h"
+#include "ThreadPool.h"
+
+namespace Utilities
+{
+
+/**
+ * Arithmetic modulo a word sized NTT prime, all values are kept in Montgomery form (x * 2^64 mod p).
+ * The primes are below 2^62, so sums of two reduced values never overflow.
+ */
+class NttPrime
+{
+public:
+	NttPrime (std::uint64_t modulus, std::uint64_t generator) : _modulus(modulus), _generator(generator)
+	{
+		// Newton iteration for modulus^-1 mod 2^64, every step doubles the correct bits
+		std::uint64_t inverse = modulus;
+		for (int i = 0; i < 5; ++i)
+		{
+			inverse *= 2 - modulus * inverse;
+		}
+		_negativeInverse = 0 - inverse;
+		// 2^64 mod p, doubled another 64 times gives 2^128 mod p
+		_rSquared = (0 - modulus) % modulus;
+		for (int i = 0; i < 64; ++i)
+		{
+			_rSquared = add (_rSquared, _rSquared);
+		}
+	}
+
+	std::uint64_t getModulus () const
+	{
+		return _modulus;
+	}
+
+	std::uint64_t add (std::uint64_t a, std::uint64_t b) const
+	{
+		std::uint64_t sum = a + b;
+		return (sum >= _modulus) ? sum - _modulus : sum;
+	}
+
+	std::uint64_t sub (std::uint64_t a, std::uint64_t b) const
+	{
+		return (a >= b) ? a - b : a + _modulus - b;
+	}
+
+	/// a * b / 2^64 mod p, valid as long as a * b < p * 2^64
+	std::uint64_t multiply (std::uint64_t a, std::uint64_t b) const
+	{
+		std::uint64_t high;
+		std::uint64_t low = Wide::mulWide (a, b, high);
+		std::uint64_t reductionHigh;
+		Wide::mulWide (low * _negativeInverse, _modulus, reductionHigh);
+		// low + the low part of the reduction is 0 mod 2^64, it only carries if low is not zero
+		std::uint64_t result = high + reductionHigh + (low != 0);
+		return (result >= _modulus) ? result - _modulus : result;
+	}
+
+	/// converts any 64 bit value into Montgomery form
+	std::uint64_t toMontgomery (std::uint64_t value) const
+	{
+		return multiply (value, _rSquared);
+	}
+
+	std::uint64_t fromMontgomery (std::uint64_t value) const
+	{
+		return multiply (value, 1);
+	}
+
+	/// base in Montgomery form, the result as well
+	std::uint64_t power (std::uint64_t base, std::uint64_t exponent) const
+	{
+		std::uint64_t result = toMontgomery (1);
+		while (exponent > 0)
+		{
+			if (exponent & 1)
+			{
+				result = multiply (result, base);
+			}
+			base = multiply (base, base);
+			exponent >>= 1;
+		}
+		return result;
+	}
+
+	/// multiplicative inverse of a value in Montgomery form
+	std::uint64_t inverse (std::uint64_t value) const
+	{
+		return power (value, _modulus - 2);
+	}
+
+	/// primitive root of unity of the given order (a power of two), in Montgomery form
+	std::uint64_t rootOfUnity (std::size_t order) const
+	{
+		return power (toMontgomery (_generator), (_modulus - 1) / order);
+	}
+
+private:
+	typedef WideArithmetic<std::uint64_t> Wide;
+
+	std::uint64_t _modulus;
+	std::uint64_t _generator;
+	std::uint64_t _negativeInverse;
+	std::uint64_t _rSquared;
+};
+
+/**
+ * Multiplication of 64 bit word arrays by number theoretic transforms modulo three primes, the exact
+ * coefficients of the product are reconstructed by the chinese remainder theorem (Garner). The three
+ * primes allow coefficients up to 2^183, which covers products with up to 2^55 words.
+ */
+class NumberTheoreticTransform
+{
+public:
+	static const unsigned int maxTransformBits = 55;
+
+	/// work items (butterflies, coefficients) per task if a thread pool is used
+	static const std::size_t parallelGrain = 1 << 13;
+
+	/**
+	 * result = a * b with aSize + bSize words, the operands are not empty. If a and b are the same
+	 * array, only one forward transform per prime is done. With a pool, the three primes and the
+	 * butterflies of every transform step run in parallel.
+	 */
+	static void multiply (std::uint64_t* result, const std::uint64_t* a, std::size_t aSize, const std::uint64_t* b, std::size_t bSize,
+			ThreadPool* pool = nullptr)
+	{
+		std::size_t productSize = aSize + bSize - 1;
+		std::size_t transformSize = 1;
+		while (transformSize < productSize)
+		{
+			transformSize <<= 1;
+		}
+		bool squaring = (a == b) && (aSize == bSize);
+
+		NttPrime primes[3] = {NttPrime (4179340454199820289ULL, 3), NttPrime (2485986994308513793ULL, 5),
+				NttPrime (1945555039024054273ULL, 5)};
+		std::vector<std::uint64_t> residues[3];
+		std::vector<std::function<void ()> > tasks;
+		for (int p = 0; p < 3; ++p)
+		{
+			tasks.push_back ([&, p] { residues[p] = convolution (primes[p], transformSize, a, aSize, b, bSize, squaring, pool); });
+		}
+		runTasks (pool, tasks);
+		reconstruct (result, aSize + bSize, primes, residues, productSize, pool);
+	}
+
+	/**
+	 * the cyclic convolution of a and b modulo one prime, the coefficients are returned as plain values
+	 */
+	static std::vector<std::uint64_t> convolution (const NttPrime& prime, std::size_t transformSize,
+			const std::uint64_t* a, std::size_t aSize, const std::uint64_t* b, std::size_t bSize, bool squaring,
+			ThreadPool* pool = nullptr)
+	{
+		std::vector<std::uint64_t> roots;
+		std::vector<std::uint64_t> inverseRoots;
+		computeRoots (prime, transformSize, roots, inverseRoots);
+
+		std::vector<std::uint64_t> aTransform (transformSize, 0);
+		std::vector<std::uint64_t> bTransform (squaring ? 0 : transformSize, 0);
+		forRange (pool, aSize, [&] (std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				aTransform[i] = prime.toMontgomery (a[i]);
+			}
+		});
+		forwardTransform (prime, aTransform, roots, pool);
+		if (!squaring)
+		{
+			forRange (pool, bSize, [&] (std::size_t begin, std::size_t end)
+			{
+				for (std::size_t i = begin; i < end; ++i)
+				{
+					bTransform[i] = prime.toMontgomery (b[i]);
+				}
+			});
+			forwardTransform (prime, bTransform, roots, pool);
+		}
+		const std::vector<std::uint64_t>& factors = squaring ? aTransform : bTransform;
+		forRange (pool, transformSize, [&] (std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				aTransform[i] = prime.multiply (aTransform[i], factors[i]);
+			}
+		});
+		inverseTransform (prime, aTransform, inverseRoots, pool);
+
+		// multiplying the Montgomery form with the plain 1/n gives the plain coefficient
+		std::uint64_t scale = prime.fromMontgomery (prime.inverse (prime.toMontgomery (transformSize)));
+		forRange (pool, transformSize, [&] (std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				aTransform[i] = prime.multiply (aTransform[i], scale);
+			}
+		});
+		return aTransform;
+	}
+
+	/**
+	 * roots[j] = w^j and inverseRoots[j] = w^-j for j < n/2, where w is a primitive n-th root of unity
+	 */
+	static void computeRoots (const NttPrime& prime, std::size_t transformSize, std::vector<std::uint64_t>& roots,
+			std::vector<std::uint64_t>& inverseRoots)
+	{
+		std::size_t half = std::max (transformSize / 2, (std::size_t) 1);
+		roots.resize (half);
+		inverseRoots.resize (half);
+		std::uint64_t root = prime.rootOfUnity (transformSize);
+		std::uint64_t inverseRoot = prime.inverse (root);
+		roots[0] = inverseRoots[0] = prime.toMontgomery (1);
+		for (std::size_t j = 1; j < half; ++j)
+		{
+			roots[j] = prime.multiply (roots[j - 1], root);
+			inverseRoots[j] = prime.multiply (inverseRoots[j - 1], inverseRoot);
+		}
+	}
+
+	/**
+	 * decimation in frequency (Gentleman-Sande), the output is in bit reversed order
+	 */
+	static void forwardTransform (const NttPrime& prime, std::vector<std::uint64_t>& values, const std::vector<std::uint64_t>& roots,
+			ThreadPool* pool = nullptr)
+	{
+		std::size_t size = values.size ();
+		std::uint64_t* data = values.data ();
+		for (std::size_t length = size / 2, rootStep = 1; length >= 1; length >>= 1, rootStep <<= 1)
+		{
+			forRange (pool, size / 2, [&prime, data, &roots, length, rootStep] (std::size_t begin, std::size_t end)
+			{
+				forwardButterflies (prime, data, roots.data (), length, rootStep, begin, end);
+			});
+		}
+	}
+
+	/**
+	 * decimation in time (Cooley-Tukey), takes bit reversed input and produces the natural order
+	 */
+	static void inverseTransform (const NttPrime& prime, std::vector<std::uint64_t>& values, const std::vector<std::uint64_t>& inverseRoots,
+			ThreadPool* pool = nullptr)
+	{
+		std::size_t size = values.size ();
+		std::uint64_t* data = values.data ();
+		for (std::size_t length = 1, rootStep = size / 2; length < size; length <<= 1, rootStep >>= 1)
+		{
+			forRange (pool, size / 2, [&prime, data, &inverseRoots, length, rootStep] (std::size_t begin, std::size_t end)
+			{
+				inverseButterflies (prime, data, inverseRoots.data (), length, rootStep, begin, end);
+			});
+		}
+	}
+
+	/**
+	 * the butterflies [begin, end) of one forward step, butterfly k combines the pair j, j + length of
+	 * the block k / length with j = k % length
+	 */
+	static void forwardButterflies (const NttPrime& sharedPrime, std::uint64_t* values, const std::uint64_t* roots, std::size_t length,
+			std::size_t rootStep, std::size_t begin, std::size_t end)
+	{
+		// a local copy, so the constants are not reloaded after every store into values
+		const NttPrime prime = sharedPrime;
+		for (std::size_t k = begin; k < end;)
+		{
+			std::size_t j = k & (length - 1);
+			std::size_t blockEnd = std::min (end, k - j + length);
+			std::uint64_t* lower = values + 2 * (k - j);
+			std::uint64_t* upper = lower + length;
+			for (; k < blockEnd; ++j, ++k)
+			{
+				std::uint64_t u = lower[j];
+				std::uint64_t v = upper[j];
+				lower[j] = prime.add (u, v);
+				upper[j] = prime.multiply (prime.sub (u, v), roots[j * rootStep]);
+			}
+		}
+	}
+
+	/// the butterflies [begin, end) of one inverse step, numbered like in forwardButterflies
+	static void inverseButterflies (const NttPrime& sharedPrime, std::uint64_t* values, const std::uint64_t* inverseRoots, std::size_t length,
+			std::size_t rootStep, std::size_t begin, std::size_t end)
+	{
+		const NttPrime prime = sharedPrime;
+		for (std::size_t k = begin; k < end;)
+		{
+			std::size_t j = k & (length - 1);
+			std::size_t blockEnd = std::min (end, k - j + length);
+			std::uint64_t* lower = values + 2 * (k - j);
+			std::uint64_t* upper = lower + length;
+			for (; k < blockEnd; ++j, ++k)
+			{
+				std::uint64_t u = lower[j];
+				std::uint64_t v = prime.multiply (upper[j], inverseRoots[j * rootStep]);
+				lower[j] = prime.add (u, v);
+				upper[j] = prime.sub (u, v);
+			}
+		}
+	}
+
+	/**
+	 * combines the residues of every coefficient into its exact 192 bit value and adds the coefficients
+	 * with the carries into result. The coefficients are computed block by block, with a pool in parallel,
+	 * only the carries run serially.
+	 */
+	static void reconstruct (std::uint64_t* result, std::size_t resultSize, const NttPrime* primes,
+			const std::vector<std::uint64_t>* residues, std::size_t productSize, ThreadPool* pool = nullptr)
+	{
+		typedef WideArithmetic<std::uint64_t> Wide;
+		typedef LimbArithmetic<std::uint64_t> Words;
+		std::uint64_t p0 = primes[0].getModulus ();
+		std::uint64_t p1 = primes[1].getModulus ();
+		std::uint64_t p2 = primes[2].getModulus ();
+		// the constants are in Montgomery form, so multiplying them with a plain value gives a plain value
+		std::uint64_t p0InverseModP1 = primes[1].inverse (primes[1].toMontgomery (p0));
+		std::uint64_t p0InverseModP2 = primes[2].inverse (primes[2].toMontgomery (p0));
+		std::uint64_t p1InverseModP2 = primes[2].inverse (primes[2].toMontgomery (p1));
+		std::uint64_t p0TimesP1[2];
+		p0TimesP1[0] = Wide::mulWide (p0, p1, p0TimesP1[1]);
+
+		const std::size_t blockSize = 16 * parallelGrain;
+		std::vector<std::uint64_t> coefficients (3 * std::min (productSize, blockSize));
+		std::uint64_t carry[3] = {0, 0, 0};
+		for (std::size_t blockStart = 0; blockStart < resultSize; blockStart += blockSize)
+		{
+			std::size_t blockEnd = std::min (blockStart + blockSize, resultSize);
+			std::size_t coefficientEnd = std::min (blockEnd, productSize);
+			if (blockStart < coefficientEnd)
+			{
+				forRange (pool, coefficientEnd - blockStart, [&] (std::size_t begin, std::size_t end)
+				{
+					for (std::size_t i = begin; i < end; ++i)
+					{
+						std::size_t index = blockStart + i;
+						std::uint64_t v0 = residues[0][index];
+						std::uint64_t v1 = primes[1].multiply (primes[1].sub (residues[1][index], v0 % p1), p0InverseModP1);
+						std::uint64_t v2 = primes[2].multiply (primes[2].sub (residues[2][index], v0 % p2), p0InverseModP2);
+						v2 = primes[2].multiply (primes[2].sub (v2, v1 % p2), p1InverseModP2);
+
+						// coefficient = v0 + v1 * p0 + v2 * p0 * p1
+						std::uint64_t* coefficient = &coefficients[3 * i];
+						coefficient[0] = Wide::mulWide (v1, p0, coefficient[1]);
+						coefficient[2] = Words::addLimb (coefficient, coefficient, 2, v0);
+						std::uint64_t term[3];
+						term[0] = Wide::mulWide (v2, p0TimesP1[0], term[1]);
+						term[2] = Words::addMulLimb (term + 1, p0TimesP1 + 1, 1, v2);
+						Words::addN (coefficient, coefficient, term, 3);
+					}
+				});
+			}
+			for (std::size_t i = blockStart; i < blockEnd; ++i)
+			{
+				if (i < productSize)
+				{
+					Words::addN (carry, carry, &coefficients[3 * (i - blockStart)], 3);
+				}
+				result[i] = carry[0];
+				carry[0] = carry[1];
+				carry[1] = carry[2];
+				carry[2] = 0;
+			}
+		}
+	}
+
+private:
+	/// function (begin, end) over [0, count), split over the pool if there is one and count is large enough
+	template <typename Function>
+	static void forRange (ThreadPool* pool, std::size_t count, Function function)
+	{
+		if ((pool == nullptr) || (count < 2 * parallelGrain))
+		{
+			function ((std::size_t) 0, count);
+		}
+		else
+		{
+			pool->parallelFor (count, parallelGrain, function);
+		}
+	}
+
+	static void runTasks (ThreadPool* pool, std::vector<std::function<void ()> >& tasks)
+	{
+		if (pool != nullptr)
+		{
+			pool->invoke (tasks);
+		}
+		else
+		{
+			for (std::size_t i = 0; i < tasks.size (); ++i)
+			{
+				tasks[i] ();
+			}
+		}
+	}
+};
+
+}
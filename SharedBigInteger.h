@@ -0,0 +1,302 @@
+/*
+ * SharedBigInteger.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include "BigInteger.h"
+#include "LimbArena.h"
+
+namespace Utilities
+{
+
+/**
+ * A BigIntegerBase with copy on write: copies share one immutable number and an atomic reference count,
+ * so copying costs O(1) whatever the size. The first mutation of a shared value clones it. Any number of
+ * threads may read and copy their own SharedBigIntegers of the same value concurrently, one object is not
+ * to be written from several threads without synchronization, just like a std::shared_ptr.
+ *
+ * The shared numbers always live on the global heap, independent of the LimbArena of the thread. A default
+ * constructed or moved from SharedBigInteger holds no number and reads as zero, so both cost no allocation.
+ */
+template <typename BaseType = std::uint64_t>
+class SharedBigInteger
+{
+public:
+	typedef BigIntegerBase<BaseType> Number;
+
+	SharedBigInteger () noexcept : _shared(nullptr)
+	{
+	}
+
+	SharedBigInteger (long number) : SharedBigInteger (Number (number))
+	{
+	}
+
+	SharedBigInteger (const std::string& number) : SharedBigInteger (Number (number))
+	{
+	}
+
+	SharedBigInteger (const Number& number)
+	{
+		ScopedLimbArena heap (nullptr);
+		_shared = new Shared (number);
+	}
+
+	/// limbs of a number made while a LimbArena is current are copied to the heap instead of moved
+	SharedBigInteger (Number&& number)
+	{
+		ScopedLimbArena heap (nullptr);
+		_shared = new Shared (std::move (number));
+	}
+
+	SharedBigInteger (const SharedBigInteger& copy) : _shared(copy._shared)
+	{
+		acquire ();
+	}
+
+	/// the source is zero afterwards
+	SharedBigInteger (SharedBigInteger&& source) noexcept : _shared(source._shared)
+	{
+		source._shared = nullptr;
+	}
+
+	~SharedBigInteger ()
+	{
+		release ();
+	}
+
+	SharedBigInteger& operator= (const SharedBigInteger& rhs)
+	{
+		SharedBigInteger copy (rhs);
+		swap (*this, copy);
+		return *this;
+	}
+
+	SharedBigInteger& operator= (SharedBigInteger&& rhs) noexcept
+	{
+		swap (*this, rhs);
+		return *this;
+	}
+
+	friend void swap (SharedBigInteger& a, SharedBigInteger& b) noexcept
+	{
+		std::swap (a._shared, b._shared);
+	}
+
+	/// the shared number, valid until this object is mutated or destroyed
+	const Number& get () const
+	{
+		return (_shared != nullptr) ? _shared->value : zero ();
+	}
+
+	operator const Number& () const
+	{
+		return get ();
+	}
+
+	/**
+	 * the number for writing, cloned first if other SharedBigIntegers share it. Limbs it grows while a
+	 * LimbArena is current come from that arena, so do not share it beyond the arena then.
+	 */
+	Number& mutate ();
+
+	/// true if no other SharedBigInteger shares the number, false for the zero without a number
+	bool isUnique () const
+	{
+		return (_shared != nullptr) && (_shared->references.load (std::memory_order_acquire) == 1);
+	}
+
+	/// 0 for the zero without a number
+	std::size_t useCount () const
+	{
+		return (_shared != nullptr) ? _shared->references.load (std::memory_order_relaxed) : 0;
+	}
+
+	std::string asString (int base = 10) const
+	{
+		return get ().asString (base);
+	}
+
+	SharedBigInteger& operator+= (const Number& rhs)
+	{
+		return update ([&rhs] (const Number& value) { return value + rhs; });
+	}
+
+	SharedBigInteger& operator-= (const Number& rhs)
+	{
+		return update ([&rhs] (const Number& value) { return value - rhs; });
+	}
+
+	SharedBigInteger& operator*= (const Number& rhs)
+	{
+		return update ([&rhs] (const Number& value) { return value * rhs; });
+	}
+
+	SharedBigInteger& operator/= (const Number& rhs)
+	{
+		return update ([&rhs] (const Number& value) { return value / rhs; });
+	}
+
+	SharedBigInteger& operator%= (const Number& rhs)
+	{
+		return update ([&rhs] (const Number& value) { return value % rhs; });
+	}
+
+	SharedBigInteger& operator<<= (unsigned int howMuch)
+	{
+		return update ([howMuch] (const Number& value) { return value << howMuch; });
+	}
+
+	SharedBigInteger& operator>>= (unsigned int howMuch)
+	{
+		return update ([howMuch] (const Number& value) { return value >> howMuch; });
+	}
+
+	Number operator+ (const Number& rhs) const
+	{
+		return get () + rhs;
+	}
+
+	Number operator- (const Number& rhs) const
+	{
+		return get () - rhs;
+	}
+
+	Number operator* (const Number& rhs) const
+	{
+		return get () * rhs;
+	}
+
+	Number operator/ (const Number& rhs) const
+	{
+		return get () / rhs;
+	}
+
+	Number operator% (const Number& rhs) const
+	{
+		return get () % rhs;
+	}
+
+	Number operator<< (unsigned int howMuch) const
+	{
+		return get () << howMuch;
+	}
+
+	Number operator>> (unsigned int howMuch) const
+	{
+		return get () >> howMuch;
+	}
+
+	bool operator== (const Number& rhs) const
+	{
+		return get () == rhs;
+	}
+
+	bool operator< (const Number& rhs) const
+	{
+		return get () < rhs;
+	}
+
+	bool operator<= (const Number& rhs) const
+	{
+		return get () <= rhs;
+	}
+
+	bool operator> (const Number& rhs) const
+	{
+		return get () > rhs;
+	}
+
+	bool operator>= (const Number& rhs) const
+	{
+		return get () >= rhs;
+	}
+
+private:
+	struct Shared
+	{
+		explicit Shared (const Number& number) : value(number)
+		{
+		}
+
+		explicit Shared (Number&& number) : value(std::move (number))
+		{
+		}
+
+		std::atomic<std::size_t> references{1};
+		Number value;
+	};
+
+	/// the zero of the SharedBigIntegers without a number, its limbs come from the heap as well
+	static const Number& zero ()
+	{
+		static const Number value = [] { ScopedLimbArena heap (nullptr); return Number (); } ();
+		return value;
+	}
+
+	void acquire ()
+	{
+		if (_shared != nullptr)
+		{
+			_shared->references.fetch_add (1, std::memory_order_relaxed);
+		}
+	}
+
+	/// the last owner deletes the number, after all writes of the other owners are visible
+	void release ()
+	{
+		if ((_shared != nullptr) && (_shared->references.fetch_sub (1, std::memory_order_acq_rel) == 1))
+		{
+			ScopedLimbArena heap (nullptr);
+			delete _shared;
+		}
+	}
+
+	/**
+	 * the compound assignments compute a new number anyway, so a shared one is replaced rather than cloned.
+	 * The result comes from the global heap, like every shared number.
+	 */
+	template <typename Operation>
+	SharedBigInteger& update (const Operation& operation)
+	{
+		ScopedLimbArena heap (nullptr);
+		if (isUnique ())
+		{
+			_shared->value = operation (get ());
+			return *this;
+		}
+		SharedBigInteger replacement (operation (get ()));
+		swap (*this, replacement);
+		return *this;
+	}
+
+	Shared* _shared;
+};
+
+template <typename BaseType>
+BigIntegerBase<BaseType>& SharedBigInteger<BaseType>::mutate ()
+{
+	if (!isUnique ())
+	{
+		SharedBigInteger clone (get ());
+		swap (*this, clone);
+	}
+	return _shared->value;
+}
+
+template <typename BaseType>
+std::ostream& operator<< (std::ostream& os, const SharedBigInteger<BaseType>& num)
+{
+	return os << num.get ();
+}
+
+}
@@ -0,0 +1,209 @@
+/*
+ * ThreadPool.h
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "LimbArena.h"
+
+namespace Utilities
+{
+
+/**
+ * A fixed set of worker threads for fork join parallelism. invoke runs a group of tasks and waits for
+ * them, the waiting thread runs queued tasks in the meantime, so tasks can fork again without
+ * blocking the pool. Tasks run with the global heap as their LimbArena, since the waiting thread may run
+ * tasks of other callers and an arena must only be used by one thread.
+ */
+class ThreadPool
+{
+public:
+	/// threadCount includes the thread calling invoke, so threadCount - 1 workers are started
+	explicit ThreadPool (unsigned int threadCount = std::thread::hardware_concurrency ()) : _stopping(false)
+	{
+		for (unsigned int i = 1; i < threadCount; ++i)
+		{
+			_workers.push_back (std::thread (&ThreadPool::work, this));
+		}
+	}
+
+	ThreadPool (const ThreadPool&) = delete;
+	ThreadPool& operator= (const ThreadPool&) = delete;
+
+	~ThreadPool ()
+	{
+		{
+			std::lock_guard<std::mutex> lock (_mutex);
+			_stopping = true;
+		}
+		_condition.notify_all ();
+		for (size_t i = 0; i < _workers.size (); ++i)
+		{
+			_workers[i].join ();
+		}
+	}
+
+	unsigned int getThreadCount () const
+	{
+		return (unsigned int) _workers.size () + 1;
+	}
+
+	/**
+	 * runs all tasks, possibly in parallel, and returns when all of them are finished. The first exception
+	 * thrown by a task is rethrown after that.
+	 */
+	void invoke (std::vector<std::function<void ()> >& tasks)
+	{
+		if (tasks.empty ())
+		{
+			return;
+		}
+		Group group;
+		group.pending = tasks.size ();
+		if (tasks.size () > 1)
+		{
+			{
+				std::lock_guard<std::mutex> lock (_mutex);
+				for (size_t i = 1; i < tasks.size (); ++i)
+				{
+					_queue.push_back (Task (&tasks[i], &group));
+				}
+			}
+			_condition.notify_all ();
+		}
+		execute (Task (&tasks[0], &group));
+		// helps with queued tasks and sleeps while the remaining ones of the group run on other threads
+		while (group.pending.load () > 0)
+		{
+			if (!runQueued ())
+			{
+				std::unique_lock<std::mutex> lock (_mutex);
+				_condition.wait (lock, [this, &group] { return (group.pending.load () == 0) || !_queue.empty (); });
+			}
+		}
+		if (group.error)
+		{
+			std::rethrow_exception (group.error);
+		}
+	}
+
+	/**
+	 * calls function (begin, end) for consecutive ranges covering [0, count), every range but the last
+	 * has at least grain elements
+	 */
+	template <typename Function>
+	void parallelFor (std::size_t count, std::size_t grain, Function function)
+	{
+		std::size_t chunks = std::min ((std::size_t) getThreadCount () * 4, (count + grain - 1) / std::max (grain, (std::size_t) 1));
+		if (chunks <= 1)
+		{
+			function ((std::size_t) 0, count);
+			return;
+		}
+		std::vector<std::function<void ()> > tasks;
+		std::size_t chunkSize = (count + chunks - 1) / chunks;
+		for (std::size_t begin = 0; begin < count; begin += chunkSize)
+		{
+			std::size_t end = std::min (begin + chunkSize, count);
+			tasks.push_back ([&function, begin, end] { function (begin, end); });
+		}
+		invoke (tasks);
+	}
+
+private:
+	/// the tasks of one invoke call
+	struct Group
+	{
+		std::atomic<std::size_t> pending;
+		std::exception_ptr error;
+		std::mutex errorMutex;
+	};
+
+	struct Task
+	{
+		Task (std::function<void ()>* function, Group* group) : function(function), group(group)
+		{
+		}
+
+		std::function<void ()>* function;
+		Group* group;
+	};
+
+	void execute (const Task& task)
+	{
+		ScopedLimbArena heap (nullptr);
+		try
+		{
+			(*task.function) ();
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock (task.group->errorMutex);
+			if (!task.group->error)
+			{
+				task.group->error = std::current_exception ();
+			}
+		}
+		// the last access to the group, the waiting thread may destroy it right after
+		if (task.group->pending.fetch_sub (1) == 1)
+		{
+			// the lock makes sure the waiting thread is either asleep or has not checked pending yet
+			std::lock_guard<std::mutex> lock (_mutex);
+			_condition.notify_all ();
+		}
+	}
+
+	/// runs one queued task, returns false if there was none
+	bool runQueued ()
+	{
+		std::unique_lock<std::mutex> lock (_mutex);
+		if (_queue.empty ())
+		{
+			return false;
+		}
+		Task task = _queue.back ();
+		_queue.pop_back ();
+		lock.unlock ();
+		execute (task);
+		return true;
+	}
+
+	void work ()
+	{
+		while (true)
+		{
+			std::unique_lock<std::mutex> lock (_mutex);
+			_condition.wait (lock, [this] { return _stopping || !_queue.empty (); });
+			if (_queue.empty ())
+			{
+				return;
+			}
+			// workers take the oldest tasks, which are usually the largest ones
+			Task task = _queue.front ();
+			_queue.pop_front ();
+			lock.unlock ();
+			execute (task);
+		}
+	}
+
+	std::mutex _mutex;
+	std::condition_variable _condition;
+	std::deque<Task> _queue;
+	std::vector<std::thread> _workers;
+	bool _stopping;
+};
+
+}
@@ -0,0 +1,295 @@
+/*
+ * bench.cpp
+ *
+ *  Created on: 17.10.2026
+ *      Author: domenicjenz
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include "BigInteger.h"
+
+/**
+ * Micro benchmarks of BigIntegerBase for all limb types over operand sizes of 1 to maxLimbs limbs
+ * (powers of two). Every line gives the time and the heap allocations per operation, as CSV or JSON.
+ *
+ * usage: benchExec [--json] [--max-limbs n] [--min-time ms] [--base 8|16|32|64] [--operation name]
+ */
+
+using namespace Utilities;
+
+namespace
+{
+
+std::atomic<std::size_t> allocationCount(0);
+std::atomic<std::size_t> allocatedBytes(0);
+
+void* countedAllocation (std::size_t size)
+{
+	allocationCount.fetch_add (1, std::memory_order_relaxed);
+	allocatedBytes.fetch_add (size, std::memory_order_relaxed);
+	void* memory = std::malloc (size > 0 ? size : 1);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+}
+
+void* operator new (std::size_t size)
+{
+	return countedAllocation (size);
+}
+
+void* operator new[] (std::size_t size)
+{
+	return countedAllocation (size);
+}
+
+void operator delete (void* memory) noexcept
+{
+	std::free (memory);
+}
+
+void operator delete[] (void* memory) noexcept
+{
+	std::free (memory);
+}
+
+void operator delete (void* memory, std::size_t) noexcept
+{
+	std::free (memory);
+}
+
+void operator delete[] (void* memory, std::size_t) noexcept
+{
+	std::free (memory);
+}
+
+namespace
+{
+
+struct Options
+{
+	bool json = false;
+	std::size_t maxLimbs = 1 << 20;
+	double minTime = 50.0;
+	unsigned int baseBits = 0;
+	std::string operation;
+};
+
+struct Result
+{
+	unsigned int baseBits;
+	const char* operation;
+	std::size_t limbs;
+	std::size_t iterations;
+	double nsPerOp;
+	double allocsPerOp;
+	double bytesPerOp;
+};
+
+/// results are folded into this, so the compiler cannot drop the measured operations
+volatile std::size_t sink = 0;
+
+std::mt19937_64 generator(20261017);
+
+/// a random number of exactly limbs limbs, zero for no limbs
+template <typename BaseType>
+BigIntegerBase<BaseType> randomNumber (std::size_t limbs)
+{
+	BigIntegerBase<BaseType> result;
+	if (limbs == 0)
+	{
+		return result;
+	}
+	std::vector<BaseType> data(limbs);
+	for (BaseType& limb : data)
+	{
+		limb = (BaseType) generator ();
+	}
+	data.back () |= (BaseType) 1 << (sizeof(BaseType) * 8 - 1);
+	result.importLimbs (data.data (), limbs, sizeof(BaseType));
+	return result;
+}
+
+/**
+ * repeats operation until minTime milliseconds have passed, at least once. The clock is read after
+ * doubling batches only, so it does not show up in the time of small operations.
+ */
+template <typename Operation>
+Result measure (const Options& options, unsigned int baseBits, const char* name, std::size_t limbs, const Operation& operation)
+{
+	typedef std::chrono::steady_clock Clock;
+	std::size_t iterations = 0;
+	std::size_t allocationsBefore = allocationCount.load ();
+	std::size_t bytesBefore = allocatedBytes.load ();
+	Clock::time_point start = Clock::now ();
+	double elapsed = 0.0;
+	for (std::size_t batch = 1; elapsed < options.minTime; batch *= 2)
+	{
+		for (std::size_t i = 0; i < batch; ++i)
+		{
+			operation ();
+		}
+		iterations += batch;
+		elapsed = std::chrono::duration<double, std::milli>(Clock::now () - start).count ();
+	}
+	Result result;
+	result.baseBits = baseBits;
+	result.operation = name;
+	result.limbs = limbs;
+	result.iterations = iterations;
+	result.nsPerOp = elapsed * 1e6 / iterations;
+	result.allocsPerOp = (double) (allocationCount.load () - allocationsBefore) / iterations;
+	result.bytesPerOp = (double) (allocatedBytes.load () - bytesBefore) / iterations;
+	return result;
+}
+
+void print (const Options& options, const Result& result, bool first)
+{
+	if (options.json)
+	{
+		std::cout << (first ? "" : ",\n") << "    {\"base_bits\": " << result.baseBits << ", \"operation\": \"" << result.operation
+				<< "\", \"limbs\": " << result.limbs << ", \"iterations\": " << result.iterations << ", \"ns_per_op\": "
+				<< result.nsPerOp << ", \"allocs_per_op\": " << result.allocsPerOp << ", \"bytes_per_op\": " << result.bytesPerOp << "}";
+	}
+	else
+	{
+		std::cout << result.baseBits << "," << result.operation << "," << result.limbs << "," << result.iterations << ","
+				<< result.nsPerOp << "," << result.allocsPerOp << "," << result.bytesPerOp << "\n";
+	}
+	std::cout.flush ();
+}
+
+template <typename BaseType>
+void printTuning (bool first)
+{
+	typedef BigIntegerTuning<BaseType> Tuning;
+	std::cout << (first ? "" : ",\n") << "    \"" << sizeof(BaseType) * 8 << "\": {\"karatsuba\": " << Tuning::karatsubaThreshold
+			<< ", \"toom3\": " << Tuning::toom3Threshold << ", \"karatsuba_square\": " << Tuning::karatsubaSquareThreshold
+			<< ", \"toom3_square\": " << Tuning::toom3SquareThreshold << ", \"ntt\": " << Tuning::nttThreshold
+			<< ", \"newton_division\": " << Tuning::newtonDivisionThreshold << ", \"decimal_conversion\": "
+			<< Tuning::decimalConversionThreshold << "}";
+}
+
+template <typename BaseType>
+void benchmark (const Options& options, bool& first)
+{
+	typedef BigIntegerBase<BaseType> Number;
+	const unsigned int baseBits = sizeof(BaseType) * 8;
+	if ((options.baseBits != 0) && (options.baseBits != baseBits))
+	{
+		return;
+	}
+	auto run = [&] (const char* name, std::size_t limbs, const auto& operation)
+	{
+		if (!options.operation.empty () && (options.operation != name))
+		{
+			return;
+		}
+		print (options, measure (options, baseBits, name, limbs, operation), first);
+		first = false;
+	};
+	for (std::size_t limbs = 1; limbs <= options.maxLimbs; limbs *= 2)
+	{
+		Number a = randomNumber<BaseType> (limbs);
+		Number b = randomNumber<BaseType> (limbs);
+		Number dividend = randomNumber<BaseType> (2 * limbs);
+		const unsigned int shift = limbs * baseBits / 2 + 3;
+
+		run ("add", limbs, [&] { sink += (a + b).bitLength (); });
+		run ("sub", limbs, [&] { sink += (a - b).bitLength (); });
+		run ("mul", limbs, [&] { sink += (a * b).bitLength (); });
+		run ("div", limbs, [&] { sink += (dividend / b).bitLength (); });
+		run ("shl", limbs, [&] { sink += (a << shift).bitLength (); });
+		run ("shr", limbs, [&] { sink += (a >> shift).bitLength (); });
+		if (options.operation.empty () || (options.operation == "asString") || (options.operation == "setFromString"))
+		{
+			std::string decimal = a.asString ();
+			run ("asString", limbs, [&] { sink += a.asString ().size (); });
+			run ("setFromString", limbs, [&] { Number parsed; parsed.setFromString (decimal); sink += parsed.bitLength (); });
+		}
+	}
+}
+
+bool parseOptions (int argc, char** argv, Options& options)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string argument = argv[i];
+		bool hasValue = (i + 1 < argc);
+		if (argument == "--json")
+		{
+			options.json = true;
+		}
+		else if ((argument == "--max-limbs") && hasValue)
+		{
+			options.maxLimbs = std::strtoull (argv[++i], nullptr, 10);
+		}
+		else if ((argument == "--min-time") && hasValue)
+		{
+			options.minTime = std::strtod (argv[++i], nullptr);
+		}
+		else if ((argument == "--base") && hasValue)
+		{
+			options.baseBits = std::strtoul (argv[++i], nullptr, 10);
+		}
+		else if ((argument == "--operation") && hasValue)
+		{
+			options.operation = argv[++i];
+		}
+		else
+		{
+			std::cerr << "usage: " << argv[0]
+					<< " [--json] [--max-limbs n] [--min-time ms] [--base 8|16|32|64] [--operation add|sub|mul|div|shl|shr|asString|setFromString]"
+					<< std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+}
+
+int main (int argc, char** argv)
+{
+	Options options;
+	if (!parseOptions (argc, argv, options))
+	{
+		return 1;
+	}
+	bool first = true;
+	if (options.json)
+	{
+		std::cout << "{\n  \"tuning\": {\n";
+		printTuning<std::uint8_t> (true);
+		printTuning<std::uint16_t> (false);
+		printTuning<std::uint32_t> (false);
+		printTuning<std::uint64_t> (false);
+		std::cout << "\n  },\n  \"results\": [\n";
+	}
+	else
+	{
+		std::cout << "base_bits,operation,limbs,iterations,ns_per_op,allocs_per_op,bytes_per_op\n";
+	}
+	benchmark<std::uint8_t> (options, first);
+	benchmark<std::uint16_t> (options, first);
+	benchmark<std::uint32_t> (options, first);
+	benchmark<std::uint64_t> (options, first);
+	if (options.json)
+	{
+		std::cout << "\n  ]\n}" << std::endl;
+	}
+	return 0;
+}
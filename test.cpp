@@ -1,6 +1,29 @@
 #include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
 #include "BigInteger.h"
+#include "BigIntegerArray.h"
+#include "BigIntegerBatch.h"
+#include "BigIntegerCombinatorics.h"
+#include "BigIntegerGcd.h"
+#include "BigIntegerPrimes.h"
+#include "BigIntegerRandom.h"
+#include "BigIntegerRNS.h"
+#include "BigIntegerRoots.h"
+#include "HybridInteger.h"
+#include "ModularContext.h"
+#include "SharedBigInteger.h"
+#include "ThreadPool.h"
 #include "Optional.h"
 #include "RangeStream.h"
 #include "InfiniteStream.h"
@@ -8,6 +31,56 @@
 
 using namespace Utilities;
 
+namespace
+{
+
+int failures = 0;
+
+void check (bool condition, const char* what)
+{
+	if (!condition)
+	{
+		std::cout << "FAILED: " << what << std::endl;
+		++failures;
+	}
+}
+
+/// true if the call throws an exception of type Exception
+template <typename Exception, typename Function>
+bool throws (Function function)
+{
+	try
+	{
+		function ();
+	}
+	catch (const Exception&)
+	{
+		return true;
+	}
+	return false;
+}
+
+std::mt19937_64 generator(20261017);
+
+/// a random number of exactly limbs 64 bit limbs
+BigInteger randomNumber (std::size_t limbs, bool isNegative = false)
+{
+	std::vector<std::uint64_t> words(limbs);
+	for (std::uint64_t& word : words)
+	{
+		word = generator ();
+	}
+	if (limbs > 0)
+	{
+		words.back () |= 1ULL << 63;
+	}
+	BigInteger result;
+	result.importLimbs (words.data (), words.size (), sizeof(std::uint64_t), WordOrder::LeastSignificantFirst, ByteOrder::Native, isNegative);
+	return result;
+}
+
+}
+
 template<typename KeyType, typename ValueType>
 std::ostream& operator<< (std::ostream& os, const std::pair<KeyType, ValueType>& victim)
 {
@@ -70,7 +143,1512 @@ void testFiboHeap ()
 	//std::cout << myHeap << std::endl;
 }
 
+void nttTest ()
+{
+	typedef BigIntegerTuning<std::uint64_t> Tuning;
+	// one product just above the real threshold against Toom-3
+	std::size_t limbs = Tuning::nttThreshold + 1;
+	BigInteger a = randomNumber (limbs);
+	BigInteger b = randomNumber (limbs);
+	BigInteger product = a * b;
+	BigInteger square = a * a;
+	std::size_t nttThreshold = Tuning::nttThreshold;
+	Tuning::nttThreshold = 1 << 30;
+	check (product == a * b, "ntt product above nttThreshold");
+	check (square == a * a, "ntt square above nttThreshold");
+	// more shapes with a lowered threshold
+	for (std::size_t aLimbs : {300, 301, 777, 1024})
+	{
+		for (std::size_t bLimbs : {300, 513, 1024})
+		{
+			BigInteger x = randomNumber (aLimbs, aLimbs % 2 == 1);
+			BigInteger y = randomNumber (bLimbs);
+			Tuning::nttThreshold = 1 << 30;
+			BigInteger expected = x * y;
+			BigInteger expectedSquare = x * x;
+			Tuning::nttThreshold = 256;
+			check (x * y == expected, "ntt product with lowered threshold");
+			check (x * x == expectedSquare, "ntt square with lowered threshold");
+		}
+	}
+	Tuning::nttThreshold = nttThreshold;
+}
+
+BigInteger magnitude (const BigInteger& number)
+{
+	return number.isPositive () ? number : BigInteger () - number;
+}
+
+/// a = q b + r with |r| < |b|, the quotient truncated and the remainder with the sign of a
+void checkDivmod (const BigInteger& a, const BigInteger& b, const char* what)
+{
+	std::pair<BigInteger, BigInteger> result = a.divmod (b);
+	const BigInteger& q = result.first;
+	const BigInteger& r = result.second;
+	check (q * b + r == a, what);
+	check (magnitude (r) < magnitude (b), what);
+	check ((r == BigInteger ()) || (r.isPositive () == a.isPositive ()), what);
+	check ((a / b == q) && (a % b == r), what);
+}
+
+void divisionTest ()
+{
+	typedef BigIntegerTuning<std::uint64_t> Tuning;
+	check (BigInteger (7) / BigInteger (-2) == BigInteger (-3), "7 / -2");
+	check (BigInteger (-7) % BigInteger (2) == BigInteger (-1), "-7 % 2");
+	check (BigInteger (-7) / BigInteger (-2) == BigInteger (3), "-7 / -2");
+	check (BigInteger (3) / BigInteger (5) == BigInteger (), "3 / 5");
+	for (std::size_t aLimbs : {1, 2, 5, 40, 130})
+	{
+		for (std::size_t bLimbs : {1, 2, 3, 17, 64})
+		{
+			for (int signs = 0; signs < 4; ++signs)
+			{
+				BigInteger a = randomNumber (aLimbs, signs & 1);
+				BigInteger b = randomNumber (bLimbs, signs & 2);
+				checkDivmod (a, b, (bLimbs == 1) ? "divmod by a single limb" : "divmod by Knuth D");
+				checkDivmod (a * b, b, "exact divmod");
+			}
+		}
+	}
+	// Newton division with a lowered threshold, against Knuth D
+	std::size_t newtonThreshold = Tuning::newtonDivisionThreshold;
+	for (std::size_t bLimbs : {20, 33, 70})
+	{
+		for (int signs = 0; signs < 4; ++signs)
+		{
+			BigInteger a = randomNumber (3 * bLimbs + 5, signs & 1);
+			BigInteger b = randomNumber (bLimbs, signs & 2);
+			Tuning::newtonDivisionThreshold = 1 << 30;
+			std::pair<BigInteger, BigInteger> expected = a.divmod (b);
+			Tuning::newtonDivisionThreshold = 16;
+			checkDivmod (a, b, "divmod by Newton");
+			std::pair<BigInteger, BigInteger> result = a.divmod (b);
+			check ((result.first == expected.first) && (result.second == expected.second), "Newton against Knuth D");
+		}
+	}
+	Tuning::newtonDivisionThreshold = newtonThreshold;
+	bool thrown = false;
+	try
+	{
+		randomNumber (3) / BigInteger ();
+	}
+	catch (const std::domain_error&)
+	{
+		thrown = true;
+	}
+	check (thrown, "division by zero throws std::domain_error");
+}
+
+/// x mod m in [0, m) by the remainder of the division
+BigInteger referenceMod (const BigInteger& x, const BigInteger& m)
+{
+	BigInteger r = x % m;
+	return r.isPositive () ? r : r + m;
+}
+
+BigInteger referencePowmod (const BigInteger& base, const BigInteger& exponent, const BigInteger& m)
+{
+	BigInteger result = referenceMod (BigInteger (1), m);
+	BigInteger power = referenceMod (base, m);
+	for (unsigned int bit = 0; bit < exponent.bitLength (); ++bit)
+	{
+		if (exponent.isBitSet (bit))
+		{
+			result = result * power % m;
+		}
+		power = power * power % m;
+	}
+	return result;
+}
+
+void modularTest ()
+{
+	for (std::size_t limbs : {1, 3, 20})
+	{
+		for (bool odd : {true, false})
+		{
+			BigInteger m = randomNumber (limbs);
+			m.setBit (0, odd);
+			ModularContext<> context (m);
+			check (context.usesMontgomery () == odd, "Montgomery for odd moduli, Barrett for even ones");
+			for (int i = 0; i < 4; ++i)
+			{
+				BigInteger a = randomNumber (2 * limbs + 1, i & 1);
+				BigInteger b = randomNumber (limbs, i & 2);
+				BigInteger exponent = randomNumber (2);
+				check (context.mulmod (a, b) == referenceMod (a * b, m), odd ? "Montgomery mulmod" : "Barrett mulmod");
+				check (context.powmod (a, exponent) == referencePowmod (a, exponent, m), odd ? "Montgomery powmod" : "Barrett powmod");
+			}
+			check (context.powmod (randomNumber (limbs), BigInteger ()) == referenceMod (BigInteger (1), m), "powmod with exponent 0");
+		}
+	}
+}
+
+/// numbers created before a ScopedLimbArena keep their limbs on the heap and survive the release of the arena
+void arenaTest ()
+{
+	LimbArena arena;
+	BigInteger x = randomNumber (40);
+	BigInteger total;
+	BigInteger product;
+	BigInteger swapped;
+	{
+		ScopedLimbArena scope (arena);
+		total += x;
+		product = x * x;
+		BigInteger local = x + x;
+		check (arena.getBytesUsed () > 0, "numbers created inside the scope use the arena");
+		swap (swapped, local);
+	}
+	arena.release ();
+	check (total == x, "+= inside the scope");
+	check (product == x * x, "assignment of an arena result");
+	check (swapped == x + x, "swap with an arena number");
+	total += x;
+	check (total == x + x, "growing after the release of the arena");
+}
+
+/// pool tasks never allocate from the arena of the thread running them
+void threadPoolTest ()
+{
+	BigInteger x = randomNumber (60);
+	for (unsigned int threads : {1, 4})
+	{
+		ThreadPool pool (threads);
+		std::vector<BigInteger> results (8);
+		std::vector<char> onHeap (results.size (), false);
+		std::vector<std::function<void ()> > tasks;
+		for (std::size_t i = 0; i < results.size (); ++i)
+		{
+			tasks.push_back ([&x, &results, &onHeap, i]
+			{
+				onHeap[i] = (LimbArena::current () == nullptr);
+				results[i] = x * BigInteger ((long) i + 1);
+			});
+		}
+		LimbArena arena;
+		{
+			ScopedLimbArena scope (arena);
+			pool.invoke (tasks);
+			check (LimbArena::current () == &arena, "invoke keeps the arena of the caller");
+		}
+		arena.release ();
+		for (std::size_t i = 0; i < results.size (); ++i)
+		{
+			check (onHeap[i], "pool tasks allocate from the heap");
+			check (results[i] == x * BigInteger ((long) i + 1), "results of pool tasks");
+		}
+	}
+	// the thread waiting in invoke sleeps instead of spinning. It waits for about 200 ms, spinning would
+	// take about as much processor time, the bound leaves plenty of room for a loaded machine
+	ThreadPool pool (4);
+	std::atomic<int> finished (0);
+	std::vector<std::function<void ()> > sleepers (4, [&finished]
+	{
+		std::this_thread::sleep_for (std::chrono::milliseconds (250));
+		++finished;
+	});
+	// meanwhile the workers take the other tasks
+	sleepers[0] = [&finished]
+	{
+		std::this_thread::sleep_for (std::chrono::milliseconds (50));
+		++finished;
+	};
+	std::clock_t start = std::clock ();
+	pool.invoke (sleepers);
+	check (finished == 4, "invoke returns after all tasks");
+	check ((std::clock () - start) < CLOCKS_PER_SEC / 10, "invoke waits without spinning");
+}
+
+void limbsTest ()
+{
+	const WordOrder wordOrders[] = {WordOrder::LeastSignificantFirst, WordOrder::MostSignificantFirst};
+	const ByteOrder byteOrders[] = {ByteOrder::Native, ByteOrder::Little, ByteOrder::Big};
+	std::vector<BigInteger> numbers = {BigInteger (), BigInteger (1), BigInteger (-255), randomNumber (1), randomNumber (7, true)};
+	for (std::size_t wordSize : {1, 2, 3, 4, 8, 16})
+	{
+		for (WordOrder wordOrder : wordOrders)
+		{
+			for (ByteOrder byteOrder : byteOrders)
+			{
+				for (const BigInteger& number : numbers)
+				{
+					std::vector<unsigned char> words (number.exportWordCount (wordSize) * wordSize + 1, 0xAA);
+					std::size_t count = number.exportLimbs (words.data (), wordSize, wordOrder, byteOrder);
+					check (count == number.exportWordCount (wordSize), "exportLimbs returns the word count");
+					check (words.back () == 0xAA, "exportLimbs writes no more than the word count");
+					BigInteger imported;
+					imported.importLimbs (words.data (), count, wordSize, wordOrder, byteOrder, !number.isPositive ());
+					check (imported == number, "importLimbs after exportLimbs");
+					BigIntegerBase<std::uint32_t> narrow;
+					narrow.importLimbs (words.data (), count, wordSize, wordOrder, byteOrder, !number.isPositive ());
+					check (narrow.asString (16) == number.asString (16), "importLimbs into 32 bit limbs");
+				}
+			}
+		}
+	}
+	unsigned char bytes[4];
+	BigInteger (0x01020304).exportLimbs (bytes, 2, WordOrder::MostSignificantFirst, ByteOrder::Big);
+	check ((bytes[0] == 1) && (bytes[1] == 2) && (bytes[2] == 3) && (bytes[3] == 4), "most significant word first, big endian");
+	BigInteger (0x01020304).exportLimbs (bytes, 2, WordOrder::MostSignificantFirst, ByteOrder::Little);
+	check ((bytes[0] == 2) && (bytes[1] == 1) && (bytes[2] == 4) && (bytes[3] == 3), "most significant word first, little endian");
+}
+
+void arrayTest ()
+{
+	std::vector<BigInteger> numbers = {randomNumber (3), BigInteger (), BigInteger (-42), randomNumber (20, true)};
+	std::ostringstream out;
+	writeBigIntegerArray (out, numbers);
+	std::string file = out.str ();
+	std::vector<std::uint64_t> memory ((file.size () + 7) / 8);
+	std::memcpy (memory.data (), file.data (), file.size ());
+	BigIntegerArrayView view (memory.data (), file.size ());
+	check (view.size () == numbers.size (), "size of the array view");
+	for (std::size_t i = 0; i < numbers.size (); ++i)
+	{
+		check (view[i].toBigInteger<std::uint64_t> () == numbers[i], "numbers of the array view");
+	}
+	check (throws<std::out_of_range> ([&view] { view[4]; }), "index beyond the array view");
+	// the last entry points one word past the end of the data
+	unsigned char* lastEntry = reinterpret_cast<unsigned char*> (memory.data ()) + 8 * (BigIntegerArrayFormat::headerWords + 2 * 3);
+	lastEntry[0] += 1;
+	check (throws<std::out_of_range> ([&view] { view[3]; }), "entry outside of the data");
+	check (view[2].toBigInteger<std::uint64_t> () == BigInteger (-42), "the other entries stay readable");
+	check (throws<std::runtime_error> ([&memory] { BigIntegerArrayView (memory.data (), 15); }), "truncated header");
+	check (throws<std::runtime_error> ([&memory] { BigIntegerArrayView (memory.data (), 16 + 8 * 7); }), "truncated index");
+}
+
+BigInteger euclid (BigInteger a, BigInteger b)
+{
+	a = magnitude (a);
+	b = magnitude (b);
+	while (!(b == BigInteger ()))
+	{
+		BigInteger r = a % b;
+		a = b;
+		b = r;
+	}
+	return a;
+}
+
+void checkGcd (const BigInteger& a, const BigInteger& b, const char* what)
+{
+	BigInteger expected = euclid (a, b);
+	check (gcd (a, b) == expected, what);
+	BigInteger x;
+	BigInteger y;
+	check (extendedGcd (a, b, x, y) == expected, what);
+	check (a * x + b * y == expected, "Bezout identity of the extendedGcd cofactors");
+	check ((magnitude (x) <= magnitude (b)) || (x == BigInteger (1)) || (x == BigInteger (-1)), "extendedGcd cofactor bound");
+}
+
+void gcdTest ()
+{
+	checkGcd (BigInteger (), BigInteger (), "gcd of zeros");
+	checkGcd (BigInteger (), BigInteger (-12), "gcd with zero");
+	checkGcd (BigInteger (-12), BigInteger (), "gcd with zero");
+	checkGcd (BigInteger (-84), BigInteger (36), "gcd of small numbers");
+	const std::size_t lehmerSizes[] = {1, 2, 5, 40};
+	for (std::size_t limbs : lehmerSizes)
+	{
+		BigInteger common = randomNumber ((limbs + 1) / 2);
+		checkGcd (randomNumber (limbs), randomNumber (limbs, true), "gcd of random numbers, Lehmer");
+		checkGcd (common * randomNumber (limbs), common * randomNumber (limbs + 1, true), "gcd with a common factor, Lehmer");
+	}
+	std::size_t threshold = BigIntegerTuning<std::uint64_t>::halfGcdThreshold;
+	std::size_t basecaseThreshold = BigIntegerTuning<std::uint64_t>::halfGcdBasecaseThreshold;
+	BigIntegerTuning<std::uint64_t>::halfGcdThreshold = 8;
+	BigIntegerTuning<std::uint64_t>::halfGcdBasecaseThreshold = 4;
+	for (std::size_t limbs : {9, 30, 90})
+	{
+		BigInteger common = randomNumber (limbs / 3);
+		checkGcd (randomNumber (limbs, true), randomNumber (limbs), "gcd of random numbers, half gcd");
+		checkGcd (common * randomNumber (limbs), common * randomNumber (limbs), "gcd with a common factor, half gcd");
+	}
+	// consecutive Fibonacci numbers need the most Euclid steps
+	BigInteger f0 (1);
+	BigInteger f1 (1);
+	for (int i = 0; i < 3000; ++i)
+	{
+		f0 += f1;
+		swap (f0, f1);
+	}
+	checkGcd (f1, f0, "gcd of Fibonacci numbers, half gcd");
+	BigIntegerTuning<std::uint64_t>::halfGcdThreshold = threshold;
+	BigIntegerTuning<std::uint64_t>::halfGcdBasecaseThreshold = basecaseThreshold;
+	checkGcd (f1, f0, "gcd of Fibonacci numbers, Lehmer");
+
+	BigInteger modulus = randomNumber (5);
+	modulus.setBit (0, true);
+	for (int i = 0; i < 4; ++i)
+	{
+		BigInteger a = randomNumber (6, i & 1);
+		if (euclid (a, modulus) == BigInteger (1))
+		{
+			BigInteger inverse = modInverse (a, modulus);
+			check (!(inverse < BigInteger ()) && (inverse < modulus), "modInverse lies in [0, modulus)");
+			check (referenceMod (a * inverse, modulus) == BigInteger (1), "modInverse times the number is 1");
+		}
+	}
+	check (modInverse (BigInteger (3), BigInteger (7)) == BigInteger (5), "inverse of 3 modulo 7");
+	check (modInverse (BigInteger (-3), BigInteger (7)) == BigInteger (2), "inverse of -3 modulo 7");
+	check (throws<std::domain_error> ([] { modInverse (BigInteger (6), BigInteger (9)); }), "modInverse of a non invertible number");
+	check (throws<std::domain_error> ([] { modInverse (BigInteger (), BigInteger (9)); }), "modInverse of zero");
+	check (throws<std::domain_error> ([] { modInverse (BigInteger (2), BigInteger ()); }), "modInverse with zero modulus");
+	check (throws<std::domain_error> ([] { modInverse (BigInteger (2), BigInteger (-9)); }), "modInverse with negative modulus");
+}
+
+void rootsTest ()
+{
+	const BigInteger zero;
+	const BigInteger one (1);
+	check ((isqrt (zero) == zero) && (isqrt (one) == one) && (isqrt (BigInteger (3)) == one) && (isqrt (BigInteger (4)) == BigInteger (2)),
+			"isqrt of small numbers");
+	check ((iroot (zero, 5) == zero) && (iroot (one, 5) == one) && (iroot (BigInteger (-1), 5) == BigInteger (-1)), "iroot of zero and one");
+	for (std::size_t limbs : {1, 2, 30, 200})
+	{
+		BigInteger r = randomNumber (limbs);
+		BigInteger square = r * r;
+		BigInteger remainder;
+		check ((sqrtRem (square, remainder) == r) && (remainder == zero), "sqrtRem of a square");
+		check ((sqrtRem (square - one, remainder) == r - one) && (remainder == r + r - one - one), "sqrtRem below a square");
+		check (isqrt (square + r + r) == r, "isqrt below the next square");
+		BigInteger x = randomNumber (limbs);
+		BigInteger root = isqrt (x);
+		check ((root * root <= x) && (x < (root + one) * (root + one)), "isqrt of a random number");
+		for (unsigned int n : {3, 5, 7})
+		{
+			BigInteger power = r.pow (n);
+			check ((rootRem (power, n, remainder) == r) && (remainder == zero), "rootRem of a power");
+			check (iroot (power - one, n) == r - one, "iroot below a power");
+			check (iroot (power + one, n) == r, "iroot above a power");
+			check (iroot (zero - power, n) == zero - r, "iroot of a negative power");
+			check (iroot (one - power, n) == one - r, "iroot of a negative number rounds towards zero");
+			root = iroot (x, n);
+			check ((root.pow (n) <= x) && (x < (root + one).pow (n)), "iroot of a random number");
+		}
+		check (iroot (x, 1) == x, "first root");
+	}
+	check (throws<std::domain_error> ([] { isqrt (BigInteger (-4)); }), "isqrt of a negative number");
+	check (throws<std::domain_error> ([] { iroot (BigInteger (-8), 2); }), "even root of a negative number");
+	check (throws<std::domain_error> ([] { iroot (BigInteger (8), 0); }), "0-th root");
+
+	BigInteger root;
+	unsigned int exponent = 0;
+	check (isPerfectPower (zero) && isPerfectPower (one) && isPerfectPower (BigInteger (-1)), "zero and one are perfect powers");
+	check (!isPerfectPower (BigInteger (2)) && !isPerfectPower (BigInteger (-16)), "2 and -16 are no perfect powers");
+	check (isPerfectPower (BigInteger (-64), root, exponent) && (root == BigInteger (-4)) && (exponent == 3), "-64 is (-4)^3");
+	check (isPerfectPower (BigInteger (1024), root, exponent) && (root == BigInteger (2)) && (exponent == 10), "1024 is 2^10");
+	for (std::size_t limbs : {1, 3, 20})
+	{
+		// an odd random number, which is no perfect power for this seed
+		BigInteger base = randomNumber (limbs);
+		base.setBit (0, true);
+		check (!isPerfectPower (base), "a random number is no perfect power");
+		check (isPerfectSquare (base * base) && !isPerfectSquare (base * base + one), "isPerfectSquare of squares and near squares");
+		check (isPerfectPower (base.pow (6), root, exponent) && (root == base) && (exponent == 6), "sixth power");
+		check (isPerfectPower (base.pow (3) << 3, root, exponent) && (root == base + base) && (exponent == 3), "cube of an even number");
+		check (!isPerfectPower (base.pow (3) - one) && !isPerfectPower (base.pow (3) + one), "near cubes are no perfect powers");
+		check (isPerfectPower (zero - base.pow (5), root, exponent) && (root == zero - base) && (exponent == 5), "negative fifth power");
+	}
+}
+
+void literalTest ()
+{
+	check (2_bigInt - 3_bigInt == BigInteger (-1), "literals subtract exactly");
+	check (-5_bigInt == BigInteger (-5), "negated literal");
+	check (-(-5_bigInt) == BigInteger (5), "double negation");
+	check (-0_bigInt == BigInteger () && (-0_bigInt).isPositive (), "negated zero stays positive");
+	check (18446744073709551615_bigInt + 1_bigInt == BigInteger ("18446744073709551616"), "literal sum beyond 64 bits");
+	check (99999999999999999999_bigInt * 99999999999999999999_bigInt == BigInteger ("9999999999999999999800000000000000000001"),
+			"literal product beyond the digits of the operands");
+	check (1_bigInt - 18446744073709551616_bigInt == BigInteger ("-18446744073709551615"), "negative literal difference");
+	check (0xFFFF'FFFF'FFFF'FFFF'FFFF_bigInt == BigInteger ("1208925819614629174706175"), "hexadecimal literal with separators");
+	check ((0b1010_bigInt == BigInteger (10)) && (017_bigInt == BigInteger (15)) && (0_bigInt == BigInteger ()), "binary, octal and zero literals");
+	BigInteger big = 340282366920938463463374607431768211456_bigInt;
+	check (big == BigInteger (1) << 128, "literal of 2^128");
+	// the FixedBigInteger literal keeps the width of its digits and wraps around
+	check (BigInteger (0xFFFF'FFFF'FFFF'FFFF_fixed + 1_fixed) == BigInteger (), "_fixed wraps around at 64 bits");
+	check (BigInteger (99999999999999999999_fixed) == 99999999999999999999_bigInt, "_fixed converts to BigInteger");
+}
+
+BigInteger fromWord (std::uint64_t word)
+{
+	BigInteger result;
+	result.setFromNumber (word);
+	return result;
+}
+
+/// every kernel level of the CPU against the BigInteger operations modulo 2^(64 limbCount)
+void batchTest ()
+{
+	const std::size_t size = 13;
+	const std::size_t limbCount = 3;
+	const BigInteger wrap = BigInteger (1) << (64 * limbCount);
+	const BigInteger one (1);
+	std::vector<BigInteger> a;
+	std::vector<BigInteger> b;
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		a.push_back (randomNumber (1 + i % limbCount));
+		b.push_back (randomNumber (1 + (i + 1) % limbCount));
+	}
+	// carries through all limbs, equal numbers and zeros
+	a[0] = wrap - one;
+	b[0] = one;
+	a[1] = b[1] = randomNumber (limbCount);
+	a[2] = BigInteger ();
+	b[3] = BigInteger ();
+	BigIntegerBatch x (size, limbCount);
+	BigIntegerBatch y (size, limbCount);
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		x.set (i, a[i]);
+		y.set (i, b[i]);
+	}
+	const std::uint64_t factor = generator ();
+	const BigInteger modulus = randomNumber (2) + one;
+	LimbVectorArithmetic::Level level = LimbVectorArithmetic::level ();
+	for (int current = level; current >= LimbVectorArithmetic::Scalar; --current)
+	{
+		LimbVectorArithmetic::level () = (LimbVectorArithmetic::Level) current;
+		BigIntegerBatch result (size, limbCount);
+		std::vector<std::uint64_t> flags (size);
+		std::vector<int> comparisons (size);
+		BigIntegerBatch::add (result, x, y, flags.data ());
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			BigInteger sum = a[i] + b[i];
+			check (result.get<std::uint64_t> (i) == sum % wrap, "batch add");
+			check (flags[i] == (sum < wrap ? 0 : 1), "batch add carry");
+		}
+		BigIntegerBatch::sub (result, x, y, flags.data ());
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			check (result.get<std::uint64_t> (i) == referenceMod (a[i] - b[i], wrap), "batch sub");
+			check (flags[i] == (a[i] < b[i] ? 1 : 0), "batch sub borrow");
+		}
+		BigIntegerBatch::mulLimb (result, x, factor, flags.data ());
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			BigInteger product = a[i] * fromWord (factor);
+			check (result.get<std::uint64_t> (i) == product % wrap, "batch mulLimb");
+			check (fromWord (flags[i]) == product >> (64 * limbCount), "batch mulLimb high limb");
+		}
+		BigIntegerBatch::compare (x, y, comparisons.data ());
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			check (comparisons[i] == (a[i] < b[i] ? -1 : (a[i] == b[i] ? 0 : 1)), "batch compare");
+		}
+		BigIntegerBatch::reduce (result, x, modulus);
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			check (result.get<std::uint64_t> (i) == a[i] % modulus, "batch reduce");
+		}
+	}
+	LimbVectorArithmetic::level () = level;
+	check (throws<std::domain_error> ([&x] { x.set (0, BigInteger (-1)); }), "negative numbers do not go into a batch");
+	check (throws<std::domain_error> ([&x, &wrap] { x.set (0, wrap); }), "too large numbers do not go into a batch");
+	check (throws<std::out_of_range> ([&x] { x.set (size, BigInteger ()); }), "index beyond the batch");
+}
+
+BigInteger naiveFactorial (unsigned int n)
+{
+	BigInteger result (1);
+	for (unsigned int i = 2; i <= n; ++i)
+	{
+		result *= BigInteger ((long) i);
+	}
+	return result;
+}
+
+void combinatoricsTest ()
+{
+	for (unsigned int n : {0, 1, 2, 3, 10, 20, 21, 100, 333, 1000})
+	{
+		BigInteger expected = naiveFactorial (n);
+		check (factorial (n) == expected, "factorial against a naive product");
+		check (primeSwingFactorial (n) == expected, "primeSwingFactorial against a naive product");
+	}
+	for (unsigned long long n : {0, 1, 5, 30, 200})
+	{
+		for (unsigned long long k : {0ULL, 1ULL, n / 3, n / 2, n - 1, n, n + 1, n + 5})
+		{
+			if (k > n)
+			{
+				check (binomial (n, k) == BigInteger (), "binomial with k > n");
+				continue;
+			}
+			BigInteger expected = naiveFactorial (n) / (naiveFactorial (k) * naiveFactorial (n - k));
+			check (binomial (n, k) == expected, "binomial against factorials");
+		}
+	}
+	check (binomial (0, 0) == BigInteger (1), "0 over 0");
+	const unsigned long long large = 1ULL << 40;
+	const BigInteger n ((long) large);
+	check (binomial (large, 3) == n * (n - BigInteger (1)) * (n - BigInteger (2)) / BigInteger (6), "binomial of a large n");
+	for (unsigned int n : {0, 1, 2, 3, 10, 100, 1000})
+	{
+		BigInteger expected (1);
+		for (unsigned int p = 2; p <= n; ++p)
+		{
+			bool isPrime = true;
+			for (unsigned int d = 2; d * d <= p; ++d)
+			{
+				isPrime = isPrime && (p % d != 0);
+			}
+			if (isPrime)
+			{
+				expected *= BigInteger ((long) p);
+			}
+		}
+		check (primorial (n) == expected, "primorial against trial division");
+	}
+	check (productOfRange (5, 9) == BigInteger (5 * 6 * 7 * 8 * 9), "productOfRange");
+	check (productOfRange (9, 5) == BigInteger (1), "empty productOfRange");
+	std::vector<long> values = {3, -4, 5, -6, 7};
+	check (productOfSequence (values.begin (), values.end ()) == BigInteger (2520), "productOfSequence of negative values");
+	std::vector<BigInteger> numbers = {randomNumber (3), randomNumber (1, true), randomNumber (40)};
+	check (productOfSequence (numbers.begin (), numbers.end ()) == numbers[0] * numbers[1] * numbers[2], "productOfSequence of big integers");
+	check (productOfSequence (numbers.begin (), numbers.begin ()) == BigInteger (1), "empty productOfSequence");
+}
+
+void primesTest ()
+{
+	const BigInteger one (1);
+	check (!isProbablePrime (3825123056546413051_bigInt), "strong pseudoprime to the bases up to 23");
+	check (!isProbablePrime (BigInteger (561)) && !isProbablePrime (BigInteger (1)) && !isProbablePrime (BigInteger ()), "561, 1 and 0");
+	check (isProbablePrime (BigInteger (2)) && isProbablePrime (BigInteger (97)), "small primes");
+	for (unsigned int p : {2, 3, 5, 7, 13, 17, 19, 31, 61, 89, 107, 127, 521, 607})
+	{
+		BigInteger mersenne = (one << p) - one;
+		check (isProbablePrime (mersenne) && isProbablePrime (mersenne, 5, generator), "Mersenne primes");
+	}
+	for (unsigned int p : {11, 23, 29, 67, 257})
+	{
+		check (!isProbablePrime ((one << p) - one), "composite Mersenne numbers");
+	}
+	check (nextPrime (BigInteger ()) == BigInteger (2), "nextPrime of 0");
+	check (nextPrime (BigInteger (-7)) == BigInteger (2), "nextPrime of a negative number");
+	check (nextPrime (BigInteger (2)) == BigInteger (3), "nextPrime of 2");
+	check (nextPrime (BigInteger (13)) == BigInteger (17), "nextPrime of 13");
+	check (nextPrime ((one << 89) - BigInteger (3)) == (one << 89) - one, "nextPrime below a Mersenne prime");
+	BigInteger start = randomNumber (1);
+	BigInteger prime = nextPrime (start);
+	check ((start < prime) && isProbablePrime (prime), "nextPrime of a random number");
+	for (BigInteger x = start + one; x < prime; x += one)
+	{
+		check (!isProbablePrime (x), "no prime is skipped by nextPrime");
+	}
+	for (unsigned int bits : {2, 3, 10, 64, 65, 200})
+	{
+		prime = randomPrime (bits, generator);
+		check ((prime.bitLength () == bits) && isProbablePrime (prime), "randomPrime has the requested bit length");
+	}
+	BigInteger p = randomPrime (100, generator);
+	BigInteger q = randomPrime (100, generator);
+	check (!isProbablePrime (p * q, 5, generator), "product of two primes");
+	check (throws<std::domain_error> ([] { randomPrime (1, generator); }), "randomPrime of 1 bit");
+
+	const BigInteger bound = randomNumber (2);
+	const BigInteger low (-5);
+	const BigInteger high (5);
+	for (int i = 0; i < 20; ++i)
+	{
+		check (randomBits (70, generator).bitLength () <= 70, "randomBits below 2^bits");
+		BigInteger below = randomBelow (bound, generator);
+		check (below.isPositive () && (below < bound), "randomBelow in [0, bound)");
+		BigInteger inRange = randomRange (low, high, generator);
+		check ((low <= inRange) && (inRange <= high), "randomRange in [low, high]");
+	}
+	check (randomBelow (one, generator) == BigInteger (), "randomBelow 1");
+	check (throws<std::domain_error> ([] { randomBelow (BigInteger (), generator); }), "randomBelow 0");
+	check (throws<std::domain_error> ([&low, &high] { randomRange (high, low, generator); }), "randomRange with high < low");
+}
+
+void sharedTest ()
+{
+	const BigInteger x = randomNumber (10);
+	const BigInteger y = randomNumber (3);
+	SharedBigInteger<> a (x);
+	SharedBigInteger<> b (a);
+	SharedBigInteger<> c = b;
+	check ((a.useCount () == 3) && (&a.get () == &c.get ()), "copies share the number");
+	b.mutate () += y;
+	check ((b == x + y) && (a == x) && (c == x), "mutate clones a shared number");
+	check ((a.useCount () == 2) && b.isUnique (), "mutate leaves the other copies sharing");
+	const BigInteger* address = &b.get ();
+	b.mutate () *= y;
+	check ((&b.get () == address) && (b == (x + y) * y), "mutate of a unique number works in place");
+	c += y;
+	check ((c == x + y) && (a == x) && a.isUnique () && c.isUnique (), "+= replaces a shared number");
+	a -= x;
+	check (a == BigInteger (), "-= of a unique number");
+	SharedBigInteger<> d (std::move (c));
+	check ((d == x + y) && (c == BigInteger ()), "moving leaves a zero");
+	check ((c.useCount () == 0) && (d.useCount () == 1), "moving allocates no zero");
+	c = std::move (d);
+	check ((c == x + y) && (d == BigInteger ()) && (d.useCount () == 0), "move assignment leaves a zero");
+	static_assert(std::is_nothrow_move_constructible<SharedBigInteger<>>::value
+			&& std::is_nothrow_move_assignable<SharedBigInteger<>>::value, "moves of SharedBigInteger do not throw");
+	SharedBigInteger<> empty;
+	SharedBigInteger<> emptyCopy (empty);
+	check ((empty == BigInteger ()) && (empty.useCount () == 0) && (emptyCopy.useCount () == 0), "the default is a zero without a number");
+	emptyCopy += y;
+	check ((emptyCopy == y) && emptyCopy.isUnique () && (empty == BigInteger ()), "+= of a zero without a number");
+	empty.mutate () -= y;
+	check ((empty == -y) && empty.isUnique (), "mutate of a zero without a number");
+	LimbArena arena;
+	{
+		ScopedLimbArena scope (arena);
+		a = SharedBigInteger<> (x * y);
+		c = a;
+		c <<= 100;
+	}
+	arena.release ();
+	check ((a == x * y) && (c == (x * y) << 100), "shared numbers live on the heap");
+}
+
+/// x in the range [-M / 2, M / 2) of BigIntegerRNS::toBigInteger
+BigInteger symmetricMod (const BigInteger& x, const BigInteger& m)
+{
+	BigInteger r = referenceMod (x, m);
+	return (m - r < r) ? r - m : r;
+}
+
+void rnsTest ()
+{
+	RnsBasis basis (200);
+	BigInteger modulus;
+	modulus.importLimbs (basis.modulus ().data (), basis.modulus ().size (), sizeof(std::uint64_t));
+	check (modulus.bitLength () > basis.bits () + 2, "the basis covers the bits and their negatives");
+	const BigInteger one (1);
+	const BigInteger largest = (one << basis.bits ()) - one;
+	for (const BigInteger& x : {BigInteger (), BigInteger (-1), largest, -largest, randomNumber (3, true), randomNumber (2)})
+	{
+		check (BigIntegerRNS (basis, x).toBigInteger () == x, "round trip through the residues");
+	}
+	BigInteger a = randomNumber (1, true);
+	BigInteger b = randomNumber (1);
+	BigIntegerRNS x (basis, a);
+	BigIntegerRNS y (basis, b);
+	check ((x * y).toBigInteger () == a * b, "negative product");
+	check ((x - y).toBigInteger () == a - b, "negative difference");
+	check ((-x + y).toBigInteger () == b - a, "negation");
+	// the largest number of the range and the first one beyond it, which wraps to the smallest
+	BigInteger half = modulus / BigInteger (2);
+	BigInteger shifted = one << 100;
+	BigIntegerRNS top = BigIntegerRNS (basis, half / shifted) * BigIntegerRNS (basis, shifted) + BigIntegerRNS (basis, half % shifted);
+	check (top.toBigInteger () == half, "largest number of the range");
+	check ((top + BigIntegerRNS (basis, one)).toBigInteger () == -half, "wrap at the upper bound");
+	check ((-top - BigIntegerRNS (basis, one)).toBigInteger () == half, "wrap at the lower bound");
+	BigIntegerRNS power (basis, largest);
+	check ((power * power).toBigInteger () == symmetricMod (largest * largest, modulus), "products beyond the range wrap around");
+	check (throws<std::out_of_range> ([&basis, &largest] { BigIntegerRNS (basis, largest + BigInteger (1)); }), "numbers beyond the basis");
+	RnsBasis other (200);
+	check (throws<std::invalid_argument> ([&x, &other] { x + BigIntegerRNS (other); }), "operands of different bases");
+
+	RnsBasis wide (4000);
+	ThreadPool pool (4);
+	BigInteger big = randomNumber (60, true);
+	check (BigIntegerRNS (wide, big, &pool).toBigInteger () == big, "round trip with a pool");
+	check (BigIntegerRNS (wide, big, &pool) == BigIntegerRNS (wide, big), "residues with and without a pool");
+}
+
+void hybridTest ()
+{
+	typedef HybridInteger<> Hybrid;
+	const Hybrid min (INT64_MIN);
+	const Hybrid max (INT64_MAX);
+	const Hybrid one (1);
+	const BigInteger twoTo63 = BigInteger (1) << 63;
+	Hybrid quotient = min / Hybrid (-1);
+	check (!quotient.isSmall () && (quotient.toBigInteger () == twoTo63), "INT64_MIN / -1 becomes large");
+	Hybrid remainder = min % Hybrid (-1);
+	check (remainder.isSmall () && (remainder.smallValue () == 0), "INT64_MIN % -1 stays small");
+	Hybrid negated = -min;
+	check (!negated.isSmall () && (negated.toBigInteger () == twoTo63), "-INT64_MIN becomes large");
+	check ((negated - one).isSmall () && (negated - one == max), "shrinks back below INT64_MAX");
+	Hybrid sum = max + one;
+	check (!sum.isSmall () && (sum.toBigInteger () == twoTo63), "INT64_MAX + 1 becomes large");
+	sum -= one;
+	check (sum.isSmall () && (sum.smallValue () == INT64_MAX), "INT64_MAX + 1 - 1 shrinks back");
+	Hybrid difference = min - one;
+	check (!difference.isSmall () && (difference.toBigInteger () == BigInteger () - twoTo63 - BigInteger (1)), "INT64_MIN - 1 becomes large");
+	difference += one;
+	check (difference.isSmall () && (difference.smallValue () == INT64_MIN), "INT64_MIN - 1 + 1 shrinks back to INT64_MIN");
+	Hybrid product = max * max;
+	check (!product.isSmall () && (product.toBigInteger () == BigInteger (INT64_MAX) * BigInteger (INT64_MAX)), "overflowing product");
+	product /= max;
+	check (product.isSmall () && (product == max), "quotient of a large number shrinks back");
+	product = max * max;
+	product %= Hybrid (1000);
+	check (product.isSmall () && (product.toBigInteger () == BigInteger (INT64_MAX) * BigInteger (INT64_MAX) % BigInteger (1000)),
+			"remainder of a large number shrinks back");
+	check (Hybrid (BigInteger () - twoTo63).isSmall () && (Hybrid (BigInteger () - twoTo63) == min), "INT64_MIN from a BigInteger is small");
+	check (!Hybrid (twoTo63).isSmall () && (Hybrid (twoTo63) == quotient), "2^63 from a BigInteger is large");
+	check ((min < max) && (max < sum + one) && (min - one < min) && !(quotient < max), "order across the representations");
+	check (throws<std::domain_error> ([&max] { max / Hybrid (); }) && throws<std::domain_error> ([&quotient] { quotient % Hybrid (); }),
+			"division by zero");
+	// random values near the limits against BigInteger
+	for (int i = 0; i < 50; ++i)
+	{
+		std::int64_t a = (std::int64_t) generator () >> (generator () % 64);
+		std::int64_t b = (std::int64_t) generator () >> (generator () % 64);
+		const BigInteger x (a);
+		const BigInteger y (b);
+		check ((Hybrid (a) + Hybrid (b)).toBigInteger () == x + y, "hybrid sum");
+		check ((Hybrid (a) - Hybrid (b)).toBigInteger () == x - y, "hybrid difference");
+		check ((Hybrid (a) * Hybrid (b)).toBigInteger () == x * y, "hybrid product");
+		if (b != 0)
+		{
+			check ((Hybrid (a) / Hybrid (b)).toBigInteger () == x / y, "hybrid quotient");
+			check ((Hybrid (a) % Hybrid (b)).toBigInteger () == x % y, "hybrid remainder");
+		}
+	}
+}
+
+/// the same value with other limbs, through 64 bit words
+template <typename To, typename From>
+BigIntegerBase<To> withLimbs (const BigIntegerBase<From>& number)
+{
+	std::vector<std::uint64_t> words (number.exportWordCount (sizeof(std::uint64_t)));
+	number.exportLimbs (words.data (), sizeof(std::uint64_t));
+	BigIntegerBase<To> result;
+	result.importLimbs (words.data (), words.size (), sizeof(std::uint64_t), WordOrder::LeastSignificantFirst, ByteOrder::Native,
+			!number.isPositive ());
+	return result;
+}
+
+/// the arithmetic of narrower limbs against the 64 bit limbs, from the schoolbook sizes up to Toom-3
+template <typename BaseType>
+void limbTypeTest (const char* name)
+{
+	typedef BigIntegerBase<BaseType> Number;
+	std::string what = std::string ("arithmetic with ") + name + " limbs";
+	for (std::size_t aWords : {1, 3, 5, 20, 41, 100})
+	{
+		for (std::size_t bWords : {(std::size_t) 1, (std::size_t) 2, aWords / 2 + 1, aWords})
+		{
+			for (int signs = 0; signs < 4; ++signs)
+			{
+				BigInteger a = randomNumber (aWords, signs & 1);
+				BigInteger b = randomNumber (bWords, signs & 2);
+				Number x = withLimbs<BaseType> (a);
+				Number y = withLimbs<BaseType> (b);
+				check (withLimbs<std::uint64_t> (x) == a, what.c_str ());
+				check (withLimbs<std::uint64_t> (x + y) == a + b, what.c_str ());
+				check (withLimbs<std::uint64_t> (x - y) == a - b, what.c_str ());
+				check (withLimbs<std::uint64_t> (x * y) == a * b, what.c_str ());
+				check (withLimbs<std::uint64_t> (x.square ()) == a * a, what.c_str ());
+				check (withLimbs<std::uint64_t> (x / y) == a / b, what.c_str ());
+				check (withLimbs<std::uint64_t> (x % y) == a % b, what.c_str ());
+				check (withLimbs<std::uint64_t> (x << 37) == a << 37, what.c_str ());
+				check (withLimbs<std::uint64_t> (x >> 37) == a >> 37, what.c_str ());
+				check (((x < y) == (a < b)) && ((x == y) == (a == b)), what.c_str ());
+				check (x.asString () == a.asString () && (Number (a.asString ()) == x), what.c_str ());
+			}
+		}
+	}
+	BigInteger base = randomNumber (2, true);
+	check (withLimbs<std::uint64_t> (withLimbs<BaseType> (base).pow (5)) == base.pow (5), what.c_str ());
+}
+
+/// the product by the schoolbook method on 32 bit words, independent of the multiplication of the library
+BigInteger schoolbookProduct (const BigInteger& a, const BigInteger& b)
+{
+	std::vector<std::uint32_t> x (a.exportWordCount (sizeof(std::uint32_t)));
+	std::vector<std::uint32_t> y (b.exportWordCount (sizeof(std::uint32_t)));
+	a.exportLimbs (x.data (), sizeof(std::uint32_t));
+	b.exportLimbs (y.data (), sizeof(std::uint32_t));
+	std::vector<std::uint32_t> product (x.size () + y.size (), 0);
+	for (std::size_t i = 0; i < x.size (); ++i)
+	{
+		std::uint64_t carry = 0;
+		for (std::size_t j = 0; j < y.size (); ++j)
+		{
+			std::uint64_t sum = (std::uint64_t) x[i] * y[j] + product[i + j] + carry;
+			product[i + j] = (std::uint32_t) sum;
+			carry = sum >> 32;
+		}
+		product[i + y.size ()] = (std::uint32_t) carry;
+	}
+	BigInteger result;
+	result.importLimbs (product.data (), product.size (), sizeof(std::uint32_t), WordOrder::LeastSignificantFirst, ByteOrder::Native,
+			a.isPositive () != b.isPositive ());
+	return result;
+}
+
+/// products and squares around the thresholds of Karatsuba and Toom-3 against the schoolbook method
+void multiplicationTest ()
+{
+	typedef BigIntegerTuning<std::uint64_t> Tuning;
+	std::vector<std::size_t> sizes;
+	for (std::size_t threshold : {Tuning::karatsubaThreshold, Tuning::toom3Threshold, Tuning::karatsubaSquareThreshold, Tuning::toom3SquareThreshold})
+	{
+		sizes.push_back (threshold - 1);
+		sizes.push_back (threshold);
+		sizes.push_back (threshold + 1);
+		sizes.push_back (2 * threshold + 3);
+	}
+	for (std::size_t limbs : sizes)
+	{
+		BigInteger a = randomNumber (limbs, true);
+		BigInteger b = randomNumber (limbs);
+		check (a * b == schoolbookProduct (a, b), "balanced product against the schoolbook method");
+		check (a * a == schoolbookProduct (a, a), "a * a against the schoolbook method");
+		check (b.square () == schoolbookProduct (b, b), "square against the schoolbook method");
+	}
+	// unbalanced operands, the larger one is split into pieces of the size of the smaller one
+	const std::size_t shapes[][2] = {{Tuning::karatsubaThreshold + 1, 5}, {400, Tuning::karatsubaThreshold}, {400, Tuning::toom3Threshold + 1},
+			{3 * Tuning::toom3Threshold + 7, Tuning::toom3Threshold}, {250, 100}};
+	for (const std::size_t* shape : shapes)
+	{
+		BigInteger a = randomNumber (shape[0]);
+		BigInteger b = randomNumber (shape[1], true);
+		check (a * b == schoolbookProduct (a, b), "unbalanced product against the schoolbook method");
+		check (b * a == schoolbookProduct (a, b), "unbalanced product with the smaller operand first");
+	}
+	// all ones limbs give the largest carries in the evaluation and interpolation steps
+	BigInteger ones = (BigInteger (1) << (64 * 2 * Tuning::toom3Threshold)) - BigInteger (1);
+	check (ones * ones == schoolbookProduct (ones, ones), "square of all ones limbs");
+	check (ones * (ones >> 64) == schoolbookProduct (ones, ones >> 64), "product of all ones limbs");
+}
+
+/// the decimal digits by repeated division by 10^18, independent of the divide and conquer conversion
+std::string referenceDecimal (BigInteger x)
+{
+	const BigInteger chunk (1000000000000000000L);
+	bool isNegative = !x.isPositive ();
+	x = magnitude (x);
+	std::string result;
+	while (chunk <= x)
+	{
+		std::pair<BigInteger, BigInteger> quotientAndRemainder = x.divmod (chunk);
+		std::string digits = quotientAndRemainder.second.asString ();
+		result = std::string (18 - digits.size (), '0') + digits + result;
+		x = quotientAndRemainder.first;
+	}
+	result = x.asString () + result;
+	return isNegative ? "-" + result : result;
+}
+
+void decimalTest ()
+{
+	const std::size_t threshold = BigIntegerTuning<std::uint64_t>::decimalConversionThreshold;
+	for (std::size_t limbs : {threshold - 1, threshold, 3 * threshold + 1, 25 * threshold})
+	{
+		BigInteger x = randomNumber (limbs, limbs % 2 == 0);
+		std::string decimal = x.asString ();
+		check (decimal == referenceDecimal (x), "asString above the decimal conversion threshold");
+		check (BigInteger (decimal) == x, "setFromString above the decimal conversion threshold");
+		BigInteger power = BigInteger (10).pow ((unsigned int) (limbs * 19));
+		check (power.asString () == "1" + std::string (limbs * 19, '0'), "asString of a power of ten");
+		check ((power - BigInteger (1)).asString () == std::string (limbs * 19, '9'), "asString of all nines");
+		check (BigInteger (std::string (limbs * 19, '9')) == power - BigInteger (1), "setFromString of all nines");
+		check (BigInteger ("-000" + decimal.substr (x.isPositive () ? 0 : 1)) == BigInteger () - magnitude (x), "leading zeros of a large number");
+	}
+	check (BigInteger ("000123") == BigInteger (123), "leading zeros");
+	check ((BigInteger ("-0") == BigInteger ()) && BigInteger ("-0").isPositive () && (BigInteger ("-0").asString () == "0"), "-0 is zero");
+	check ((BigInteger ("-000") == BigInteger ()) && (BigInteger ("0000").asString () == "0"), "zeros only");
+}
+
+/// storage holding 1, 2, ..., size
+template <typename Storage>
+Storage countingStorage (std::size_t size)
+{
+	Storage storage;
+	for (std::size_t i = 1; i <= size; ++i)
+	{
+		storage.push_back ((typename Storage::value_type) i);
+	}
+	return storage;
+}
+
+template <typename Storage>
+bool isCounting (const Storage& storage, std::size_t size)
+{
+	bool result = (storage.size () == size);
+	for (std::size_t i = 0; result && (i < size); ++i)
+	{
+		result = (storage[i] == (typename Storage::value_type) (i + 1));
+	}
+	return result;
+}
+
+template <typename BaseType>
+void limbStorageTest ()
+{
+	typedef LimbStorage<BaseType> Storage;
+	const std::size_t inlineLimbs = LimbStorageTraits<BaseType>::inlineLimbs;
+	check (inlineLimbs == 32 / sizeof(BaseType), "32 bytes of inline limbs");
+	Storage small = countingStorage<Storage> (inlineLimbs);
+	check (small.isInline () && (small.capacity () == inlineLimbs) && isCounting (small, inlineLimbs), "full inline storage");
+	Storage large = countingStorage<Storage> (inlineLimbs + 1);
+	check (!large.isInline () && (large.capacity () > inlineLimbs) && isCounting (large, inlineLimbs + 1), "spill to the heap keeps the limbs");
+	Storage copy (large);
+	check (!copy.isInline () && (copy.data () != large.data ()) && isCounting (copy, inlineLimbs + 1), "copy of heap storage");
+	copy = small;
+	check (isCounting (copy, inlineLimbs), "assignment of inline storage to heap storage");
+
+	Storage movedSmall (std::move (small));
+	check (movedSmall.isInline () && isCounting (movedSmall, inlineLimbs) && small.empty (), "move of inline storage");
+	const BaseType* buffer = large.data ();
+	Storage movedLarge (std::move (large));
+	check ((movedLarge.data () == buffer) && isCounting (movedLarge, inlineLimbs + 1), "move of heap storage takes the buffer");
+	check (large.empty () && large.isInline (), "moved from heap storage is empty and inline");
+	large = std::move (movedLarge);
+	check ((large.data () == buffer) && movedLarge.empty (), "move assignment of heap storage takes the buffer");
+
+	swap (movedSmall, large);
+	check (isCounting (movedSmall, inlineLimbs + 1) && (movedSmall.data () == buffer), "swap gives the heap buffer to inline storage");
+	check (large.isInline () && isCounting (large, inlineLimbs), "swap gives the inline limbs to heap storage");
+	swap (movedSmall, large);
+	check (isCounting (large, inlineLimbs + 1) && isCounting (movedSmall, inlineLimbs), "swap back");
+
+	Storage resized (inlineLimbs - 1, 7);
+	resized.resize (inlineLimbs + 2);
+	check (!resized.isInline () && (resized[inlineLimbs - 2] == 7) && (resized[inlineLimbs - 1] == 0) && (resized.back () == 0),
+			"resize across the inline limbs fills zeros");
+	resized.pop_back ();
+	resized.assign (large.begin (), large.end ());
+	check (isCounting (resized, inlineLimbs + 1), "assign of a range");
+
+	// numbers just below and above the inline limbs
+	BigIntegerBase<BaseType> a = withLimbs<BaseType> (BigInteger (1) << (8 * 32 - 1));
+	BigIntegerBase<BaseType> b = withLimbs<BaseType> (BigInteger (-1) << (8 * 32));
+	BigIntegerBase<BaseType> aCopy (a);
+	BigIntegerBase<BaseType> bCopy (b);
+	swap (a, b);
+	check ((a == bCopy) && (b == aCopy), "swap of an inline and a spilled number");
+	BigIntegerBase<BaseType> moved (std::move (a));
+	check ((moved == bCopy) && (a == BigIntegerBase<BaseType> ()), "move of a spilled number leaves zero");
+	moved = std::move (b);
+	check (moved == aCopy, "move assignment of an inline number");
+}
+
+/**
+ * operation (result, a, b) with result as a separate number, as a, as b and as both, against reference
+ * (initial result, a, b) computed with the operators
+ */
+template <typename Operation, typename Reference>
+void checkAliasing (const Operation& operation, const Reference& reference, const BigInteger& a, const BigInteger& b, const char* what)
+{
+	BigInteger initial = randomNumber (2, true);
+	BigInteger result (initial);
+	operation (result, a, b);
+	check (result == reference (initial, a, b), what);
+	result = initial;
+	operation (result, a, a);
+	check (result == reference (initial, a, a), what);
+	BigInteger x (a);
+	operation (x, x, b);
+	check (x == reference (a, a, b), what);
+	BigInteger y (b);
+	operation (y, a, y);
+	check (y == reference (b, a, b), what);
+	BigInteger z (a);
+	operation (z, z, z);
+	check (z == reference (a, a, a), what);
+}
+
+void threeOperandTest ()
+{
+	typedef const BigInteger& Arg;
+	for (std::size_t aLimbs : {1, 3, 40, 200})
+	{
+		for (std::size_t bLimbs : {1, 2, 40, 170})
+		{
+			for (int signs = 0; signs < 4; ++signs)
+			{
+				BigInteger a = randomNumber (aLimbs, signs & 1);
+				BigInteger b = randomNumber (bLimbs, signs & 2);
+				checkAliasing ([] (BigInteger& r, Arg x, Arg y) { add (r, x, y); }, [] (Arg, Arg x, Arg y) { return x + y; }, a, b, "three operand add");
+				checkAliasing ([] (BigInteger& r, Arg x, Arg y) { sub (r, x, y); }, [] (Arg, Arg x, Arg y) { return x - y; }, a, b, "three operand sub");
+				checkAliasing ([] (BigInteger& r, Arg x, Arg y) { mul (r, x, y); }, [] (Arg, Arg x, Arg y) { return x * y; }, a, b, "three operand mul");
+				checkAliasing ([] (BigInteger& r, Arg x, Arg y) { addmul (r, x, y); }, [] (Arg r, Arg x, Arg y) { return r + x * y; }, a, b,
+						"addmul");
+				checkAliasing ([] (BigInteger& r, Arg x, Arg y) { submul (r, x, y); }, [] (Arg r, Arg x, Arg y) { return r - x * y; }, a, b,
+						"submul");
+			}
+		}
+	}
+	// x = x * y - z without temporaries, and results cancelling to zero
+	BigInteger x = randomNumber (30, true);
+	BigInteger y = randomNumber (20);
+	BigInteger z = randomNumber (50);
+	BigInteger expected = x * y - z;
+	mul (x, x, y);
+	sub (x, x, z);
+	check (x == expected, "mul (x, x, y); sub (x, x, z);");
+	submul (x, x, BigInteger (1));
+	check ((x == BigInteger ()) && x.isPositive (), "submul cancelling to zero");
+	BigInteger w = y * z;
+	submul (w, z, y);
+	check ((w == BigInteger ()) && w.isPositive (), "submul of the same product");
+}
+
+/// the parallel Toom-3, unbalanced and NTT products give the serial results
+void parallelMultiplicationTest ()
+{
+	typedef BigIntegerTuning<std::uint64_t> Tuning;
+	const std::size_t parallelThreshold = Tuning::parallelThreshold;
+	const std::size_t nttThreshold = Tuning::nttThreshold;
+	Tuning::nttThreshold = 1000;
+	const std::size_t shapes[][2] = {{400, 400}, {2000, 200}, {1300, 1100}, {5000, 1000}};
+	std::vector<BigInteger> operands;
+	std::vector<BigInteger> serial;
+	for (const std::size_t* shape : shapes)
+	{
+		BigInteger a = randomNumber (shape[0]);
+		BigInteger b = randomNumber (shape[1], true);
+		operands.push_back (a);
+		operands.push_back (b);
+		serial.push_back (a * b);
+		serial.push_back (b.square ());
+	}
+	check (serial[0] == schoolbookProduct (operands[0], operands[1]), "serial Toom-3 product");
+	ThreadPool pool (4);
+	Tuning::threadPool = &pool;
+	Tuning::parallelThreshold = Tuning::toom3Threshold;
+	for (std::size_t i = 0; i < operands.size (); i += 2)
+	{
+		check (operands[i] * operands[i + 1] == serial[i], "parallel product");
+		check (operands[i + 1].square () == serial[i + 1], "parallel square");
+	}
+	Tuning::threadPool = nullptr;
+	Tuning::parallelThreshold = parallelThreshold;
+	Tuning::nttThreshold = nttThreshold;
+}
+
+#if defined(UTILITIES_VECTOR_LIMBS)
+/// the AVX2 and AVX-512 kernels of every level the CPU has against the scalar code
+void vectorLimbsTest ()
+{
+	typedef LimbArithmetic<std::uint64_t> Limbs;
+	typedef LimbVectorArithmetic Vectors;
+	const Vectors::Level level = Vectors::level ();
+	const std::uint64_t ones = ~(std::uint64_t) 0;
+	const std::size_t minimum = Vectors::minimumSize;
+	for (std::size_t n : {minimum - 1, minimum, minimum + 1, minimum + 3, 2 * minimum, 2 * minimum + 5, 8 * minimum + 1})
+	{
+		// random limbs, a carry rippling through all limbs and a borrow rippling through all limbs
+		std::vector<std::vector<std::uint64_t> > as (3, std::vector<std::uint64_t> (n));
+		std::vector<std::vector<std::uint64_t> > bs (3, std::vector<std::uint64_t> (n));
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			as[0][i] = generator ();
+			bs[0][i] = generator ();
+			as[1][i] = ones;
+			bs[1][i] = (i == 0) ? 1 : 0;
+			as[2][i] = 0;
+			bs[2][i] = (i == 0) ? 1 : 0;
+		}
+		// equal except for the lowest limb, compare has to look at every block
+		as.push_back (as[0]);
+		bs.push_back (as[0]);
+		bs.back ()[0] ^= 1;
+		for (std::size_t k = 0; k < as.size (); ++k)
+		{
+			const std::uint64_t* a = as[k].data ();
+			const std::uint64_t* b = bs[k].data ();
+			std::vector<std::uint64_t> expectedSum (n);
+			std::vector<std::uint64_t> expectedDifference (n);
+			Vectors::level () = Vectors::Scalar;
+			std::uint64_t expectedCarry = Limbs::addN (expectedSum.data (), a, b, n);
+			std::uint64_t expectedBorrow = Limbs::subN (expectedDifference.data (), a, b, n);
+			int expectedComparison = Limbs::compareN (a, b, n);
+			for (int current = level; current > Vectors::Scalar; --current)
+			{
+				Vectors::level () = (Vectors::Level) current;
+				std::vector<std::uint64_t> result (n);
+				check ((Limbs::addN (result.data (), a, b, n) == expectedCarry) && (result == expectedSum), "vector addN");
+				check ((Limbs::subN (result.data (), a, b, n) == expectedBorrow) && (result == expectedDifference), "vector subN");
+				result = as[k];
+				check ((Limbs::addN (result.data (), result.data (), b, n) == expectedCarry) && (result == expectedSum), "vector addN in place");
+				check (Limbs::compareN (a, b, n) == expectedComparison, "vector compareN");
+				check (Limbs::compareN (b, a, n) == -expectedComparison, "vector compareN swapped");
+				check (Limbs::compareN (a, a, n) == 0, "vector compareN of equal limbs");
+			}
+		}
+		// the top non zero limb in every position, also beyond whole blocks of zeros
+		for (std::size_t top = 0; top <= n; ++top)
+		{
+			std::vector<std::uint64_t> limbs (n, 0);
+			if (top > 0)
+			{
+				limbs[top - 1] = 1;
+				limbs[0] = ones;
+			}
+			for (int current = level; current > Vectors::Scalar; --current)
+			{
+				Vectors::level () = (Vectors::Level) current;
+				check (Limbs::normalizedSize (limbs.data (), n) == top, "vector normalizedSize");
+			}
+		}
+	}
+	Vectors::level () = level;
+}
+#endif
+
+void bitsTest ()
+{
+	const std::vector<long> values = {0, 1, -1, 2, -2, 5, -5, 6, -6, 255, -256, 12345, -12345, 1L << 40, -(1L << 40) - 12345, INT64_MAX, INT64_MIN};
+	for (long a : values)
+	{
+		const BigInteger x (a);
+		check (~x == BigInteger (~a), "~ against long");
+		for (long b : values)
+		{
+			const BigInteger y (b);
+			check ((x & y) == BigInteger (a & b), "& against long");
+			check ((x | y) == BigInteger (a | b), "| against long");
+			check ((x ^ y) == BigInteger (a ^ b), "^ against long");
+		}
+		for (unsigned int shift : {0, 1, 2, 7, 40, 63})
+		{
+			check ((x >> shift) == BigInteger (a >> shift), ">> rounds towards minus infinity like long");
+			BigInteger truncated (x);
+			truncated.shiftRight (shift);
+			check (truncated == x / (BigInteger (1) << shift), "shiftRight rounds towards zero");
+		}
+		check (x.popCount () == (unsigned int) __builtin_popcountll (a < 0 ? 0ULL - (unsigned long long) a : (unsigned long long) a),
+				"popCount of the magnitude");
+		if (a != 0)
+		{
+			check (x.countTrailingZeros () == (unsigned int) __builtin_ctzll ((unsigned long long) a), "countTrailingZeros against long");
+		}
+		for (unsigned int start : {0, 1, 3, 17, 40})
+		{
+			for (unsigned int count : {1, 5, 20})
+			{
+				check (x.extractBits (start, count) == BigInteger ((long) (((unsigned long long) a >> start) & ((1ULL << count) - 1))),
+						"extractBits of the two's complement against long");
+			}
+		}
+	}
+	check (throws<std::domain_error> ([] { BigInteger ().countTrailingZeros (); }), "countTrailingZeros of 0");
+	check ((BigInteger (-5) >> 1) == BigInteger (-3), "-5 >> 1");
+
+	// multi limb patterns across the limb boundaries
+	const BigInteger one (1);
+	const BigInteger ones = (one << 200) - one;
+	const BigInteger power = one << 128;
+	check (ones.popCount () == 200, "popCount of 200 ones");
+	check ((ones & -ones) == one, "lowest set bit of all ones");
+	check ((power & -power) == power, "lowest set bit of a power of two");
+	check (((-power).countTrailingZeros () == 128) && (power.countTrailingZeros () == 128), "countTrailingZeros of +-2^128");
+	check ((-power).extractBits (120, 16) == BigInteger (0xFF00), "extractBits of a negative number across a limb boundary");
+	check (ones.extractBits (60, 10) == BigInteger (1023) && power.extractBits (127, 3) == BigInteger (2), "extractBits across a limb boundary");
+	check ((-power).extractBits (300, 64) == (one << 64) - one, "extractBits above a negative number gives the sign extension");
+	check (((-power) >> 130) == BigInteger (-1), "-2^128 >> 130");
+	BigInteger truncated = -power;
+	truncated.shiftRight (130);
+	check (truncated == BigInteger (), "-2^128 shiftRight 130");
+	check (((-power - one) >> 128) == BigInteger (-2), "-(2^128 + 1) >> 128");
+	truncated = -power - one;
+	truncated.shiftRight (128);
+	check (truncated == BigInteger (-1), "-(2^128 + 1) shiftRight 128");
+	check (~((one << 64) - one) == -(one << 64), "~ of a full limb");
+	check ((BigInteger (-1) & ones) == ones, "-1 is all ones");
+	check (((-power) | ones) == BigInteger (-1) && ((-power) ^ ones) == -(one << 200) + power - one,
+			"| and ^ with the sign extension of the shorter operand");
+	for (int signs = 0; signs < 4; ++signs)
+	{
+		const BigInteger a = randomNumber (3, signs & 1);
+		const BigInteger b = randomNumber (5, signs & 2);
+		check ((a ^ b) == (a | b) - (a & b), "^ is | minus &");
+		check ((a & ~a) == BigInteger () && (a | ~a) == BigInteger (-1), "a & ~a and a | ~a");
+		check (~(a & b) == (~a | ~b) && ~(a | b) == (~a & ~b), "De Morgan");
+		check ((a >> 70) == (a - (a & ((one << 70) - one))) / (one << 70), ">> of a random number");
+		check (a.extractBits (61, 70) == ((a >> 61) & ((one << 70) - one)), "extractBits of a random number");
+	}
+}
+
+typedef FixedBigInteger<128> Fixed128;
+typedef FixedBigInteger<128, true> Signed128;
+
+// everything but the string output works in constant expressions
+static_assert(Fixed128 (-1) + Fixed128 (1) == Fixed128 (), "constexpr addition wraps around");
+static_assert(Fixed128 () - Fixed128 (1) == Fixed128 (-1), "constexpr subtraction wraps around");
+static_assert(FixedBigInteger<256> (99999999999999999999_fixed) * 99999999999999999999_fixed
+		== 9999999999999999999800000000000000000001_fixed, "constexpr multiplication");
+static_assert(9999999999999999999800000000000000000001_fixed / 99999999999999999999_fixed == 99999999999999999999_fixed,
+		"constexpr division by two limbs");
+static_assert((9999999999999999999800000000000000000001_fixed + 5_fixed) % 99999999999999999999_fixed == 5_fixed,
+		"constexpr remainder of two limbs");
+static_assert(((Fixed128 (1) << 127) >> 127) == Fixed128 (1) && (Fixed128 (3) << 64).getLimb (1) == 3, "constexpr shifts");
+static_assert((Signed128 (-8) >> 1) == Signed128 (-4) && (Signed128 (-1) >> 127) == Signed128 (-1), "constexpr arithmetic shift");
+static_assert(Signed128 (-1) < Signed128 (1) && Fixed128 (-1) > Fixed128 (1), "constexpr comparison");
+static_assert(1_fixed + 99999999999999999999_fixed == 100000000000000000000_fixed, "constexpr mixed widths");
+
+void fixedTest ()
+{
+	// the operands are converted to the wider type like the built in integers
+	check ((std::is_same<decltype(1_fixed + 99999999999999999999_fixed), Fixed128>::value), "mixed widths give the wider type");
+	check ((std::is_same<decltype(Signed128 () * Fixed128 ()), Fixed128>::value), "equal widths give unsigned");
+	check ((std::is_same<decltype(Signed128 () - FixedBigInteger<64> ()), Signed128>::value), "the wider signed type wins");
+	check (Signed128 (-1) < FixedBigInteger<256, true> (), "negative numbers are sign extended");
+	check (!(Signed128 (-1) < Fixed128 (1)), "-1 compares like -1 < 1u");
+	check (BigInteger (1_fixed + 99999999999999999999_fixed) == 100000000000000000000_bigInt, "sum of two widths");
+
+	// signed numbers wrap around in two's complement
+	Signed128 maximum = (Signed128 (1) << 127) - Signed128 (1);
+	Signed128 minimum = maximum + Signed128 (1);
+	check (minimum.isNegative () && (BigInteger (minimum) == -(BigInteger (1) << 127)), "maximum + 1 wraps to the minimum");
+	check (minimum - Signed128 (1) == maximum, "minimum - 1 wraps to the maximum");
+	check (-minimum == minimum, "the minimum is its own negation");
+	check (minimum / Signed128 (-1) == minimum, "minimum / -1 wraps");
+	check (maximum * maximum == Signed128 (1), "the square of the maximum wraps to 1");
+	check ((Signed128 (-7) / Signed128 (2) == Signed128 (-3)) && (Signed128 (-7) % Signed128 (2) == Signed128 (-1)),
+			"signed division rounds towards zero");
+	check (throws<std::domain_error> ([] { return Fixed128 (1) / Fixed128 (); }), "division by zero throws");
+
+	// multi limb divisors of every size against BigInteger
+	typedef FixedBigInteger<512, true> Signed512;
+	bool dividesLikeBigInteger = true;
+	for (size_t divisorLimbs = 1; divisorLimbs <= 7; ++divisorLimbs)
+	{
+		for (int round = 0; round < 20; ++round)
+		{
+			BigInteger dividend = randomNumber (7, round % 2 == 1);
+			BigInteger divisor = randomNumber (divisorLimbs, round % 4 >= 2);
+			if (round % 5 == 0)
+			{
+				// a divisor with a top limb of all ones needs the corrections of the quotient estimate
+				divisor |= (BigInteger (1) << (64 * divisorLimbs)) - (BigInteger (1) << (64 * divisorLimbs - 64));
+			}
+			Signed512 fixedDividend (dividend);
+			Signed512 fixedDivisor (divisor);
+			dividesLikeBigInteger &= (BigInteger (fixedDividend / fixedDivisor) == dividend / divisor)
+					&& (BigInteger (fixedDividend % fixedDivisor) == dividend % divisor);
+		}
+	}
+	check (dividesLikeBigInteger, "FixedBigInteger division like BigInteger");
+	check (to_string (-Signed512 (12345)) == "-12345", "to_string of a negative number");
+}
+
+/// the digits of x in base by repeated division, independent of toChars
+std::string referenceDigits (const BigInteger& x, int base)
+{
+	const char* alphabet = "0123456789abcdefghijklmnopqrstuvwxyz";
+	BigInteger rest = magnitude (x);
+	std::string digits;
+	do
+	{
+		std::pair<BigInteger, BigInteger> division = rest.divmod (BigInteger (base));
+		std::uint64_t digit = 0;
+		division.second.exportLimbs (&digit, sizeof(digit));
+		digits += alphabet[digit];
+		rest = division.first;
+	}
+	while (!(rest == BigInteger ()));
+	return (x.isPositive () ? "" : "-") + std::string (digits.rbegin (), digits.rend ());
+}
+
+template <typename Value>
+std::string streamed (std::ios_base::fmtflags flags, std::streamsize width, char fill, const Value& value)
+{
+	std::ostringstream stream;
+	stream.flags (flags);
+	stream << std::setw ((int) width) << std::setfill (fill) << value;
+	return stream.str () + ((stream.width () == 0) ? "" : " width not reset");
+}
+
+void charsTest ()
+{
+	char buffer[64];
+	BigInteger number (12345);
+	ToCharsResult written = number.toChars (buffer, buffer + 4);
+	check ((written.ec == std::errc::value_too_large) && (written.ptr == buffer + 4), "toChars into a short buffer");
+	written = number.toChars (buffer, buffer + 5);
+	check ((written.ec == std::errc ()) && (std::string (buffer, written.ptr) == "12345"), "toChars into an exact buffer");
+	check (BigInteger ().toChars (buffer, buffer).ec == std::errc::value_too_large, "zero into an empty buffer");
+	check (BigInteger (-1).toChars (buffer, buffer + 1).ec == std::errc::value_too_large, "the sign does not fit");
+	check (BigInteger (256).toChars (buffer, buffer + 8, 2).ec == std::errc::value_too_large, "binary digits do not fit");
+	for (int base : {1, 37, 0, -2})
+	{
+		written = number.toChars (buffer, buffer + sizeof(buffer), base);
+		check ((written.ec == std::errc::invalid_argument) && (written.ptr == buffer), "toChars rejects the base");
+		BigInteger unchanged (7);
+		const char* digits = "101";
+		FromCharsResult read = unchanged.fromChars (digits, digits + 3, base);
+		check ((read.ec == std::errc::invalid_argument) && (read.ptr == digits) && (unchanged == BigInteger (7)), "fromChars rejects the base");
+		check (throws<std::invalid_argument> ([&number, base] { return number.asString (base); }), "asString rejects the base");
+	}
+	for (const char* text : {"", "-", "xyz", "-z", " 1", "+1"})
+	{
+		BigInteger unchanged (7);
+		FromCharsResult read = unchanged.fromChars (text, text + std::strlen (text));
+		check ((read.ec == std::errc::invalid_argument) && (read.ptr == text) && (unchanged == BigInteger (7)), "fromChars needs digits");
+	}
+	const char* partial = "-1Az";
+	FromCharsResult read = number.fromChars (partial, partial + 4, 16);
+	check ((read.ec == std::errc ()) && (read.ptr == partial + 3) && (number == BigInteger (-26)), "fromChars stops at the first non digit");
+
+	// round trips of large numbers, which do not fit into short buffers
+	for (int base : {2, 8, 10, 16, 36})
+	{
+		for (std::size_t limbs : {(std::size_t) 1, (std::size_t) 3, (std::size_t) 17})
+		{
+			BigInteger x = randomNumber (limbs, limbs % 2 == 1);
+			std::string digits = x.asString (base);
+			check (digits == referenceDigits (x, base), "asString like repeated division");
+			BigInteger y;
+			read = y.fromChars (digits.data (), digits.data () + digits.size (), base);
+			check ((read.ec == std::errc ()) && (read.ptr == digits.data () + digits.size ()) && (y == x), "toChars and fromChars round trip");
+			std::string upper = digits;
+			std::transform (upper.begin (), upper.end (), upper.begin (), [] (char c) { return (char) std::toupper (c); });
+			check ((y.fromChars (upper.data (), upper.data () + upper.size (), base).ec == std::errc ()) && (y == x), "fromChars reads upper case");
+			std::vector<char> exact (digits.size ());
+			written = x.toChars (exact.data (), exact.data () + exact.size (), base);
+			check ((written.ec == std::errc ()) && (written.ptr == exact.data () + exact.size ()), "toChars fills an exact buffer");
+			written = x.toChars (exact.data (), exact.data () + exact.size () - 1, base);
+			check ((written.ec == std::errc::value_too_large) && (written.ptr == exact.data () + exact.size () - 1), "toChars one short");
+		}
+	}
+
+	// the stream flags like for long
+	typedef std::ios_base ios;
+	for (long value : {255L, -255L, 0L, 123456789L})
+	{
+		BigInteger x (value);
+		for (ios::fmtflags flags : {ios::dec, ios::hex, ios::oct, ios::hex | ios::uppercase, ios::dec | ios::showpos, ios::hex | ios::showbase,
+				ios::oct | ios::showbase, ios::hex | ios::showbase | ios::uppercase, ios::dec | ios::left, ios::dec | ios::internal | ios::showpos})
+		{
+			if ((value <= 0) && ((flags & (ios::hex | ios::oct)) != 0))
+			{
+				// long prints negative numbers in two's complement, and 0 without the base
+				continue;
+			}
+			for (std::streamsize width : {0, 3, 14})
+			{
+				check (streamed (flags, width, '*', x) == streamed (flags, width, '*', value), "operator<< with the flags of long");
+			}
+		}
+	}
+	check (streamed (ios::hex | ios::showbase, 0, ' ', BigInteger (-255)) == "-0xff", "negative hexadecimal number");
+	check (streamed (ios::hex | ios::showbase | ios::internal, 8, ' ', BigInteger (-255)) == "-0x   ff", "internal padding after the base");
+	BigInteger large = randomNumber (40);
+	std::string largeDigits = large.asString ();
+	check (streamed (ios::dec | ios::right, (std::streamsize) largeDigits.size () + 3, '_', large) == "___" + largeDigits, "padding of a long number");
+
+	// operator>> in the base of the stream
+	std::istringstream input ("  -123 +456 ff 12x - abc");
+	BigInteger a, b, c, d;
+	input >> a >> b >> std::hex >> c >> std::dec >> d;
+	check ((a == BigInteger (-123)) && (b == BigInteger (456)) && (c == BigInteger (255)) && (d == BigInteger (12)), "operator>> reads numbers");
+	check (input && (input.peek () == 'x'), "operator>> stops at the first non digit");
+	input.get ();
+	BigInteger unchanged (7);
+	check (!(input >> unchanged) && (unchanged == BigInteger (7)), "operator>> fails for a sign without digits");
+	input.clear ();
+	check (!(input >> unchanged) && (unchanged == BigInteger (7)), "operator>> fails without digits");
+	std::istringstream longInput (" " + largeDigits + " ");
+	BigInteger readLarge;
+	check ((longInput >> readLarge) && (readLarge == large), "operator>> of a number longer than its buffer");
+	std::istringstream octal ("-777");
+	check ((octal >> std::oct >> readLarge) && (readLarge == BigInteger (-511)), "operator>> in octal");
+}
+
+#if defined(UTILITIES_INSTRUMENTATION)
+void instrumentationTest ()
+{
+	typedef BigIntegerInstrumentation Instrumentation;
+	typedef BigIntegerTuning<std::uint64_t> Tuning;
+	const BigInteger a = randomNumber (2 * Tuning::karatsubaThreshold);
+	const BigInteger b = randomNumber (2 * Tuning::karatsubaThreshold);
+	Instrumentation::reset ();
+	BigInteger product = a * b;
+	Instrumentation::Statistics statistics = Instrumentation::snapshot ();
+	const Instrumentation::OperationStatistics& mul = statistics.operations[Instrumentation::Mul];
+	check ((mul.calls == 1) && (mul.limbs == 4 * Tuning::karatsubaThreshold) && (mul.cycles > 0), "one Karatsuba multiplication");
+	check ((statistics.tiers[Instrumentation::MulKaratsuba] == 1) && (statistics.tiers[Instrumentation::MulBasecase] == 0), "the Karatsuba tier");
+	check ((statistics.heapAllocations > 0) && (statistics.arenaAllocations == 0) && (statistics.allocatedBytes >= 8 * mul.limbs)
+			&& (statistics.numbersCreated == 1), "the allocations of the product");
+	LimbArena arena;
+	{
+		ScopedLimbArena scope (arena);
+		Instrumentation::reset ();
+		BigInteger arenaProduct = a * b;
+		statistics = Instrumentation::snapshot ();
+	}
+	check ((statistics.arenaAllocations > 0) && (statistics.heapAllocations == 0), "the product allocates from the arena");
+
+	// the additions and products inside Toom-3 belong to the outermost multiplication, the tiers count all of them
+	const BigInteger c = randomNumber (Tuning::toom3Threshold + 10);
+	const BigInteger d = randomNumber (Tuning::toom3Threshold + 10);
+	Instrumentation::reset ();
+	product = c * d;
+	statistics = Instrumentation::snapshot ();
+	check ((statistics.operations[Instrumentation::Mul].calls == 1) && (statistics.operations[Instrumentation::Add].calls == 0)
+			&& (statistics.operations[Instrumentation::Sub].calls == 0), "only the outermost Toom-3 multiplication counts");
+	check ((statistics.tiers[Instrumentation::MulToom3] == 1) && (statistics.tiers[Instrumentation::MulKaratsuba] == 5), "the Toom-3 tiers");
+
+	// also when the pieces and the products of Toom-3 run as tasks on the threads of a pool
+	ThreadPool pool (4);
+	const std::size_t parallelThreshold = Tuning::parallelThreshold;
+	Tuning::threadPool = &pool;
+	Tuning::parallelThreshold = Tuning::toom3Threshold;
+	const BigInteger e = randomNumber (8 * Tuning::toom3Threshold);
+	Instrumentation::reset ();
+	product = e * d;
+	product = e.square ();
+	statistics = Instrumentation::snapshot ();
+	Tuning::threadPool = nullptr;
+	Tuning::parallelThreshold = parallelThreshold;
+	check ((statistics.operations[Instrumentation::Mul].calls == 2) && (statistics.operations[Instrumentation::Add].calls == 0)
+			&& (statistics.operations[Instrumentation::Sub].calls == 0), "only the outermost parallel multiplications count");
+
+	// a Newton division multiplies internally
+	const BigInteger dividend = randomNumber (2 * Tuning::newtonDivisionThreshold + 1);
+	const BigInteger divisor = randomNumber (Tuning::newtonDivisionThreshold);
+	Instrumentation::reset ();
+	BigInteger quotient = dividend / divisor;
+	statistics = Instrumentation::snapshot ();
+	check ((statistics.operations[Instrumentation::Div].calls == 1) && (statistics.operations[Instrumentation::Mul].calls == 0)
+			&& (statistics.tiers[Instrumentation::DivNewton] > 0), "only the outermost division counts");
+}
+#endif
+
 int main (int argc, char** argv)
 {
 	testFiboHeap ();
+	nttTest ();
+	divisionTest ();
+	modularTest ();
+	arenaTest ();
+	threadPoolTest ();
+	parallelMultiplicationTest ();
+	limbsTest ();
+	arrayTest ();
+	gcdTest ();
+	rootsTest ();
+	literalTest ();
+	bitsTest ();
+	fixedTest ();
+	charsTest ();
+#if defined(UTILITIES_INSTRUMENTATION)
+	instrumentationTest ();
+#endif
+	batchTest ();
+#if defined(UTILITIES_VECTOR_LIMBS)
+	vectorLimbsTest ();
+#endif
+	combinatoricsTest ();
+	primesTest ();
+	sharedTest ();
+	rnsTest ();
+	hybridTest ();
+	multiplicationTest ();
+	decimalTest ();
+	limbStorageTest<std::uint64_t> ();
+	limbStorageTest<std::uint8_t> ();
+	threeOperandTest ();
+	limbTypeTest<std::uint8_t> ("8 bit");
+	limbTypeTest<std::uint16_t> ("16 bit");
+	limbTypeTest<std::uint32_t> ("32 bit");
+	std::cout << (failures == 0 ? "all checks passed" : "checks failed: ") << (failures == 0 ? "" : std::to_string (failures)) << std::endl;
+	return (failures == 0) ? 0 : 1;
 }